@@ -11,15 +11,36 @@
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include <atomic>
 #include <limits>
+#include <optional>
 
 namespace mlir {
 
 namespace triton {
 class AllocationAnalysis;
 
+/// How the rows of the scratch buffer of a layout conversion are laid out
+/// along its fastest dimension: each row is followed by `pad` elements, and
+/// chunk `c` of `vec` elements of row `r` is stored at chunk
+/// `c ^ ((r / perPhase) % maxPhase)` of the row.
+struct CvtScratchLayout {
+  unsigned pad = 0;
+  unsigned vec = 1;
+  unsigned perPhase = 1;
+  unsigned maxPhase = 1;
+
+  bool isSwizzled() const { return maxPhase > 1; }
+  /// The offset in elements of `idx` in a buffer of shape `paddedRepShape`
+  unsigned getOffset(ArrayRef<unsigned> idx, ArrayRef<unsigned> paddedRepShape,
+                     ArrayRef<unsigned> order) const;
+};
+
 SmallVector<unsigned>
 getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
-                             unsigned &outVec);
+                             unsigned &outVec, CvtScratchLayout &scratchLayout);
+
+/// Returns the size, in bytes, of the scratch buffer `op` needs when it is
+/// lowered, or std::nullopt if it does not need one. Calls are not included.
+std::optional<unsigned> getScratchSizeInBytes(Operation *op);
 
 } // namespace triton
 
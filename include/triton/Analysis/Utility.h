@@ -99,6 +99,8 @@ public:
 
   Location getLoc() { return scanOp.getLoc(); }
   unsigned getAxis() { return scanOp.getAxis(); }
+  bool getReverse() { return scanOp.getReverse(); }
+  bool getExclusive() { return scanOp.getExclusive(); }
   triton::gpu::BlockedEncodingAttr getEncoding();
   Region &getCombineOp();
 
@@ -119,6 +121,37 @@ bool isSingleValue(Value value);
 
 bool isMmaToDotShortcut(RankedTensorType &srcTy, RankedTensorType &dstTy);
 
+/// Where a register of the destination of a layout conversion comes from:
+/// register srcRegs[lane] of lane
+///   laneXor ^ (laneBits[0] if bit 0 of lane is set) ^ (laneBits[1] ...) ...
+/// of the same warp. srcRegs[lane] only depends on the bits of lane that are
+/// set in regLaneMask.
+struct WarpShuffle {
+  SmallVector<unsigned> srcRegs;
+  unsigned regLaneMask;
+  unsigned laneXor;
+  SmallVector<unsigned> laneBits;
+
+  /// Whether every lane reads from itself
+  bool readsOwnLane() const;
+};
+
+/// The shuffles, one per register of the destination, that implement a
+/// conversion between two distributed layouts in which no element crosses a
+/// warp, or std::nullopt if the conversion has to go through shared memory.
+std::optional<SmallVector<WarpShuffle>>
+getWarpShufflesForCvt(RankedTensorType srcTy, RankedTensorType dstTy);
+
+/// The shared memory wavefronts a warp takes to store or load the elements of
+/// the first CTA tile of `type` it holds, `vec` contiguous elements of
+/// `elemBytes` bytes at a time, when the element at index `idx` lives at
+/// element `getOffset(idx)` of the buffer. std::nullopt if the layout of
+/// `type` is not supported.
+std::optional<unsigned>
+getSharedAccessWavefronts(RankedTensorType type, unsigned vec,
+                          unsigned elemBytes,
+                          function_ref<unsigned(ArrayRef<unsigned>)> getOffset);
+
 Type getElementType(Value value);
 
 template <typename T_OUT, typename T_IN>
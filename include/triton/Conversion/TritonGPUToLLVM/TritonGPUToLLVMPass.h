@@ -14,7 +14,7 @@ namespace triton {
 
 std::unique_ptr<OperationPass<ModuleOp>>
 createConvertTritonGPUToLLVMPass(int computeCapability = 80,
-                                 bool isROCM = false);
+                                 bool isROCM = false, bool nativeFp8 = false);
 
 } // namespace triton
 
@@ -4,13 +4,34 @@
 #include "mlir/Pass/Pass.h"
 
 namespace mlir {
-std::unique_ptr<Pass> createTritonGPUPipelinePass(int numStages = 2);
+std::unique_ptr<Pass>
+createTritonGPUPipelinePass(int numStages = 2, bool autoNumStages = false,
+                            int computeCapability = 80,
+                            bool pipelineOtherLoads = false);
 
 std::unique_ptr<Pass>
 createTritonGPUAccelerateMatmulPass(int computeCapability = 80);
 
 std::unique_ptr<Pass> createTritonGPUPrefetchPass();
 
+std::unique_ptr<Pass>
+createTritonGPUPersistentKernelPass(bool atomicScheduler = false,
+                                    int numPrograms = 0);
+
+std::unique_ptr<Pass> createTritonGPUSplitKPass(int splitK = 2);
+
+std::unique_ptr<Pass> createTritonGPURasterizePass();
+
+std::unique_ptr<Pass>
+createTritonGPULoopInvariantCodeMotionPass(int maxHoistedRegisters = 32);
+
+std::unique_ptr<Pass> createTritonGPULoopVersioningPass(int alignment = 16);
+
+std::unique_ptr<Pass> createTritonGPUMultiVersionPass(int alignment = 16,
+                                                      int maxArgs = 4);
+
+std::unique_ptr<Pass> createTritonGPUCombineReductionsPass();
+
 std::unique_ptr<Pass> createTritonGPUCanonicalizeLoopsPass();
 
 std::unique_ptr<Pass> createTritonGPUCoalescePass();
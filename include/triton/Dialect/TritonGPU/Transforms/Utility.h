@@ -16,16 +16,71 @@ LogicalResult fixupLoops(ModuleOp mod);
 LogicalResult invertEncoding(Attribute targetEncoding, Operation *op,
                              Attribute &ret);
 
+// Forward counterpart of invertEncoding: the encoding of the results of `op`
+// when its operands have `srcEncoding`.
+LogicalResult inferDstEncoding(Attribute srcEncoding, Operation *op,
+                               Attribute &ret);
+
 bool isExpensiveLoadOrStore(Operation *op, Attribute &targetEncoding);
 
 bool isExpensiveToRemat(Operation *op, Attribute &targetEncoding);
 
+// Memoizes the queries made by simulateBackwardRematerialization, which the
+// rematerialization patterns otherwise redo from scratch every time they are
+// tried on the same (op, encoding) pairs. Entries are only valid for the IR
+// they were computed on: the cache is meant to be registered as the listener
+// of the rewriter applying the patterns, and is cleared on any IR change it
+// reports. Changes made behind the rewriter's back (Operation::moveBefore,
+// setOperand, ...) are not reported: code making them must call clear().
+class RematerializationCache : public RewriterBase::Listener {
+public:
+  struct Simulation {
+    int numCvts;
+    SetVector<Operation *> processed;
+    SetVector<Attribute> layout;
+    llvm::MapVector<Value, Attribute> toConvert;
+  };
+
+  bool isExpensiveToRemat(Operation *op, Attribute targetEncoding);
+
+  LogicalResult invertEncoding(Attribute targetEncoding, Operation *op,
+                               Attribute &ret);
+
+  // Returns the memoized simulation rooted at `initOp`, or nullptr.
+  const Simulation *lookupSimulation(Operation *initOp,
+                                     Attribute targetEncoding);
+
+  void insertSimulation(Operation *initOp, Attribute targetEncoding,
+                        Simulation simulation);
+
+  void clear();
+
+  unsigned getNumHits() const { return numHits; }
+  unsigned getNumMisses() const { return numMisses; }
+
+  void notifyOperationInserted(Operation *op) override { clear(); }
+  void notifyOperationReplaced(Operation *op, ValueRange) override { clear(); }
+  void notifyOperationRemoved(Operation *op) override { clear(); }
+  void notifyOperationModified(Operation *op) override { clear(); }
+
+private:
+  using Key = std::pair<Operation *, Attribute>;
+  DenseMap<Key, bool> expensiveToRemat;
+  // A null attribute records an encoding that can't be inverted.
+  DenseMap<Key, Attribute> invertedEncodings;
+  DenseMap<Key, Simulation> simulations;
+  unsigned numHits = 0;
+  unsigned numMisses = 0;
+};
+
 // skipInit is True when we only consider the operands of the initOp but
 // not the initOp itself.
+// When a `cache` is given, queries are memoized in it, and so is the whole
+// simulation if it starts from empty `processed`, `layout` and `toConvert`.
 int simulateBackwardRematerialization(
     Operation *initOp, SetVector<Operation *> &processed,
     SetVector<Attribute> &layout, llvm::MapVector<Value, Attribute> &toConvert,
-    Attribute targetEncoding);
+    Attribute targetEncoding, RematerializationCache *cache = nullptr);
 
 Operation *cloneWithInferType(mlir::OpBuilder &rewriter, Operation *op,
                               IRMapping &mapping);
@@ -35,8 +90,13 @@ void rematerializeConversionChain(
     mlir::PatternRewriter &rewriter, SetVector<Operation *> &processed,
     IRMapping &mapping);
 
+// Maximum amount of shared memory, in bytes, a single CTA can use on a device
+// of the given compute capability.
+int getSharedMemoryCapacity(int computeCapability);
+
 LogicalResult canMoveOutOfLoop(BlockArgument arg,
-                               SmallVector<Operation *> &cvts);
+                               SmallVector<Operation *> &cvts,
+                               RematerializationCache *cache = nullptr);
 
 } // namespace mlir
 
@@ -49,9 +49,82 @@ getCvtOrder(Attribute srcLayout, Attribute dstLayout) {
   return {inOrd, outOrd};
 }
 
+static bool isMmaV1(Attribute layout) {
+  if (auto sliceLayout = layout.dyn_cast<SliceEncodingAttr>())
+    return isMmaV1(sliceLayout.getParent());
+  auto mmaLayout = layout.dyn_cast<MmaEncodingAttr>();
+  return mmaLayout && mmaLayout.isVolta();
+}
+
+unsigned CvtScratchLayout::getOffset(ArrayRef<unsigned> idx,
+                                     ArrayRef<unsigned> paddedRepShape,
+                                     ArrayRef<unsigned> order) const {
+  unsigned row = 0;
+  for (unsigned d : llvm::reverse(order.drop_front()))
+    row = row * paddedRepShape[d] + idx[d];
+  unsigned col = idx[order[0]];
+  unsigned chunk = (col / vec) ^ ((row / perPhase) % maxPhase);
+  return row * paddedRepShape[order[0]] + chunk * vec + col % vec;
+}
+
+/// The swizzled layout of the scratch buffer of `op`, or std::nullopt if it
+/// cannot be swizzled or if padding it causes fewer bank conflicts
+static std::optional<CvtScratchLayout>
+getSwizzledScratchLayout(triton::gpu::ConvertLayoutOp op,
+                         ArrayRef<unsigned> repShape, unsigned rowDim,
+                         unsigned inVec, unsigned outVec) {
+  auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+  auto dstTy = op.getResult().getType().cast<RankedTensorType>();
+  if (isMmaV1(srcTy.getEncoding()) || isMmaV1(dstTy.getEncoding()))
+    return std::nullopt;
+  // The lowering linearizes the buffer along the order of the destination
+  auto order = getOrder(dstTy.getEncoding());
+  unsigned vec = std::max(inVec, outVec);
+  unsigned rowLen = repShape[rowDim];
+  if (order[0] != rowDim || !llvm::isPowerOf2_32(rowLen) || rowLen <= vec)
+    return std::nullopt;
+  unsigned elemBytes =
+      srcTy.getElementType().isa<triton::PointerType>()
+          ? kPtrBitWidth / 8
+          : std::max<int>(8, srcTy.getElementTypeBitWidth()) / 8;
+
+  // Rows that share the 128 bytes of the banks are in the same phase
+  CvtScratchLayout swizzled;
+  swizzled.vec = vec;
+  swizzled.perPhase = std::max<unsigned>(128 / (rowLen * elemBytes), 1);
+  swizzled.maxPhase = std::min<unsigned>(
+      rowLen / vec,
+      std::max<unsigned>(128 / (vec * elemBytes) / swizzled.perPhase, 1));
+  if (!swizzled.isSwizzled())
+    return std::nullopt;
+  CvtScratchLayout padded;
+  padded.pad = vec;
+  SmallVector<unsigned> paddedShape(repShape);
+  paddedShape[rowDim] += vec;
+
+  auto getWavefronts =
+      [&](const CvtScratchLayout &layout,
+          ArrayRef<unsigned> shape) -> std::optional<unsigned> {
+    auto getOffset = [&](ArrayRef<unsigned> idx) {
+      return layout.getOffset(idx, shape, order);
+    };
+    auto stores = getSharedAccessWavefronts(srcTy, inVec, elemBytes, getOffset);
+    auto loads = getSharedAccessWavefronts(dstTy, outVec, elemBytes, getOffset);
+    if (!stores || !loads)
+      return std::nullopt;
+    return *stores + *loads;
+  };
+  auto swizzledWavefronts = getWavefronts(swizzled, repShape);
+  auto paddedWavefronts = getWavefronts(padded, paddedShape);
+  if (!swizzledWavefronts || !paddedWavefronts ||
+      *swizzledWavefronts > *paddedWavefronts)
+    return std::nullopt;
+  return swizzled;
+}
+
 SmallVector<unsigned>
 getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
-                             unsigned &outVec) {
+                             unsigned &outVec, CvtScratchLayout &scratchLayout) {
   auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
   auto dstTy = op.getResult().getType().cast<RankedTensorType>();
   Attribute srcLayout = srcTy.getEncoding();
@@ -92,6 +165,15 @@ getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
   if (auto dstBlockedLayout = dstLayout.dyn_cast<BlockedEncodingAttr>()) {
     paddedDim = dstBlockedLayout.getOrder()[0];
   }
+  // Swizzling the rows instead of padding them saves the padding, as long as
+  // it does not cause more bank conflicts
+  if (auto swizzled = getSwizzledScratchLayout(op, paddedRepShape, paddedDim,
+                                               inVec, outVec)) {
+    scratchLayout = *swizzled;
+    return paddedRepShape;
+  }
+  scratchLayout = CvtScratchLayout();
+  scratchLayout.pad = pad;
   paddedRepShape[paddedDim] += pad;
   return paddedRepShape;
 }
@@ -114,6 +196,63 @@ SmallVector<unsigned> getScratchConfigForAtomicCAS(triton::AtomicCASOp op) {
   return SmallVector<unsigned>{1};
 }
 
+std::optional<unsigned> getScratchSizeInBytes(Operation *op) {
+  if (auto reduceOp = dyn_cast<triton::ReduceOp>(op)) {
+    ReduceOpHelper helper(reduceOp);
+    return helper.getScratchSizeInBytes();
+  } else if (auto scanOp = dyn_cast<triton::ScanOp>(op)) {
+    ScanLoweringHelper helper(scanOp);
+    return helper.getScratchSizeInBytes();
+  } else if (auto cvtLayout = dyn_cast<triton::gpu::ConvertLayoutOp>(op)) {
+    auto srcTy = cvtLayout.getSrc().getType().cast<RankedTensorType>();
+    auto dstTy = cvtLayout.getResult().getType().cast<RankedTensorType>();
+    auto srcEncoding = srcTy.getEncoding();
+    auto dstEncoding = dstTy.getEncoding();
+    if (srcEncoding.isa<SharedEncodingAttr>() ||
+        dstEncoding.isa<SharedEncodingAttr>()) {
+      // Conversions from/to shared memory do not need scratch memory.
+      return std::nullopt;
+    }
+    // Conversions that stay within a warp are done with warp shuffles.
+    if (getWarpShufflesForCvt(srcTy, dstTy))
+      return std::nullopt;
+    // ConvertLayoutOp with both input/output non-shared_layout
+    unsigned inVec = 0;
+    unsigned outVec = 0;
+    CvtScratchLayout scratchLayout;
+    auto smemShape = getScratchConfigForCvtLayout(cvtLayout, inVec, outVec,
+                                                  scratchLayout);
+    unsigned elems = std::accumulate(smemShape.begin(), smemShape.end(), 1,
+                                     std::multiplies{});
+    return srcTy.getElementType().isa<triton::PointerType>()
+               ? elems * kPtrBitWidth / 8
+               : elems * std::max<int>(8, srcTy.getElementTypeBitWidth()) / 8;
+  } else if (auto atomicRMWOp = dyn_cast<triton::AtomicRMWOp>(op)) {
+    auto value = op->getOperand(0);
+    // only scalar requires scratch memory
+    if (value.getType().isa<RankedTensorType>())
+      return std::nullopt;
+    auto smemShape = getScratchConfigForAtomicRMW(atomicRMWOp);
+    unsigned elems = std::accumulate(smemShape.begin(), smemShape.end(), 1,
+                                     std::multiplies{});
+    auto elemTy = value.getType().cast<triton::PointerType>().getPointeeType();
+    return elemTy.isa<triton::PointerType>()
+               ? elems * kPtrBitWidth / 8
+               : elems * std::max<int>(8, elemTy.getIntOrFloatBitWidth()) / 8;
+  } else if (auto atomicCASOp = dyn_cast<triton::AtomicCASOp>(op)) {
+    auto value = op->getOperand(0);
+    auto smemShape = getScratchConfigForAtomicCAS(atomicCASOp);
+    unsigned elems = std::accumulate(smemShape.begin(), smemShape.end(), 1,
+                                     std::multiplies{});
+    auto elemTy =
+        value.getType().cast<triton::PointerType>().getPointeeType();
+    return elemTy.isa<triton::PointerType>()
+               ? elems * kPtrBitWidth / 8
+               : elems * elemTy.getIntOrFloatBitWidth() / 8;
+  }
+  return std::nullopt;
+}
+
 class AllocationAnalysis {
 public:
   AllocationAnalysis(Operation *operation,
@@ -164,73 +303,14 @@ private:
 
   /// Initializes temporary shared memory for a given operation.
   void getScratchValueSize(Operation *op) {
-    if (auto reduceOp = dyn_cast<triton::ReduceOp>(op)) {
-      ReduceOpHelper helper(reduceOp);
-      unsigned bytes = helper.getScratchSizeInBytes();
-      allocation->addBuffer<BufferT::BufferKind::Scratch>(op, bytes);
-    } else if (auto scanOp = dyn_cast<triton::ScanOp>(op)) {
-      ScanLoweringHelper helper(scanOp);
-      unsigned bytes = helper.getScratchSizeInBytes();
-      allocation->addBuffer<BufferT::BufferKind::Scratch>(op, bytes);
-    } else if (auto cvtLayout = dyn_cast<triton::gpu::ConvertLayoutOp>(op)) {
-      auto srcTy = cvtLayout.getSrc().getType().cast<RankedTensorType>();
-      auto dstTy = cvtLayout.getResult().getType().cast<RankedTensorType>();
-      auto srcEncoding = srcTy.getEncoding();
-      auto dstEncoding = dstTy.getEncoding();
-      if (srcEncoding.isa<SharedEncodingAttr>() ||
-          dstEncoding.isa<SharedEncodingAttr>()) {
-        // Conversions from/to shared memory do not need scratch memory.
-        return;
-      }
-      // ConvertLayoutOp with both input/output non-shared_layout
-      // TODO: Besides of implementing ConvertLayoutOp via shared memory, it's
-      //       also possible to realize it with other approaches in restricted
-      //       conditions, such as warp-shuffle
-      unsigned inVec = 0;
-      unsigned outVec = 0;
-      auto smemShape = getScratchConfigForCvtLayout(cvtLayout, inVec, outVec);
-      unsigned elems = std::accumulate(smemShape.begin(), smemShape.end(), 1,
-                                       std::multiplies{});
-      auto bytes =
-          srcTy.getElementType().isa<triton::PointerType>()
-              ? elems * kPtrBitWidth / 8
-              : elems * std::max<int>(8, srcTy.getElementTypeBitWidth()) / 8;
-      allocation->addBuffer<BufferT::BufferKind::Scratch>(op, bytes);
-    } else if (auto atomicRMWOp = dyn_cast<triton::AtomicRMWOp>(op)) {
-      auto value = op->getOperand(0);
-      // only scalar requires scratch memory
-      // make it explicit for readability
-      if (value.getType().dyn_cast<RankedTensorType>()) {
-        // nothing to do
-      } else {
-        auto smemShape = getScratchConfigForAtomicRMW(atomicRMWOp);
-        unsigned elems = std::accumulate(smemShape.begin(), smemShape.end(), 1,
-                                         std::multiplies{});
-        auto elemTy =
-            value.getType().cast<triton::PointerType>().getPointeeType();
-        auto bytes =
-            elemTy.isa<triton::PointerType>()
-                ? elems * kPtrBitWidth / 8
-                : elems * std::max<int>(8, elemTy.getIntOrFloatBitWidth()) / 8;
-        allocation->addBuffer<BufferT::BufferKind::Scratch>(op, bytes);
-      }
-    } else if (auto atomicCASOp = dyn_cast<triton::AtomicCASOp>(op)) {
-      auto value = op->getOperand(0);
-      auto smemShape = getScratchConfigForAtomicCAS(atomicCASOp);
-      unsigned elems = std::accumulate(smemShape.begin(), smemShape.end(), 1,
-                                       std::multiplies{});
-      auto elemTy =
-          value.getType().cast<triton::PointerType>().getPointeeType();
-      auto bytes = elemTy.isa<triton::PointerType>()
-                       ? elems * kPtrBitWidth / 8
-                       : elems * elemTy.getIntOrFloatBitWidth() / 8;
-      allocation->addBuffer<BufferT::BufferKind::Scratch>(op, bytes);
-    } else if (auto callOp = dyn_cast<CallOpInterface>(op)) {
+    if (auto callOp = dyn_cast<CallOpInterface>(op)) {
       auto callable = callOp.resolveCallable();
       auto funcOp = dyn_cast<FunctionOpInterface>(callable);
       auto *funcAlloc = &(*funcAllocMap)[funcOp];
       auto bytes = funcAlloc->getSharedMemorySize();
       allocation->addBuffer<BufferT::BufferKind::Virtual>(op, bytes);
+    } else if (auto bytes = getScratchSizeInBytes(op)) {
+      allocation->addBuffer<BufferT::BufferKind::Scratch>(op, *bytes);
     }
   }
 
@@ -7,6 +7,7 @@
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
 #include <deque>
+#include <set>
 
 namespace mlir {
 
@@ -215,13 +216,14 @@ bool ScanLoweringHelper::isSupported() {
 
 unsigned ScanLoweringHelper::getScratchSizeInBytes() {
   auto type = scanOp.getOperand(0).getType().cast<RankedTensorType>();
-  unsigned elementSizeInBytes = type.getElementTypeBitWidth() / 8;
-  auto mod = scanOp->getParentOfType<ModuleOp>();
-  unsigned numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
-  unsigned numNonAxisElementsPerWapr =
-      getNonAxisNumThreadsPerWarp() * getNonAxisNumElementsPerThread();
-  unsigned numElements = numWarps * numNonAxisElementsPerWapr *
-                         getAxisNumBlocks() * getNonAxisNumBlocks();
+  unsigned elementSizeInBytes =
+      ceil<unsigned>(type.getElementTypeBitWidth(), 8);
+  // One partial result per warp along the axis, per parallel thread and per
+  // chunk of contiguous elements, as indexed by the lowering
+  unsigned numChunks = getNonAxisNumElementsPerThread() * getAxisNumBlocks() *
+                       getNonAxisNumBlocks();
+  unsigned numElements =
+      getNonAxisNumThreadsPerCTA() * getAxisNumWarps() * numChunks;
   return elementSizeInBytes * numElements;
 }
 
@@ -331,6 +333,332 @@ bool isMmaToDotShortcut(RankedTensorType &srcTy, RankedTensorType &dstTy) {
          !srcTy.getElementType().isF32();
 }
 
+namespace {
+
+using triton::gpu::BlockedEncodingAttr;
+using triton::gpu::MmaEncodingAttr;
+using triton::gpu::SliceEncodingAttr;
+
+constexpr unsigned kWarpSize = 32;
+
+SmallVector<unsigned> delinearize(unsigned linear, ArrayRef<unsigned> shape,
+                                  ArrayRef<unsigned> order) {
+  SmallVector<unsigned> multiDim(shape.size());
+  for (unsigned d : order) {
+    multiDim[d] = linear % shape[d];
+    linear /= shape[d];
+  }
+  return multiDim;
+}
+
+unsigned getNumWarpsOfLayout(Attribute layout) {
+  if (auto sliceLayout = layout.dyn_cast<SliceEncodingAttr>())
+    return getNumWarpsOfLayout(sliceLayout.getParent());
+  return product<unsigned>(triton::gpu::getWarpsPerCTA(layout));
+}
+
+/// The offsets of the elements of a thread from its first one, in the order
+/// of its registers. Mirrors emitOffsetForLayout in the lowering to LLVM.
+std::optional<SmallVector<SmallVector<unsigned>>>
+getElemOffsets(Attribute layout, ArrayRef<int64_t> shape) {
+  unsigned rank = shape.size();
+  SmallVector<SmallVector<unsigned>> offsets;
+  if (auto blockedLayout = layout.dyn_cast<BlockedEncodingAttr>()) {
+    auto sizePerThread = blockedLayout.getSizePerThread();
+    auto order = blockedLayout.getOrder();
+    auto shapePerCTA = triton::gpu::getShapePerCTA(blockedLayout);
+    SmallVector<unsigned> tilesPerDim(rank);
+    for (unsigned d = 0; d < rank; ++d)
+      tilesPerDim[d] = ceil<unsigned>(shape[d], shapePerCTA[d]);
+    unsigned elemsPerTile = product<unsigned>(sizePerThread);
+    unsigned numElems = product<unsigned>(tilesPerDim) * elemsPerTile;
+    for (unsigned n = 0; n < numElems; ++n) {
+      auto tileId = delinearize(n / elemsPerTile, tilesPerDim, order);
+      auto elemId = delinearize(n % elemsPerTile, sizePerThread, order);
+      SmallVector<unsigned> offset(rank);
+      for (unsigned d = 0; d < rank; ++d)
+        offset[d] = tileId[d] * shapePerCTA[d] + elemId[d];
+      offsets.push_back(offset);
+    }
+    return offsets;
+  }
+  if (auto mmaLayout = layout.dyn_cast<MmaEncodingAttr>()) {
+    if (!mmaLayout.isAmpere())
+      return std::nullopt;
+    auto shapePerCTA = triton::gpu::getShapePerCTA(mmaLayout);
+    for (unsigned i = 0; i < shape[0]; i += shapePerCTA[0]) {
+      for (unsigned j = 0; j < shape[1]; j += shapePerCTA[1]) {
+        offsets.push_back({i, j});
+        offsets.push_back({i, j + 1});
+        offsets.push_back({i + 8, j});
+        offsets.push_back({i + 8, j + 1});
+      }
+    }
+    return offsets;
+  }
+  if (auto sliceLayout = layout.dyn_cast<SliceEncodingAttr>()) {
+    auto parentOffsets = getElemOffsets(sliceLayout.getParent(),
+                                        sliceLayout.paddedShape(shape));
+    if (!parentOffsets)
+      return std::nullopt;
+    std::set<SmallVector<unsigned>> uniqueOffsets;
+    for (SmallVector<unsigned> offset : *parentOffsets) {
+      offset.erase(offset.begin() + sliceLayout.getDim());
+      if (uniqueOffsets.insert(offset).second)
+        offsets.push_back(offset);
+    }
+    return offsets;
+  }
+  return std::nullopt;
+}
+
+/// The index of the first element of lane `laneId` of warp `warpId`. Mirrors
+/// emitBaseIndexForLayout in the lowering to LLVM.
+std::optional<SmallVector<unsigned>> getThreadBase(Attribute layout,
+                                                   ArrayRef<int64_t> shape,
+                                                   unsigned warpId,
+                                                   unsigned laneId) {
+  unsigned rank = shape.size();
+  if (auto blockedLayout = layout.dyn_cast<BlockedEncodingAttr>()) {
+    auto sizePerThread = blockedLayout.getSizePerThread();
+    auto threadsPerWarp = blockedLayout.getThreadsPerWarp();
+    auto order = blockedLayout.getOrder();
+    auto multiDimWarpId =
+        delinearize(warpId, blockedLayout.getWarpsPerCTA(), order);
+    auto multiDimLaneId = delinearize(laneId, threadsPerWarp, order);
+    SmallVector<unsigned> base(rank);
+    for (unsigned d = 0; d < rank; ++d) {
+      unsigned maxWarps =
+          ceil<unsigned>(shape[d], sizePerThread[d] * threadsPerWarp[d]);
+      unsigned maxThreads = ceil<unsigned>(shape[d], sizePerThread[d]);
+      base[d] = sizePerThread[d] *
+                (multiDimLaneId[d] % maxThreads +
+                 (multiDimWarpId[d] % maxWarps) * threadsPerWarp[d]);
+    }
+    return base;
+  }
+  if (auto mmaLayout = layout.dyn_cast<MmaEncodingAttr>()) {
+    if (!mmaLayout.isAmpere() || shape[0] < 16 || shape[1] < 8)
+      return std::nullopt;
+    auto multiDimWarpId = delinearize(warpId, mmaLayout.getWarpsPerCTA(),
+                                      triton::gpu::getOrder(mmaLayout));
+    unsigned warpM = multiDimWarpId[0] % (shape[0] / 16);
+    unsigned warpN = multiDimWarpId[1] % (shape[1] / 8);
+    return SmallVector<unsigned>{laneId / 4 + 16 * warpM,
+                                 2 * (laneId % 4) + 8 * warpN};
+  }
+  if (auto sliceLayout = layout.dyn_cast<SliceEncodingAttr>()) {
+    auto base = getThreadBase(sliceLayout.getParent(),
+                              sliceLayout.paddedShape(shape), warpId, laneId);
+    if (base)
+      base->erase(base->begin() + sliceLayout.getDim());
+    return base;
+  }
+  return std::nullopt;
+}
+
+/// The row-major index in the tensor of each register of each thread of the
+/// first `numWarps` warps
+std::optional<SmallVector<SmallVector<int64_t>>>
+getElemIds(RankedTensorType type, unsigned numWarps) {
+  Attribute layout = type.getEncoding();
+  auto shape = type.getShape();
+  auto offsets = getElemOffsets(layout, shape);
+  if (!offsets || offsets->size() != triton::gpu::getTotalElemsPerThread(type))
+    return std::nullopt;
+  SmallVector<SmallVector<int64_t>> ids;
+  for (unsigned thread = 0; thread < numWarps * kWarpSize; ++thread) {
+    auto base =
+        getThreadBase(layout, shape, thread / kWarpSize, thread % kWarpSize);
+    if (!base)
+      return std::nullopt;
+    SmallVector<int64_t> &threadIds = ids.emplace_back();
+    for (ArrayRef<unsigned> offset : *offsets) {
+      int64_t id = 0;
+      for (unsigned d = 0; d < shape.size(); ++d) {
+        int64_t idx = (*base)[d] + offset[d];
+        if (idx >= shape[d])
+          return std::nullopt;
+        id = id * shape[d] + idx;
+      }
+      threadIds.push_back(id);
+    }
+  }
+  return ids;
+}
+
+/// For each warp, the (lane, register) pairs of the source that hold each
+/// element
+using HolderMap =
+    SmallVector<DenseMap<int64_t, SmallVector<std::pair<unsigned, unsigned>>>>;
+
+/// At most this many registers of the source are shuffled for each register
+/// of the destination
+constexpr unsigned kMaxShufflesPerReg = 2;
+
+/// How each lane gets its register `dstReg` of the destination, provided
+/// that it reads from the same lane and register in every warp
+std::optional<WarpShuffle> getWarpShuffle(const HolderMap &holders,
+                                          ArrayRef<SmallVector<int64_t>> dstIds,
+                                          unsigned dstReg) {
+  SmallVector<unsigned> srcLanes(kWarpSize);
+  SmallVector<SmallVector<unsigned>> srcRegs(kWarpSize);
+  for (unsigned warp = 0; warp < holders.size(); ++warp) {
+    for (unsigned lane = 0; lane < kWarpSize; ++lane) {
+      auto it = holders[warp].find(dstIds[warp * kWarpSize + lane][dstReg]);
+      if (it == holders[warp].end())
+        return std::nullopt;
+      // Prefer the lane itself, then the lowest one holding the element
+      std::optional<unsigned> srcLane;
+      for (auto [holderLane, holderReg] : it->second)
+        if (!srcLane || holderLane == lane)
+          srcLane = holderLane;
+      SmallVector<unsigned> regs;
+      for (auto [holderLane, holderReg] : it->second)
+        if (holderLane == *srcLane)
+          regs.push_back(holderReg);
+      if (warp == 0) {
+        srcLanes[lane] = *srcLane;
+        srcRegs[lane] = regs;
+        continue;
+      }
+      if (srcLanes[lane] != *srcLane)
+        return std::nullopt;
+      llvm::erase_if(srcRegs[lane], [&](unsigned reg) {
+        return !llvm::is_contained(regs, reg);
+      });
+      if (srcRegs[lane].empty())
+        return std::nullopt;
+    }
+  }
+
+  // The source lane has to be an affine function of the lane
+  WarpShuffle shuffle;
+  shuffle.laneXor = srcLanes[0];
+  for (unsigned lane = 1; lane < kWarpSize; lane <<= 1)
+    shuffle.laneBits.push_back(srcLanes[lane] ^ shuffle.laneXor);
+  for (unsigned lane = 0; lane < kWarpSize; ++lane) {
+    unsigned srcLane = shuffle.laneXor;
+    for (unsigned bit = 0; bit < shuffle.laneBits.size(); ++bit)
+      if (lane & (1u << bit))
+        srcLane ^= shuffle.laneBits[bit];
+    if (srcLane != srcLanes[lane])
+      return std::nullopt;
+  }
+
+  // Each distinct register of the source takes its own shuffle
+  SmallVector<unsigned> distinctRegs;
+  for (unsigned lane = 0; lane < kWarpSize; ++lane) {
+    shuffle.srcRegs.push_back(srcRegs[lane].front());
+    if (!llvm::is_contained(distinctRegs, shuffle.srcRegs.back()))
+      distinctRegs.push_back(shuffle.srcRegs.back());
+  }
+  if (distinctRegs.size() > kMaxShufflesPerReg)
+    return std::nullopt;
+  shuffle.regLaneMask = 0;
+  for (unsigned lane = 0; lane < kWarpSize; ++lane)
+    for (unsigned bit = 1; bit < kWarpSize; bit <<= 1)
+      if (shuffle.srcRegs[lane] != shuffle.srcRegs[lane ^ bit])
+        shuffle.regLaneMask |= bit;
+  return shuffle;
+}
+
+} // namespace
+
+bool WarpShuffle::readsOwnLane() const {
+  if (laneXor != 0)
+    return false;
+  for (unsigned bit = 0; bit < laneBits.size(); ++bit)
+    if (laneBits[bit] != 1u << bit)
+      return false;
+  return true;
+}
+
+std::optional<SmallVector<WarpShuffle>>
+getWarpShufflesForCvt(RankedTensorType srcTy, RankedTensorType dstTy) {
+  Attribute srcLayout = srcTy.getEncoding();
+  Attribute dstLayout = dstTy.getEncoding();
+  if (!triton::gpu::isaDistributedLayout(srcLayout) ||
+      !triton::gpu::isaDistributedLayout(dstLayout))
+    return std::nullopt;
+  // A layout with fewer warps than the other one is replicated across warps
+  unsigned numWarps = std::max(getNumWarpsOfLayout(srcLayout),
+                               getNumWarpsOfLayout(dstLayout));
+  auto srcIds = getElemIds(srcTy, numWarps);
+  auto dstIds = getElemIds(dstTy, numWarps);
+  if (!srcIds || !dstIds)
+    return std::nullopt;
+
+  HolderMap holders(numWarps);
+  for (unsigned thread = 0; thread < srcIds->size(); ++thread)
+    for (unsigned reg = 0; reg < (*srcIds)[thread].size(); ++reg)
+      holders[thread / kWarpSize][(*srcIds)[thread][reg]].push_back(
+          {thread % kWarpSize, reg});
+
+  SmallVector<WarpShuffle> shuffles;
+  for (unsigned dstReg = 0; dstReg < dstIds->front().size(); ++dstReg) {
+    std::optional<WarpShuffle> shuffle =
+        getWarpShuffle(holders, *dstIds, dstReg);
+    if (!shuffle)
+      return std::nullopt;
+    shuffles.push_back(std::move(*shuffle));
+  }
+  return shuffles;
+}
+
+std::optional<unsigned>
+getSharedAccessWavefronts(RankedTensorType type, unsigned vec,
+                          unsigned elemBytes,
+                          function_ref<unsigned(ArrayRef<unsigned>)> getOffset) {
+  Attribute layout = type.getEncoding();
+  auto shape = type.getShape();
+  auto offsets = getElemOffsets(layout, shape);
+  if (!offsets)
+    return std::nullopt;
+  SmallVector<SmallVector<unsigned>> bases;
+  for (unsigned lane = 0; lane < kWarpSize; ++lane) {
+    auto base = getThreadBase(layout, shape, /*warpId=*/0, lane);
+    if (!base)
+      return std::nullopt;
+    bases.push_back(*base);
+  }
+  auto shapePerCTA = triton::gpu::getShapePerCTA(layout, shape);
+
+  // Shared memory serves 32 banks of 4 bytes per wavefront, so wide accesses
+  // are split into groups of lanes that request at most 128 bytes
+  constexpr unsigned kNumBanks = 32;
+  unsigned accessBytes = vec * elemBytes;
+  unsigned lanesPerGroup =
+      std::clamp(4 * kNumBanks / accessBytes, 1u, kWarpSize);
+  unsigned wavefronts = 0;
+  for (unsigned i = 0; i < offsets->size(); i += vec) {
+    ArrayRef<unsigned> offset = (*offsets)[i];
+    bool inFirstTile = true;
+    for (unsigned d = 0; d < shape.size(); ++d)
+      inFirstTile &= offset[d] < std::min<int64_t>(shape[d], shapePerCTA[d]);
+    if (!inFirstTile)
+      continue;
+    for (unsigned group = 0; group < kWarpSize; group += lanesPerGroup) {
+      // Lanes reading the same word are served by the same wavefront
+      SmallVector<std::set<unsigned>> bankWords(kNumBanks);
+      for (unsigned lane = group; lane < group + lanesPerGroup; ++lane) {
+        SmallVector<unsigned> idx(shape.size());
+        for (unsigned d = 0; d < shape.size(); ++d)
+          idx[d] = bases[lane][d] + offset[d];
+        unsigned addr = getOffset(idx) * elemBytes;
+        for (unsigned word = addr / 4;
+             word < ceil<unsigned>(addr + accessBytes, 4); ++word)
+          bankWords[word % kNumBanks].insert(word);
+      }
+      size_t conflicts = 1;
+      for (const std::set<unsigned> &words : bankWords)
+        conflicts = std::max(conflicts, words.size());
+      wavefronts += conflicts;
+    }
+  }
+  return wavefronts;
+}
+
 bool isSingleValue(Value value) {
   // Don't consider load as expensive if it is loading a scalar.
   if (auto tensorTy = value.getType().dyn_cast<RankedTensorType>())
@@ -5,6 +5,7 @@ using ::mlir::LLVM::delinearize;
 using ::mlir::LLVM::getSharedMemoryObjectFromStruct;
 using ::mlir::LLVM::getStridesFromShapeAndOrder;
 using ::mlir::LLVM::linearize;
+using ::mlir::LLVM::shflIdxSync;
 using ::mlir::triton::gpu::DotOperandEncodingAttr;
 using ::mlir::triton::gpu::getContigPerThread;
 using ::mlir::triton::gpu::getOrder;
@@ -138,72 +139,42 @@ private:
       return multiDimOffset;
     }
     if (auto mmaLayout = layout.dyn_cast<MmaEncodingAttr>()) {
-      SmallVector<Value> mmaColIdx(4);
-      SmallVector<Value> mmaRowIdx(2);
-      Value threadId = getThreadId(rewriter, loc);
-      Value warpSize = i32_val(32);
-      Value laneId = urem(threadId, warpSize);
-      Value warpId = udiv(threadId, warpSize);
-      // TODO: fix the bug in MMAEncodingAttr document
-      auto warpsPerCTA = mmaLayout.getWarpsPerCTA();
-      auto order = triton::gpu::getOrder(mmaLayout);
-      SmallVector<Value> multiDimWarpId =
-          delinearize(rewriter, loc, warpId, warpsPerCTA, order);
-      Value _1 = i32_val(1);
-      Value _2 = i32_val(2);
-      Value _4 = i32_val(4);
-      Value _8 = i32_val(8);
-      Value _16 = i32_val(16);
-      if (mmaLayout.isAmpere()) {
-        multiDimWarpId[0] = urem(multiDimWarpId[0], i32_val(shape[0] / 16));
-        multiDimWarpId[1] = urem(multiDimWarpId[1], i32_val(shape[1] / 8));
-        Value mmaGrpId = udiv(laneId, _4);
-        Value mmaGrpIdP8 = add(mmaGrpId, _8);
-        Value mmaThreadIdInGrp = urem(laneId, _4);
-        Value mmaThreadIdInGrpM2 = mul(mmaThreadIdInGrp, _2);
-        Value mmaThreadIdInGrpM2P1 = add(mmaThreadIdInGrpM2, _1);
-        Value rowWarpOffset = mul(multiDimWarpId[0], _16);
-        mmaRowIdx[0] = add(mmaGrpId, rowWarpOffset);
-        mmaRowIdx[1] = add(mmaGrpIdP8, rowWarpOffset);
-        Value colWarpOffset = mul(multiDimWarpId[1], _8);
-        mmaColIdx[0] = add(mmaThreadIdInGrpM2, colWarpOffset);
-        mmaColIdx[1] = add(mmaThreadIdInGrpM2P1, colWarpOffset);
-      } else if (mmaLayout.isVolta()) {
-        // Volta doesn't follow the pattern here."
-      } else {
-        llvm_unreachable("Unexpected MMALayout version");
-      }
-
       assert(rank == 2);
-      SmallVector<Value> multiDimOffset(rank);
       if (mmaLayout.isAmpere()) {
-        multiDimOffset[0] = elemId < 2 ? mmaRowIdx[0] : mmaRowIdx[1];
-        multiDimOffset[1] = elemId % 2 == 0 ? mmaColIdx[0] : mmaColIdx[1];
-        multiDimOffset[0] = add(
-            multiDimOffset[0], i32_val(multiDimCTAInRepId[0] * shapePerCTA[0]));
-        multiDimOffset[1] = add(
-            multiDimOffset[1], i32_val(multiDimCTAInRepId[1] * shapePerCTA[1]));
-      } else if (mmaLayout.isVolta()) {
+        // Elements {0, 1} are in the row of the base, {2, 3} 8 rows below
+        auto multiDimBase = emitBaseIndexForLayout(loc, rewriter, layout, type);
+        SmallVector<Value> multiDimOffset(rank);
+        multiDimOffset[0] =
+            add(multiDimBase[0],
+                i32_val((elemId < 2 ? 0 : 8) +
+                        multiDimCTAInRepId[0] * shapePerCTA[0]));
+        multiDimOffset[1] =
+            add(multiDimBase[1],
+                i32_val(elemId % 2 + multiDimCTAInRepId[1] * shapePerCTA[1]));
+        return multiDimOffset;
+      }
+      if (mmaLayout.isVolta()) {
         auto [isARow, isBRow, isAVec4, isBVec4, _] =
             mmaLayout.decodeVoltaLayoutStates();
         auto coords = SharedToDotOperandMMAv1::getMNCoords(
-            threadId, loc, rewriter, mmaLayout.getWarpsPerCTA(), mmaLayout,
-            shape, isARow, isBRow, isAVec4, isBVec4);
+            getThreadId(rewriter, loc), loc, rewriter,
+            mmaLayout.getWarpsPerCTA(), mmaLayout, shape, isARow, isBRow,
+            isAVec4, isBVec4);
         return coords[elemId];
-      } else {
-        llvm_unreachable("Unexpected MMALayout version");
       }
-      return multiDimOffset;
+      llvm_unreachable("Unexpected MMALayout version");
     }
     llvm_unreachable("unexpected layout in getMultiDimOffset");
   }
 
-  // shared memory rd/st for blocked or mma layout with data padding
+  // shared memory rd/st for blocked or mma layout with data padding or
+  // swizzling
   void processReplica(Location loc, ConversionPatternRewriter &rewriter,
                       bool stNotRd, RankedTensorType type,
                       ArrayRef<unsigned> numCTAsEachRep,
                       ArrayRef<unsigned> multiDimRepId, unsigned vec,
                       ArrayRef<unsigned> paddedRepShape,
+                      const CvtScratchLayout &scratchLayout,
                       ArrayRef<unsigned> outOrd, SmallVector<Value> &vals,
                       Value smemBase) const {
     auto accumNumCTAsEachRep = product<unsigned>(numCTAsEachRep);
@@ -239,15 +210,27 @@ private:
 
       auto linearCTAId =
           getLinearIndex<unsigned>(multiDimCTAId, numCTAs, order);
-      // TODO: This is actually redundant index calculation, we should
-      //       consider of caching the index calculation result in case
-      //       of performance issue observed.
+      // The base indices of the layout are materialized once per function,
+      // only the constant offsets of the elements are added here.
       for (unsigned elemId = 0; elemId < accumSizePerThread; elemId += vec) {
         SmallVector<Value> multiDimOffset =
             getMultiDimOffset(layout, loc, rewriter, elemId, type,
                               multiDimCTAInRepId, shapePerCTA);
         Value offset =
             linearize(rewriter, loc, multiDimOffset, paddedRepShape, outOrd);
+        if (scratchLayout.isSwizzled()) {
+          // Move the chunk of the element within its row
+          unsigned rowLen = paddedRepShape[outOrd[0]];
+          Value col = multiDimOffset[outOrd[0]];
+          Value row = udiv(offset, i32_val(rowLen));
+          Value phase =
+              urem(udiv(row, i32_val(scratchLayout.perPhase)),
+                   i32_val(scratchLayout.maxPhase));
+          Value chunk = xor_(udiv(col, i32_val(scratchLayout.vec)), phase);
+          offset = add(mul(row, i32_val(rowLen)),
+                       add(mul(chunk, i32_val(scratchLayout.vec)),
+                           urem(col, i32_val(scratchLayout.vec))));
+        }
 
         auto elemPtrTy = ptr_ty(llvmElemTy, 3);
         Value ptr = gep(elemPtrTy, smemBase, offset);
@@ -382,6 +365,93 @@ private:
     }
   }
 
+  // blocked/mma -> blocked/mma within a warp.
+  // Each register of the destination is read from one or two registers of
+  // other lanes of the source with shfl.sync, without going through shared
+  // memory.
+  LogicalResult lowerDistributedToDistributedWithShuffles(
+      triton::gpu::ConvertLayoutOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter,
+      ArrayRef<WarpShuffle> shuffles) const {
+    auto loc = op.getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto dstTy = op.getResult().getType().cast<RankedTensorType>();
+    auto vals = getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(),
+                                                     rewriter, srcTy);
+    auto llvmElemTy = getTypeConverter()->convertType(dstTy.getElementType());
+    bool isPtr = dstTy.getElementType().isa<triton::PointerType>();
+    Value laneId = urem(getThreadId(rewriter, loc), i32_val(32));
+
+    // The lane to read from is shared by the registers with the same pattern
+    std::map<std::pair<unsigned, SmallVector<unsigned>>, Value> srcLanes;
+    auto getSrcLane = [&](const WarpShuffle &shuffle) {
+      Value &srcLane = srcLanes[{shuffle.laneXor, shuffle.laneBits}];
+      if (srcLane)
+        return srcLane;
+      srcLane = i32_val(shuffle.laneXor);
+      unsigned keptBits = 0;
+      for (const auto &laneBit : llvm::enumerate(shuffle.laneBits))
+        if (laneBit.value() == 1u << laneBit.index())
+          keptBits |= laneBit.value();
+      if (keptBits)
+        srcLane = xor_(srcLane, and_(laneId, i32_val(keptBits)));
+      for (const auto &laneBit : llvm::enumerate(shuffle.laneBits)) {
+        if (laneBit.value() == 0 || (keptBits & laneBit.value()))
+          continue;
+        Value isSet =
+            icmp_ne(and_(laneId, i32_val(1u << laneBit.index())), i32_val(0));
+        srcLane =
+            xor_(srcLane, select(isSet, i32_val(laneBit.value()), i32_val(0)));
+      }
+      return srcLane;
+    };
+
+    // Registers of the source read from the same lanes are only shuffled once
+    std::map<std::tuple<unsigned, unsigned, SmallVector<unsigned>>, Value>
+        shuffled;
+    auto shuffleReg = [&](const WarpShuffle &shuffle, unsigned srcReg) {
+      if (shuffle.readsOwnLane())
+        return vals[srcReg];
+      Value &val = shuffled[{srcReg, shuffle.laneXor, shuffle.laneBits}];
+      if (val)
+        return val;
+      val = vals[srcReg];
+      if (isPtr)
+        val = ptrtoint(i64_ty, val);
+      val = shflIdxSync(loc, rewriter, val, getSrcLane(shuffle));
+      if (isPtr)
+        val = inttoptr(llvmElemTy, val);
+      return val;
+    };
+
+    SmallVector<Value> outVals;
+    for (const WarpShuffle &shuffle : shuffles) {
+      Value val = shuffleReg(shuffle, shuffle.srcRegs[0]);
+      // Lanes that read another register of the source pick it afterwards
+      SmallVector<unsigned> doneRegs = {shuffle.srcRegs[0]};
+      for (unsigned srcReg : shuffle.srcRegs) {
+        if (llvm::is_contained(doneRegs, srcReg))
+          continue;
+        doneRegs.push_back(srcReg);
+        Value laneKey = and_(laneId, i32_val(shuffle.regLaneMask));
+        Value readsReg;
+        for (unsigned lane = 0; lane < 32; ++lane) {
+          if ((lane & ~shuffle.regLaneMask) || shuffle.srcRegs[lane] != srcReg)
+            continue;
+          Value isLane = icmp_eq(laneKey, i32_val(lane));
+          readsReg = readsReg ? or_(readsReg, isLane) : isLane;
+        }
+        val = select(readsReg, shuffleReg(shuffle, srcReg), val);
+      }
+      outVals.push_back(val);
+    }
+
+    Value result =
+        getTypeConverter()->packLLElements(loc, outVals, rewriter, dstTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
   // blocked/mma -> blocked/mma.
   // Data padding in shared memory to avoid bank conflict.
   LogicalResult
@@ -393,6 +463,9 @@ private:
     Value dst = op.getResult();
     auto srcTy = src.getType().cast<RankedTensorType>();
     auto dstTy = dst.getType().cast<RankedTensorType>();
+    if (auto shuffles = getWarpShufflesForCvt(srcTy, dstTy))
+      return lowerDistributedToDistributedWithShuffles(op, adaptor, rewriter,
+                                                       *shuffles);
     Attribute srcLayout = srcTy.getEncoding();
     Attribute dstLayout = dstTy.getEncoding();
     auto llvmElemTy = getTypeConverter()->convertType(dstTy.getElementType());
@@ -444,7 +517,9 @@ private:
                                                      rewriter, srcTy);
     unsigned inVec = 0;
     unsigned outVec = 0;
-    auto paddedRepShape = getScratchConfigForCvtLayout(op, inVec, outVec);
+    CvtScratchLayout scratchLayout;
+    auto paddedRepShape =
+        getScratchConfigForCvtLayout(op, inVec, outVec, scratchLayout);
 
     unsigned outElems = getTotalElemsPerThread(dstTy);
     auto outOrd = getOrder(dstLayout);
@@ -465,7 +540,7 @@ private:
         else
           processReplica(loc, rewriter, /*stNotRd*/ true, srcTy,
                          inNumCTAsEachRep, multiDimRepId, inVec, paddedRepShape,
-                         outOrd, vals, smemBase);
+                         scratchLayout, outOrd, vals, smemBase);
       } else {
         assert(0 && "ConvertLayout with input layout not implemented");
         return failure();
@@ -482,7 +557,8 @@ private:
         else
           processReplica(loc, rewriter, /*stNotRd*/ false, dstTy,
                          outNumCTAsEachRep, multiDimRepId, outVec,
-                         paddedRepShape, outOrd, outVals, smemBase);
+                         paddedRepShape, scratchLayout, outOrd, outVals,
+                         smemBase);
       } else {
         assert(0 && "ConvertLayout with output layout not implemented");
         return failure();
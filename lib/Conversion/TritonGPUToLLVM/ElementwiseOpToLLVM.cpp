@@ -2,7 +2,9 @@
 
 using namespace mlir;
 using namespace mlir::triton;
+using ::mlir::triton::gpu::getOrder;
 using ::mlir::triton::gpu::getTotalElemsPerThread;
+using ::mlir::triton::gpu::getUniqueContigPerThread;
 
 /* ----- FP8E5M2 ------ */
 // This data-type is the standard FP8E5M2 format
@@ -225,6 +227,99 @@ const std::string Bf16_to_Fp8E4M3 =
     "or.b32 $0, nosign, sign;                    \n" // restore sign
     "}";
 
+/* ----- FP8 <-> FP32 ------ */
+// The packed FP8 <-> FP16 conversions above, extended to four FP32 values in
+// the same inline PTX instead of converting each of them separately.
+
+// Rename the operands of an inline PTX snippet, `$i` becoming `names[i]`
+static std::string renamePtxOperands(const std::string &ptxAsm,
+                                     ArrayRef<std::string> names) {
+  std::string ret;
+  for (size_t i = 0; i < ptxAsm.size(); ++i) {
+    if (ptxAsm[i] != '$' || i + 1 == ptxAsm.size() ||
+        !llvm::isDigit(ptxAsm[i + 1])) {
+      ret += ptxAsm[i];
+      continue;
+    }
+    unsigned idx = 0;
+    while (i + 1 < ptxAsm.size() && llvm::isDigit(ptxAsm[i + 1]))
+      idx = idx * 10 + (ptxAsm[++i] - '0');
+    ret += names[idx];
+  }
+  return ret;
+}
+
+// Fp32 -> Fp8 (packed): $0 = fp8x4, $1..$4 = fp32
+static std::string fp32ToFp8ThroughFp16(const std::string &fp16ToFp8) {
+  return "{                                      \n"
+         ".reg .b16 f16_<4>;                     \n"
+         ".reg .b32 f16x2_<2>;                   \n"
+         "cvt.rn.f16.f32 f16_0, $1;              \n"
+         "cvt.rn.f16.f32 f16_1, $2;              \n"
+         "cvt.rn.f16.f32 f16_2, $3;              \n"
+         "cvt.rn.f16.f32 f16_3, $4;              \n"
+         "mov.b32 f16x2_0, {f16_0, f16_1};       \n"
+         "mov.b32 f16x2_1, {f16_2, f16_3};       \n" +
+         renamePtxOperands(fp16ToFp8, {"$0", "f16x2_0", "f16x2_1"}) +
+         "\n}";
+}
+
+// Fp8 -> Fp32 (packed): $0..$3 = fp32, $4 = fp8x4
+static std::string fp8ToFp32ThroughFp16(const std::string &fp8ToFp16) {
+  return "{                                      \n"
+         ".reg .b16 f16_<4>;                     \n"
+         ".reg .b32 f16x2_<2>;                   \n" +
+         renamePtxOperands(fp8ToFp16, {"f16x2_0", "f16x2_1", "$4"}) +
+         "\n"
+         "mov.b32 {f16_0, f16_1}, f16x2_0;       \n"
+         "mov.b32 {f16_2, f16_3}, f16x2_1;       \n"
+         "cvt.f32.f16 $0, f16_0;                 \n"
+         "cvt.f32.f16 $1, f16_1;                 \n"
+         "cvt.f32.f16 $2, f16_2;                 \n"
+         "cvt.f32.f16 $3, f16_3;                 \n"
+         "}";
+}
+
+/* ----- Native FP8 (sm_89+) ------ */
+// `cvt` converts pairs of FP8 values (`e4m3` or `e5m2`) from and to FP16
+// pairs, and to them from FP32 pairs, with proper handling of denormals, nans
+// and saturation.
+// These do not give the same bits as the software conversions above: PTX
+// `e4m3` is E4M3FN, where 0x7f/0xff are NaN and `satfinite` clamps to +-448,
+// while Fp8E4M3_to_Fp16 decodes 0x7f as 480 and the software down-casts do not
+// saturate (e5m2 overflows to inf instead of 57344). They are hence only used
+// on request (`native-fp8`).
+
+// Fp8 -> Fp16 (packed)
+static std::string nativeFp8ToFp16(const std::string &fp8Type) {
+  return "{                                      \n"
+         ".reg .b16 a<2>;                        \n"
+         "mov.b32 {a0, a1}, $2;                  \n"
+         "cvt.rn.f16x2." + fp8Type + "x2 $0, a0; \n"
+         "cvt.rn.f16x2." + fp8Type + "x2 $1, a1; \n"
+         "}";
+}
+
+// Fp16 -> Fp8 (packed)
+static std::string nativeFp16ToFp8(const std::string &fp8Type) {
+  return "{                                      \n"
+         ".reg .b16 a<2>;                        \n"
+         "cvt.rn.satfinite." + fp8Type + "x2.f16x2 a0, $1; \n"
+         "cvt.rn.satfinite." + fp8Type + "x2.f16x2 a1, $2; \n"
+         "mov.b32 $0, {a0, a1};                  \n"
+         "}";
+}
+
+// Fp32 -> Fp8 (packed). The first source goes to the upper byte.
+static std::string nativeFp32ToFp8(const std::string &fp8Type) {
+  return "{                                      \n"
+         ".reg .b16 a<2>;                        \n"
+         "cvt.rn.satfinite." + fp8Type + "x2.f32 a0, $2, $1; \n"
+         "cvt.rn.satfinite." + fp8Type + "x2.f32 a1, $4, $3; \n"
+         "mov.b32 $0, {a0, a1};                  \n"
+         "}";
+}
+
 static SmallVector<Value> reorderValues(const SmallVector<Value> &values,
                                         Type inType, Type ouType) {
   auto inTensorTy = inType.dyn_cast<RankedTensorType>();
@@ -352,8 +447,12 @@ inline SmallVector<Value> packI32(const SmallVector<Value> &inValues,
 
 struct FpToFpOpConversion
     : public ConvertTritonGPUOpToLLVMPattern<triton::FpToFpOp> {
-  using ConvertTritonGPUOpToLLVMPattern<
-      triton::FpToFpOp>::ConvertTritonGPUOpToLLVMPattern;
+  FpToFpOpConversion(TritonGPUToLLVMTypeConverter &typeConverter,
+                     int computeCapability, bool nativeFp8,
+                     PatternBenefit benefit = 1)
+      : ConvertTritonGPUOpToLLVMPattern<triton::FpToFpOp>(typeConverter,
+                                                          benefit),
+        computeCapability(computeCapability), nativeFp8(nativeFp8) {}
 
   typedef std::function<SmallVector<Value>(
       Location, ConversionPatternRewriter &, const Value &, const Value &,
@@ -375,15 +474,21 @@ struct FpToFpOpConversion
       auto ctx = rewriter.getContext();
       int inBitwidth = inType.getIntOrFloatBitWidth();
       int outBitwidth = outType.getIntOrFloatBitWidth();
-      // first, we pack `v` into 32-bit ints
+      // first, we pack `v` into 32-bit ints, 32-bit values are passed as is
       int inVecWidth = 32 / inBitwidth;
-      auto inVecTy = vec_ty(inType, inVecWidth);
-      SmallVector<Value> inPacked(4 / inVecWidth, undef(inVecTy));
-      for (size_t i = 0; i < 4; i++)
-        inPacked[i / inVecWidth] = insert_element(
-            inVecTy, inPacked[i / inVecWidth], v[i], i32_val(i % inVecWidth));
-      for (size_t i = 0; i < inPacked.size(); i++)
-        inPacked[i] = bitcast(inPacked[i], i32_ty);
+      SmallVector<Value> inPacked;
+      if (inVecWidth == 1) {
+        inPacked = v;
+      } else {
+        auto inVecTy = vec_ty(inType, inVecWidth);
+        inPacked.assign(4 / inVecWidth, undef(inVecTy));
+        for (size_t i = 0; i < 4; i++)
+          inPacked[i / inVecWidth] =
+              insert_element(inVecTy, inPacked[i / inVecWidth], v[i],
+                             i32_val(i % inVecWidth));
+        for (size_t i = 0; i < inPacked.size(); i++)
+          inPacked[i] = bitcast(inPacked[i], i32_ty);
+      }
 
       // then, we run the provided inline PTX
       int outVecWidth = 32 / outBitwidth;
@@ -396,7 +501,8 @@ struct FpToFpOpConversion
         operands.push_back(builder.newOperand(inVal, "r"));
       auto &ptxOp = *builder.create(ptxAsm);
       ptxOp(operands, /*onlyAttachMLIRArgs=*/true);
-      auto outVecTy = vec_ty(outType, outVecWidth);
+      auto outVecTy =
+          outVecWidth == 1 ? outType : vec_ty(outType, outVecWidth);
       SmallVector<Value> outPacked;
       if (outNums == 1)
         outPacked.push_back(builder.launch(rewriter, loc, outVecTy, false));
@@ -407,6 +513,8 @@ struct FpToFpOpConversion
           outPacked.push_back(extract_val(outVecTy, outStruct, i));
       }
       // unpack the output
+      if (outVecWidth == 1)
+        return outPacked;
       SmallVector<Value> ret;
       for (size_t i = 0; i < 4; i++)
         ret.push_back(extract_element(outType, outPacked[i / outVecWidth],
@@ -427,17 +535,6 @@ struct FpToFpOpConversion
     return builder.launch(rewriter, loc, f32_ty, false);
   }
 
-  static Value convertFp16ToFp32(Location loc,
-                                 ConversionPatternRewriter &rewriter,
-                                 const Value &v) {
-    PTXBuilder builder;
-    auto &cvt = *builder.create("cvt.f32.f16");
-    auto res = builder.newOperand("=r");
-    auto operand = builder.newOperand(v, "h");
-    cvt(res, operand);
-    return builder.launch(rewriter, loc, f32_ty, false);
-  }
-
   static Value convertFp32ToBf16(Location loc,
                                  ConversionPatternRewriter &rewriter,
                                  const Value &v) {
@@ -451,17 +548,6 @@ struct FpToFpOpConversion
     return builder.launch(rewriter, loc, i16_ty, false);
   }
 
-  static Value convertFp32ToFp16(Location loc,
-                                 ConversionPatternRewriter &rewriter,
-                                 const Value &v) {
-    PTXBuilder builder;
-    auto &cvt = *builder.create("cvt.rn.f16.f32");
-    auto res = builder.newOperand("=h");
-    auto operand = builder.newOperand(v, "r");
-    cvt(res, operand);
-    return builder.launch(rewriter, loc, f16_ty, false);
-  }
-
   ConvertorT getConversionFunc(Type srcTy, Type dstTy) const {
     auto F8E4M3B15TyID = TypeID::get<mlir::Float8E4M3B11FNUZType>();
     auto F8E4M3TyID = TypeID::get<mlir::Float8E4M3FNUZType>();
@@ -485,9 +571,38 @@ struct FpToFpOpConversion
         // BF16 -> F8
         {{BF16TyID, F8E4M3TyID}, Bf16_to_Fp8E4M3},
         {{BF16TyID, F8E5M2TyID}, Bf16_to_Fp8E5M2},
+        // F8 -> F32
+        {{F8E4M3B15TyID, F32TyID}, fp8ToFp32ThroughFp16(Fp8E4M3B15_to_Fp16)},
+        {{F8E4M3TyID, F32TyID}, fp8ToFp32ThroughFp16(Fp8E4M3_to_Fp16)},
+        {{F8E5M2TyID, F32TyID}, fp8ToFp32ThroughFp16(Fp8E5M2_to_Fp16)},
+        // F32 -> F8
+        {{F32TyID, F8E4M3B15TyID}, fp32ToFp8ThroughFp16(Fp16_to_Fp8E4M3B15)},
+        {{F32TyID, F8E4M3TyID}, fp32ToFp8ThroughFp16(Fp16_to_Fp8E4M3)},
+        {{F32TyID, F8E5M2TyID}, fp32ToFp8ThroughFp16(Fp16_to_Fp8E5M2)},
+    };
+    // Conversions with native instructions on sm_89+, when requested
+    static DenseMap<std::pair<TypeID, TypeID>, std::string> nativeSrcMap = {
+        // F8 -> F16
+        {{F8E4M3TyID, F16TyID}, nativeFp8ToFp16("e4m3")},
+        {{F8E5M2TyID, F16TyID}, nativeFp8ToFp16("e5m2")},
+        // F16 -> F8
+        {{F16TyID, F8E4M3TyID}, nativeFp16ToFp8("e4m3")},
+        {{F16TyID, F8E5M2TyID}, nativeFp16ToFp8("e5m2")},
+        // F8 -> F32
+        {{F8E4M3TyID, F32TyID},
+         fp8ToFp32ThroughFp16(nativeFp8ToFp16("e4m3"))},
+        {{F8E5M2TyID, F32TyID},
+         fp8ToFp32ThroughFp16(nativeFp8ToFp16("e5m2"))},
+        // F32 -> F8
+        {{F32TyID, F8E4M3TyID}, nativeFp32ToFp8("e4m3")},
+        {{F32TyID, F8E5M2TyID}, nativeFp32ToFp8("e5m2")},
     };
 
     std::pair<TypeID, TypeID> key = {srcTy.getTypeID(), dstTy.getTypeID()};
+    if (nativeFp8 && computeCapability >= 89 && nativeSrcMap.count(key))
+      return makeConverterFromPtx(nativeSrcMap.lookup(key),
+                                  getTypeConverter()->convertType(srcTy),
+                                  getTypeConverter()->convertType(dstTy));
     if (srcMap.count(key) == 0) {
       llvm::errs() << "Unsupported conversion from " << srcTy << " to " << dstTy
                    << "\n";
@@ -507,32 +622,25 @@ struct FpToFpOpConversion
     auto srcElementType = srcTensorType.getElementType();
     auto dstElementType = dstTensorType.getElementType();
     auto loc = op->getLoc();
-    // check that the number of elements is divisible by 4
     // Unpack value
     auto inVals = getTypeConverter()->unpackLLElements(loc, adaptor.getFrom(),
                                                        rewriter, srcTensorType);
     inVals =
         unpackI32(inVals, srcTensorType, rewriter, loc, getTypeConverter());
-    // Cast
+    // Cast, by groups of 4 elements. The tail of the last group is padded and
+    // its results dropped.
     SmallVector<Value> outVals;
     auto elems = inVals.size();
-    assert(elems % 4 == 0 &&
-           "FP8 casting only support tensors with 4-aligned sizes");
-    bool isFP32src = srcElementType.isF32();
-    bool isFP32dst = dstElementType.isF32();
-    auto cvtFunc = getConversionFunc(isFP32src ? f16_ty : srcElementType,
-                                     isFP32dst ? f16_ty : dstElementType);
-    if (isFP32src)
-      for (Value &v : inVals)
-        v = convertFp32ToFp16(loc, rewriter, v);
-    for (size_t i = 0; i < elems; i += 4)
+    auto cvtFunc = getConversionFunc(srcElementType, dstElementType);
+    if (elems % 4 != 0) {
+      Value pad = undef(getTypeConverter()->convertType(srcElementType));
+      inVals.append(4 - elems % 4, pad);
+    }
+    for (size_t i = 0; i < inVals.size(); i += 4)
       outVals.append(cvtFunc(loc, rewriter, inVals[i], inVals[i + 1],
                              inVals[i + 2], inVals[i + 3]));
-    if (isFP32dst)
-      for (Value &v : outVals)
-        v = convertFp16ToFp32(loc, rewriter, v);
+    outVals.resize(elems);
     // Pack values
-    assert(outVals.size() == elems);
     outVals = reorderValues(outVals, srcTensorType, dstTensorType);
     outVals =
         packI32(outVals, dstTensorType, rewriter, loc, getTypeConverter());
@@ -541,6 +649,10 @@ struct FpToFpOpConversion
     rewriter.replaceOp(op, result);
     return success();
   }
+
+private:
+  int computeCapability;
+  bool nativeFp8;
 };
 
 template <typename SourceOp, typename ConcreteT>
@@ -576,13 +688,35 @@ public:
     }
     if (allOperands.size() == 0)
       allOperands.push_back({});
-    for (const SmallVector<Value> &operands : allOperands) {
-      Value curr =
-          ((ConcreteT *)(this))
-              ->createDestOp(op, adaptor, rewriter, elemTy, operands, loc);
-      if (!bool(curr))
-        return failure();
-      resultVals.push_back(curr);
+    if (hasAdjacentPairs(op, allOperands.size()) &&
+        ((ConcreteT *)(this))->isPackable(op, elemTy)) {
+      // Compute two elements at once on f16x2/bf16x2 registers
+      auto vecTy = vec_ty(elemTy, 2);
+      for (size_t i = 0; i < allOperands.size(); i += 2) {
+        SmallVector<Value> operands;
+        for (size_t j = 0; j < allOperands[i].size(); ++j) {
+          Value vec = undef(vecTy);
+          vec = insert_element(vecTy, vec, allOperands[i][j], i32_val(0));
+          vec = insert_element(vecTy, vec, allOperands[i + 1][j], i32_val(1));
+          operands.push_back(vec);
+        }
+        Value curr = ((ConcreteT *)(this))
+                         ->createPackedDestOp(op, adaptor, rewriter, vecTy,
+                                              operands, loc);
+        if (!bool(curr))
+          return failure();
+        resultVals.push_back(extract_element(elemTy, curr, i32_val(0)));
+        resultVals.push_back(extract_element(elemTy, curr, i32_val(1)));
+      }
+    } else {
+      for (const SmallVector<Value> &operands : allOperands) {
+        Value curr =
+            ((ConcreteT *)(this))
+                ->createDestOp(op, adaptor, rewriter, elemTy, operands, loc);
+        if (!bool(curr))
+          return failure();
+        resultVals.push_back(curr);
+      }
     }
     if (op->getNumOperands() > 0) {
       auto argTy = op->getOperand(0).getType();
@@ -596,6 +730,41 @@ public:
 
     return success();
   }
+
+  // Patterns that have a packed form override these to lower pairs of
+  // elements, given as vectors of two, with one instruction.
+  bool isPackable(SourceOp op, Type elemTy) const { return false; }
+
+  Value createPackedDestOp(SourceOp op, OpAdaptor adaptor,
+                           ConversionPatternRewriter &rewriter, Type vecTy,
+                           ValueRange operands, Location loc) const {
+    return {};
+  }
+
+private:
+  // Whether `op` computes f16 or bf16 values whose per-thread elements are
+  // contiguous by pairs in its layout, so that each pair already sits in one
+  // 32-bit register.
+  static bool hasAdjacentPairs(SourceOp op, size_t numElems) {
+    if (op->getNumOperands() == 0 || numElems % 2 != 0)
+      return false;
+    auto tensorTy = op.getType().template dyn_cast<RankedTensorType>();
+    if (!tensorTy)
+      return false;
+    Type elemTy = tensorTy.getElementType();
+    if (!elemTy.isF16() && !elemTy.isBF16())
+      return false;
+    for (Value operand : op->getOperands())
+      if (operand.getType() != tensorTy)
+        return false;
+    Attribute layout = tensorTy.getEncoding();
+    if (!layout ||
+        !layout.isa<BlockedEncodingAttr, MmaEncodingAttr, SliceEncodingAttr>())
+      return false;
+    auto contigPerThread =
+        getUniqueContigPerThread(layout, tensorTy.getShape());
+    return contigPerThread[getOrder(layout)[0]] % 2 == 0;
+  }
 };
 
 template <typename SourceOp, typename DestOp>
@@ -620,6 +789,18 @@ struct ElementwiseOpConversion
     return rewriter.create<DestOp>(loc, elemTy, operands,
                                    adaptor.getAttributes().getValue());
   }
+
+  // min/max of f16 vectors select min.f16x2/max.f16x2
+  bool isPackable(SourceOp op, Type elemTy) const {
+    return elemTy.isF16() && (std::is_same_v<DestOp, LLVM::MinNumOp> ||
+                              std::is_same_v<DestOp, LLVM::MaxNumOp>);
+  }
+
+  Value createPackedDestOp(SourceOp op, OpAdaptor adaptor,
+                           ConversionPatternRewriter &rewriter, Type vecTy,
+                           ValueRange operands, Location loc) const {
+    return createDestOp(op, adaptor, rewriter, vecTy, operands, loc);
+  }
 };
 
 struct CmpIOpConversion
@@ -789,6 +970,18 @@ struct FDivOpConversion
   }
 };
 
+/// Apply `ptxAsm` to pairs of bf16 values, each held in one 32-bit register
+static Value packedBf16Op(ConversionPatternRewriter &rewriter, Location loc,
+                          const char *ptxAsm, Type vecTy, ValueRange operands) {
+  PTXBuilder builder;
+  auto &op = *builder.create<PTXInstr>(ptxAsm);
+  auto res = builder.newOperand("=r");
+  auto lhs = builder.newOperand(bitcast(operands[0], i32_ty), "r");
+  auto rhs = builder.newOperand(bitcast(operands[1], i32_ty), "r");
+  op({res, lhs, rhs}, /*onlyAttachMLIRArgs=*/true);
+  return bitcast(builder.launch(rewriter, loc, i32_ty, false), vecTy);
+}
+
 struct FMulOpConversion
     : ElementwiseOpConversionBase<mlir::arith::MulFOp, FMulOpConversion> {
   using Base =
@@ -817,6 +1010,20 @@ struct FMulOpConversion
                                            operands[1]);
     }
   }
+
+  bool isPackable(mlir::arith::MulFOp op, Type elemTy) const { return true; }
+
+  Value createPackedDestOp(mlir::arith::MulFOp op, OpAdaptor adaptor,
+                           ConversionPatternRewriter &rewriter, Type vecTy,
+                           ValueRange operands, Location loc) const {
+    if (getElementTypeOrSelf(op.getType()).isBF16()) {
+      auto ptxAsm = " { .reg .b32 c;            \n"
+                    "    mov.b32 c, 0x80008000U; \n" // (-0.0, -0.0)
+                    "    fma.rn.bf16x2 $0, $1, $2, c; } \n";
+      return packedBf16Op(rewriter, loc, ptxAsm, vecTy, operands);
+    }
+    return rewriter.create<LLVM::FMulOp>(loc, vecTy, operands[0], operands[1]);
+  }
 };
 
 struct FAddOpConversion
@@ -847,6 +1054,20 @@ struct FAddOpConversion
                                            operands[1]);
     }
   }
+
+  bool isPackable(mlir::arith::AddFOp op, Type elemTy) const { return true; }
+
+  Value createPackedDestOp(mlir::arith::AddFOp op, OpAdaptor adaptor,
+                           ConversionPatternRewriter &rewriter, Type vecTy,
+                           ValueRange operands, Location loc) const {
+    if (getElementTypeOrSelf(op.getType()).isBF16()) {
+      auto ptxAsm = "{ .reg .b32 c;             \n"
+                    "   mov.b32 c, 0x3f803f80U; \n" // (1.0, 1.0)
+                    "   fma.rn.bf16x2 $0, $1, c, $2; } \n";
+      return packedBf16Op(rewriter, loc, ptxAsm, vecTy, operands);
+    }
+    return rewriter.create<LLVM::FAddOp>(loc, vecTy, operands[0], operands[1]);
+  }
 };
 
 struct FSubOpConversion
@@ -877,6 +1098,20 @@ struct FSubOpConversion
                                            operands[1]);
     }
   }
+
+  bool isPackable(mlir::arith::SubFOp op, Type elemTy) const { return true; }
+
+  Value createPackedDestOp(mlir::arith::SubFOp op, OpAdaptor adaptor,
+                           ConversionPatternRewriter &rewriter, Type vecTy,
+                           ValueRange operands, Location loc) const {
+    if (getElementTypeOrSelf(op.getType()).isBF16()) {
+      auto ptxAsm = " { .reg .b32 c;            \n"
+                    "    mov.b32 c, 0xbf80bf80U; \n" // (-1.0, -1.0)
+                    "    fma.rn.bf16x2 $0, $2, c, $1; } \n";
+      return packedBf16Op(rewriter, loc, ptxAsm, vecTy, operands);
+    }
+    return rewriter.create<LLVM::FSubOp>(loc, vecTy, operands[0], operands[1]);
+  }
 };
 
 struct SIToFPOpConversion
@@ -1061,7 +1296,7 @@ struct IndexCastOpLowering
 
 void populateElementwiseOpToLLVMPatterns(
     TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
-    PatternBenefit benefit) {
+    int computeCapability, bool nativeFp8, PatternBenefit benefit) {
 #define POPULATE_TERNARY_OP(SRC_OP, DST_OP)                                    \
   patterns.add<ElementwiseOpConversion<SRC_OP, DST_OP>>(typeConverter, benefit);
   POPULATE_TERNARY_OP(triton::gpu::SelectOp, LLVM::SelectOp)
@@ -1085,6 +1320,7 @@ void populateElementwiseOpToLLVMPatterns(
   POPULATE_BINARY_OP(arith::ShRSIOp, LLVM::AShrOp)  // >>
   POPULATE_BINARY_OP(arith::ShRUIOp, LLVM::LShrOp)  // >>
   POPULATE_BINARY_OP(arith::MinFOp, LLVM::MinNumOp) // fmin
+  POPULATE_BINARY_OP(arith::MaxFOp, LLVM::MaxNumOp) // fmax
   POPULATE_BINARY_OP(arith::MinSIOp, LLVM::SMinOp)  // smin
 #undef POPULATE_BINARY_OP
 
@@ -1121,7 +1357,8 @@ void populateElementwiseOpToLLVMPatterns(
   patterns.add<SIToFPOpConversion>(typeConverter, benefit);
   patterns.add<IndexCastOpLowering>(typeConverter, benefit);
 
-  patterns.add<FpToFpOpConversion>(typeConverter, benefit);
+  patterns.add<FpToFpOpConversion>(typeConverter, computeCapability, nativeFp8,
+                                   benefit);
 
   patterns.add<ExternElementwiseOpConversion<triton::PureExternElementwiseOp>>(
       typeConverter, benefit);
@@ -8,7 +8,7 @@ using namespace mlir::triton;
 
 void populateElementwiseOpToLLVMPatterns(
     TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
-    PatternBenefit benefit);
+    int computeCapability, bool nativeFp8, PatternBenefit benefit);
 
 bool isLegalElementwiseOp(Operation *op);
 
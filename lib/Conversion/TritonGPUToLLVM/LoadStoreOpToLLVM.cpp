@@ -1,9 +1,13 @@
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/ControlFlowInterfaces.h"
+#include "llvm/ADT/ScopeExit.h"
 
 #include "ConvertLayoutOpToLLVM.h"
 #include "LoadStoreOpToLLVM.h"
 
+#include <map>
+
 using namespace mlir;
 using namespace mlir::triton;
 
@@ -11,6 +15,146 @@ using ::mlir::LLVM::getSharedMemoryObjectFromStruct;
 using ::mlir::triton::gpu::getTotalElemsPerThread;
 using ::mlir::triton::gpu::SharedEncodingAttr;
 
+// Per-dimension coefficients of the offsets of a tensor, in elements. The
+// offsets are the sum of a term uniform across the tensor and of one term per
+// dimension that only depends on the coordinate along that dimension. That
+// term is linear with the given coefficient, or unknown if there is none.
+using OffsetCoefficients = SmallVector<std::optional<int64_t>>;
+
+static std::optional<int64_t> getSplatConstant(Value v) {
+  DenseElementsAttr constAttr;
+  if (matchPattern(v, m_Constant(&constAttr)) && constAttr.isSplat() &&
+      constAttr.getElementType().isa<IntegerType>())
+    return constAttr.getSplatValue<APInt>().getSExtValue();
+  APInt value;
+  if (auto splatOp = v.getDefiningOp<triton::SplatOp>())
+    if (matchPattern(splatOp.getSrc(), m_ConstantInt(&value)))
+      return value.getSExtValue();
+  return std::nullopt;
+}
+
+static std::optional<OffsetCoefficients>
+getOffsetCoefficientsImpl(Value v, DenseSet<Value> &visiting) {
+  auto tensorTy = v.getType().dyn_cast<RankedTensorType>();
+  if (!tensorTy)
+    return std::nullopt;
+  unsigned rank = tensorTy.getRank();
+  OffsetCoefficients uniform(rank, 0);
+  // Any tensor of a single dimension decomposes
+  auto unknown = [&]() -> std::optional<OffsetCoefficients> {
+    if (rank == 1)
+      return OffsetCoefficients(rank, std::nullopt);
+    return std::nullopt;
+  };
+
+  if (auto blockArg = v.dyn_cast<BlockArgument>()) {
+    // Pointers advanced by a uniform amount on every back edge of a loop keep
+    // the coefficients of their initial value. Once scf is lowered, such a
+    // pointer is an argument of the loop header, and the back edges are the
+    // incoming values built from an argument that is being visited.
+    Block *block = blockArg.getOwner();
+    if (block->isEntryBlock() || !visiting.insert(v).second)
+      return unknown();
+    auto guard = llvm::make_scope_exit([&]() { visiting.erase(v); });
+    std::optional<OffsetCoefficients> coeffs;
+    for (auto it = block->pred_begin(); it != block->pred_end(); ++it) {
+      auto branch = dyn_cast<BranchOpInterface>((*it)->getTerminator());
+      if (!branch)
+        return unknown();
+      Value incoming = branch.getSuccessorOperands(
+          it.getSuccessorIndex())[blockArg.getArgNumber()];
+      if (!incoming)
+        return unknown();
+      if (visiting.contains(incoming))
+        continue;
+      if (auto addPtr = incoming.getDefiningOp<triton::AddPtrOp>())
+        if (visiting.contains(addPtr.getPtr()) &&
+            getOffsetCoefficientsImpl(addPtr.getOffset(), visiting) == uniform)
+          continue;
+      auto incomingCoeffs = getOffsetCoefficientsImpl(incoming, visiting);
+      if (!incomingCoeffs || (coeffs && *coeffs != *incomingCoeffs))
+        return unknown();
+      coeffs = incomingCoeffs;
+    }
+    if (!coeffs)
+      return unknown();
+    return coeffs;
+  }
+
+  Operation *op = v.getDefiningOp();
+  if (isa<triton::SplatOp>(op) || getSplatConstant(v))
+    return uniform;
+  if (isa<triton::MakeRangeOp>(op))
+    return OffsetCoefficients{1};
+  if (isa<triton::gpu::ConvertLayoutOp, arith::ExtSIOp>(op))
+    return getOffsetCoefficientsImpl(op->getOperand(0), visiting);
+  if (auto expandDims = dyn_cast<triton::ExpandDimsOp>(op)) {
+    auto coeffs = getOffsetCoefficientsImpl(expandDims.getSrc(), visiting);
+    if (!coeffs)
+      return unknown();
+    coeffs->insert(coeffs->begin() + expandDims.getAxis(),
+                   std::optional<int64_t>(0));
+    return coeffs;
+  }
+  if (auto broadcast = dyn_cast<triton::BroadcastOp>(op)) {
+    auto coeffs = getOffsetCoefficientsImpl(broadcast.getSrc(), visiting);
+    if (!coeffs)
+      return unknown();
+    auto srcShape =
+        broadcast.getSrc().getType().cast<RankedTensorType>().getShape();
+    for (unsigned d = 0; d < rank; ++d)
+      if (srcShape[d] == 1)
+        (*coeffs)[d] = 0;
+    return coeffs;
+  }
+  if (isa<triton::AddPtrOp, arith::AddIOp, arith::SubIOp>(op)) {
+    auto lhs = getOffsetCoefficientsImpl(op->getOperand(0), visiting);
+    auto rhs = getOffsetCoefficientsImpl(op->getOperand(1), visiting);
+    if (!lhs || !rhs)
+      return unknown();
+    OffsetCoefficients coeffs(rank);
+    for (unsigned d = 0; d < rank; ++d)
+      if ((*lhs)[d] && (*rhs)[d])
+        coeffs[d] = isa<arith::SubIOp>(op) ? *(*lhs)[d] - *(*rhs)[d]
+                                           : *(*lhs)[d] + *(*rhs)[d];
+    return coeffs;
+  }
+  if (isa<arith::MulIOp, arith::ShLIOp>(op)) {
+    // x * f, f * x and x << f, with a uniform factor f
+    unsigned factorIdx = isa<arith::MulIOp>(op) &&
+                                 getOffsetCoefficientsImpl(
+                                     op->getOperand(0), visiting) == uniform
+                             ? 0
+                             : 1;
+    Value factor = op->getOperand(factorIdx);
+    if (getOffsetCoefficientsImpl(factor, visiting) != uniform)
+      return unknown();
+    auto coeffs =
+        getOffsetCoefficientsImpl(op->getOperand(1 - factorIdx), visiting);
+    if (!coeffs)
+      return unknown();
+    std::optional<int64_t> factorVal = getSplatConstant(factor);
+    for (auto &coeff : *coeffs) {
+      if (!coeff || *coeff == 0)
+        continue;
+      if (!factorVal)
+        coeff = std::nullopt;
+      else
+        coeff = isa<arith::MulIOp>(op) ? *coeff * *factorVal
+                                       : *coeff << *factorVal;
+    }
+    return coeffs;
+  }
+  return unknown();
+}
+
+// The offset coefficients of the pointer or integer tensor `v`, or none if its
+// offsets do not decompose per dimension
+static std::optional<OffsetCoefficients> getOffsetCoefficients(Value v) {
+  DenseSet<Value> visiting;
+  return getOffsetCoefficientsImpl(v, visiting);
+}
+
 // Contains some helper functions for both Load and Store conversions.
 struct LoadStoreConversionBase {
   explicit LoadStoreConversionBase(ModuleAxisInfoAnalysis &axisAnalysisPass)
@@ -37,21 +181,122 @@ struct LoadStoreConversionBase {
     return axisAnalysisPass.getMaskAlignment(mask);
   }
 
+  // The element each vector of `vec` elements of `ptr` is addressed from and
+  // its byte offset from the pointer of that element. Vectors whose pointers
+  // differ by compile-time constants share the address register of the one
+  // with the lowest address, and are accessed at an immediate offset from it.
+  // `elemOffsets` are the offsets of the elements of a thread in the tensor.
+  SmallVector<std::pair<unsigned, int64_t>>
+  getAddressBases(Value ptr, unsigned numElems,
+                  ArrayRef<SmallVector<unsigned>> elemOffsets,
+                  unsigned vec) const {
+    SmallVector<std::pair<unsigned, int64_t>> bases;
+    for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx)
+      bases.emplace_back(elemIdx, 0);
+    auto tensorTy = ptr.getType().dyn_cast<RankedTensorType>();
+    if (!tensorTy)
+      return bases;
+    std::optional<OffsetCoefficients> coeffs = getOffsetCoefficients(ptr);
+    if (!coeffs)
+      return bases;
+    assert(elemOffsets.size() == numElems);
+    int64_t elemBytes =
+        std::max<int64_t>(1, triton::getPointeeBitWidth(tensorTy) / 8);
+    auto getByteOffset = [&](unsigned elemIdx) {
+      int64_t offset = 0;
+      for (auto [d, coeff] : llvm::enumerate(*coeffs))
+        if (coeff)
+          offset += *coeff * elemOffsets[elemIdx][d];
+      return offset * elemBytes;
+    };
+
+    // Vectors are at constant distances from each other if they have the
+    // same coordinates along the dimensions of unknown coefficient
+    std::map<SmallVector<unsigned>, SmallVector<unsigned>> groups;
+    for (unsigned vecStart = 0; vecStart < numElems; vecStart += vec) {
+      SmallVector<unsigned> key;
+      for (auto [d, coeff] : llvm::enumerate(*coeffs))
+        if (!coeff)
+          key.push_back(elemOffsets[vecStart][d]);
+      groups[key].push_back(vecStart);
+    }
+    for (auto &[key, vecStarts] : groups) {
+      unsigned base =
+          *llvm::min_element(vecStarts, [&](unsigned a, unsigned b) {
+            return getByteOffset(a) < getByteOffset(b);
+          });
+      for (unsigned vecStart : vecStarts) {
+        int64_t offset = getByteOffset(vecStart) - getByteOffset(base);
+        if (offset <= std::numeric_limits<int32_t>::max())
+          bases[vecStart] = {base, offset};
+      }
+    }
+    return bases;
+  }
+
 protected:
   ModuleAxisInfoAnalysis &axisAnalysisPass;
 };
 
+// Cache operators of global loads and stores. The PTX forms with a cache
+// operator and with an L1 eviction priority are exclusive, so the L1
+// eviction priority is only used when no cache operator is given.
+static bool isLoadCacheOperator(triton::CacheModifier cache) {
+  return cache == triton::CacheModifier::CA ||
+         cache == triton::CacheModifier::CG ||
+         cache == triton::CacheModifier::CS;
+}
+
+static bool isStoreCacheOperator(triton::CacheModifier cache) {
+  return cache == triton::CacheModifier::WB ||
+         cache == triton::CacheModifier::CG ||
+         cache == triton::CacheModifier::CS ||
+         cache == triton::CacheModifier::WT;
+}
+
+// L1 eviction priorities are supported from sm_70
+static bool hasL1EvictPriority(triton::EvictionPolicy evict,
+                               int computeCapability) {
+  return computeCapability >= 70 && evict != triton::EvictionPolicy::NORMAL;
+}
+
+// Creates the L2 cache policy passed to the cache hint of global loads and
+// stores, or returns a null value if there is nothing to hint or the target
+// lacks createpolicy (sm_80+).
+static Value createL2CachePolicy(triton::EvictionPolicy evict,
+                                 int computeCapability,
+                                 ConversionPatternRewriter &rewriter,
+                                 Location loc) {
+  if (computeCapability < 80 || evict == triton::EvictionPolicy::NORMAL)
+    return Value();
+  PTXBuilder ptxBuilder;
+  auto &createPolicy =
+      ptxBuilder.create<>("createpolicy")
+          ->o("fractional")
+          .o("L2::evict_first", evict == triton::EvictionPolicy::EVICT_FIRST)
+          .o("L2::evict_last", evict == triton::EvictionPolicy::EVICT_LAST)
+          .b(64);
+  // The policy applies to the whole of the accessed lines
+  createPolicy(ptxBuilder.newOperand("=l"),
+               ptxBuilder.newConstantOperand("1.0"));
+  return ptxBuilder.launch(rewriter, loc, i64_ty, /*hasSideEffect=*/false);
+}
+
 struct LoadOpConversion
     : public ConvertTritonGPUOpToLLVMPattern<triton::LoadOp>,
       public LoadStoreConversionBase {
   using ConvertTritonGPUOpToLLVMPattern<
       triton::LoadOp>::ConvertTritonGPUOpToLLVMPattern;
 
-  LoadOpConversion(TritonGPUToLLVMTypeConverter &converter,
-                   ModuleAxisInfoAnalysis &axisAnalysisPass,
-                   PatternBenefit benefit)
-      : ConvertTritonGPUOpToLLVMPattern<triton::LoadOp>(converter, benefit),
-        LoadStoreConversionBase(axisAnalysisPass) {}
+  LoadOpConversion(
+      TritonGPUToLLVMTypeConverter &converter,
+      ConvertTritonGPUOpToLLVMPatternBase::IndexCacheInfo &indexCacheInfo,
+      ModuleAxisInfoAnalysis &axisAnalysisPass, int computeCapability,
+      PatternBenefit benefit)
+      : ConvertTritonGPUOpToLLVMPattern<triton::LoadOp>(
+            converter, indexCacheInfo, benefit),
+        LoadStoreConversionBase(axisAnalysisPass),
+        computeCapability(computeCapability) {}
 
   LogicalResult
   matchAndRewrite(triton::LoadOp op, OpAdaptor adaptor,
@@ -108,6 +353,23 @@ struct LoadOpConversion
                                                         other.getType());
     }
 
+    // Volatile loads take neither cache operators nor cache hints
+    const bool isVolatile = op.getIsVolatile();
+    const triton::CacheModifier cache = op.getCache();
+    const triton::EvictionPolicy evict = op.getEvict();
+    const bool hasCacheOperator = !isVolatile && isLoadCacheOperator(cache);
+    const bool hasL1Evict = !isVolatile && !hasCacheOperator &&
+                            hasL1EvictPriority(evict, computeCapability);
+    Value l2Policy;
+    if (!isVolatile)
+      l2Policy = createL2CachePolicy(evict, computeCapability, rewriter, loc);
+
+    // Vectors at constant distances from each other share an address
+    SmallVector<SmallVector<unsigned>> elemOffsets;
+    if (auto ptrTy = ptr.getType().dyn_cast<RankedTensorType>())
+      elemOffsets = emitOffsetForLayout(ptrTy.getEncoding(), ptrTy);
+    auto addressBases = getAddressBases(ptr, numElems, elemOffsets, vec);
+
     // vectorized iteration through all the pointer/mask/other elements
     const int valueElemNBits =
         std::max(8u, valueElemTy.getIntOrFloatBitWidth());
@@ -115,8 +377,7 @@ struct LoadOpConversion
 
     SmallVector<Value> loadedVals;
     for (size_t vecStart = 0; vecStart < numElems; vecStart += vec) {
-      // TODO: optimization when ptr is GEP with constant offset
-      size_t in_off = 0;
+      auto [baseIdx, in_off] = addressBases[vecStart];
 
       const size_t maxWordWidth = std::max<size_t>(32, valueElemNBits);
       const size_t totalWidth = valueElemNBits * vec;
@@ -126,10 +387,6 @@ struct LoadOpConversion
       const size_t movWidth = width < 16 ? 16 : width;
       assert(wordNElems * nWords * numVecs == numElems);
 
-      // TODO(Superjomn) Add cache policy fields to StoreOp.
-      // TODO(Superjomn) Deal with cache policy here.
-      const bool hasL2EvictPolicy = false;
-
       PTXBuilder ptxBuilder;
 
       Value pred = mask ? maskElems[vecStart] : int_val(1, 1);
@@ -148,32 +405,29 @@ struct LoadOpConversion
       }
 
       auto *addrOpr =
-          ptxBuilder.newAddrOperand(ptrElems[vecStart], "l", in_off);
+          ptxBuilder.newAddrOperand(ptrElems[baseIdx], "l", in_off);
 
       // Define the instruction opcode
-      auto &ld = ptxBuilder.create<>("ld")
-                     ->o("volatile", op.getIsVolatile())
-                     .global()
-                     .o("ca", op.getCache() == triton::CacheModifier::CA)
-                     .o("cg", op.getCache() == triton::CacheModifier::CG)
-                     .o("L1::evict_first",
-                        op.getEvict() == triton::EvictionPolicy::EVICT_FIRST)
-                     .o("L1::evict_last",
-                        op.getEvict() == triton::EvictionPolicy::EVICT_LAST)
-                     .o("L1::cache_hint", hasL2EvictPolicy)
-                     .v(nWords)
-                     .b(width);
-
-      PTXBuilder::Operand *evictOpr{};
-
-      // Here lack a mlir::Value to bind to this operation, so disabled.
-      // if (has_l2_evict_policy)
-      //   evictOpr = ptxBuilder.newOperand(l2Evict, "l");
-
-      if (!evictOpr)
+      auto &ld =
+          ptxBuilder.create<>("ld")
+              ->o("volatile", isVolatile)
+              .global()
+              .o("ca", hasCacheOperator && cache == triton::CacheModifier::CA)
+              .o("cg", hasCacheOperator && cache == triton::CacheModifier::CG)
+              .o("cs", hasCacheOperator && cache == triton::CacheModifier::CS)
+              .o("L1::evict_first",
+                 hasL1Evict && evict == triton::EvictionPolicy::EVICT_FIRST)
+              .o("L1::evict_last",
+                 hasL1Evict && evict == triton::EvictionPolicy::EVICT_LAST)
+              .o("L2::cache_hint", static_cast<bool>(l2Policy))
+              .v(nWords)
+              .b(width);
+
+      if (!l2Policy)
         ld(dstsOpr, addrOpr).predicate(pred, "b");
       else
-        ld(dstsOpr, addrOpr, evictOpr).predicate(pred, "b");
+        ld(dstsOpr, addrOpr, ptxBuilder.newOperand(l2Policy, "l"))
+            .predicate(pred, "b");
 
       if (other) {
         for (size_t ii = 0; ii < nWords; ++ii) {
@@ -212,10 +466,6 @@ struct LoadOpConversion
                        ? LLVM::LLVMStructType::getLiteral(getContext(), retTys)
                        : retTys[0];
 
-      // TODO: if (has_l2_evict_policy)
-      // auto asmDialectAttr =
-      // LLVM::AsmDialectAttr::get(rewriter.getContext(),
-      //                                                 LLVM::AsmDialect::AD_ATT);
       Value ret = ptxBuilder.launch(rewriter, loc, retTy);
 
       // Extract and store return values
@@ -246,6 +496,9 @@ struct LoadOpConversion
     rewriter.replaceOp(op, {resultStruct});
     return success();
   }
+
+private:
+  int computeCapability;
 };
 
 struct StoreOpConversion
@@ -254,11 +507,15 @@ struct StoreOpConversion
   using ConvertTritonGPUOpToLLVMPattern<
       triton::StoreOp>::ConvertTritonGPUOpToLLVMPattern;
 
-  StoreOpConversion(TritonGPUToLLVMTypeConverter &converter,
-                    ModuleAxisInfoAnalysis &axisAnalysisPass,
-                    PatternBenefit benefit)
-      : ConvertTritonGPUOpToLLVMPattern<triton::StoreOp>(converter, benefit),
-        LoadStoreConversionBase(axisAnalysisPass) {}
+  StoreOpConversion(
+      TritonGPUToLLVMTypeConverter &converter,
+      ConvertTritonGPUOpToLLVMPatternBase::IndexCacheInfo &indexCacheInfo,
+      ModuleAxisInfoAnalysis &axisAnalysisPass, int computeCapability,
+      PatternBenefit benefit)
+      : ConvertTritonGPUOpToLLVMPattern<triton::StoreOp>(
+            converter, indexCacheInfo, benefit),
+        LoadStoreConversionBase(axisAnalysisPass),
+        computeCapability(computeCapability) {}
 
   LogicalResult
   matchAndRewrite(triton::StoreOp op, OpAdaptor adaptor,
@@ -303,10 +560,24 @@ struct StoreOpConversion
         std::max<int>(1, valueElemTy.getIntOrFloatBitWidth() / 8);
     const size_t valueElemNBits = dtsize * 8;
 
+    const triton::CacheModifier cache = op.getCache();
+    const triton::EvictionPolicy evict = op.getEvict();
+    const bool hasCacheOperator = isStoreCacheOperator(cache);
+    const bool hasL1Evict =
+        !hasCacheOperator && hasL1EvictPriority(evict, computeCapability);
+    Value l2Policy =
+        createL2CachePolicy(evict, computeCapability, rewriter, loc);
+
+    // Vectors at constant distances from each other share an address
+    SmallVector<SmallVector<unsigned>> elemOffsets;
+    if (auto ptrTy = ptr.getType().dyn_cast<RankedTensorType>())
+      elemOffsets = emitOffsetForLayout(ptrTy.getEncoding(), ptrTy);
+    auto addressBases =
+        getAddressBases(ptr, elemsPerThread, elemOffsets, vec);
+
     const int numVecs = elemsPerThread / vec;
     for (size_t vecStart = 0; vecStart < elemsPerThread; vecStart += vec) {
-      // TODO: optimization when ptr is AddPtr with constant offset
-      size_t in_off = 0;
+      auto [baseIdx, in_off] = addressBases[vecStart];
 
       const size_t maxWordWidth = std::max<size_t>(32, valueElemNBits);
       const size_t totalWidth = valueElemNBits * vec;
@@ -315,9 +586,6 @@ struct StoreOpConversion
       const size_t wordNElems = width / valueElemNBits;
       assert(wordNElems * nWords * numVecs == elemsPerThread);
 
-      // TODO(Superjomn) Add cache policy fields to StoreOp.
-      // TODO(Superjomn) Deal with cache policy here.
-
       Type valArgTy = IntegerType::get(ctx, width);
       auto wordTy = vec_ty(valueElemTy, wordNElems);
 
@@ -349,22 +617,28 @@ struct StoreOpConversion
       Value maskVal = llMask ? and_(mask, maskElems[vecStart]) : mask;
 
       auto *asmAddr =
-          ptxBuilder.newAddrOperand(ptrElems[vecStart], "l", in_off);
+          ptxBuilder.newAddrOperand(ptrElems[baseIdx], "l", in_off);
 
       auto &ptxStoreInstr =
           ptxBuilder.create<>("st")
               ->global()
-              .o("wb", op.getCache() == triton::CacheModifier::WB)
-              .o("cg", op.getCache() == triton::CacheModifier::CG)
-              .o("cs", op.getCache() == triton::CacheModifier::CS)
-              .o("wt", op.getCache() == triton::CacheModifier::WT)
+              .o("wb", hasCacheOperator && cache == triton::CacheModifier::WB)
+              .o("cg", hasCacheOperator && cache == triton::CacheModifier::CG)
+              .o("cs", hasCacheOperator && cache == triton::CacheModifier::CS)
+              .o("wt", hasCacheOperator && cache == triton::CacheModifier::WT)
               .o("L1::evict_first",
-                 op.getEvict() == triton::EvictionPolicy::EVICT_FIRST)
+                 hasL1Evict && evict == triton::EvictionPolicy::EVICT_FIRST)
               .o("L1::evict_last",
-                 op.getEvict() == triton::EvictionPolicy::EVICT_LAST)
+                 hasL1Evict && evict == triton::EvictionPolicy::EVICT_LAST)
+              .o("L2::cache_hint", static_cast<bool>(l2Policy))
               .v(nWords)
               .b(width);
-      ptxStoreInstr(asmAddr, asmArgList).predicate(maskVal, "b");
+      if (!l2Policy)
+        ptxStoreInstr(asmAddr, asmArgList).predicate(maskVal, "b");
+      else
+        ptxStoreInstr(asmAddr, asmArgList,
+                      ptxBuilder.newOperand(l2Policy, "l"))
+            .predicate(maskVal, "b");
 
       Type boolTy = getTypeConverter()->convertType(rewriter.getIntegerType(1));
       llvm::SmallVector<Type> argTys({boolTy, ptr.getType()});
@@ -377,6 +651,9 @@ struct StoreOpConversion
     rewriter.eraseOp(op);
     return success();
   }
+
+private:
+  int computeCapability;
 };
 
 struct AtomicCASOpConversion
@@ -385,12 +662,12 @@ struct AtomicCASOpConversion
   using ConvertTritonGPUOpToLLVMPattern<
       triton::AtomicCASOp>::ConvertTritonGPUOpToLLVMPattern;
 
-  AtomicCASOpConversion(TritonGPUToLLVMTypeConverter &converter,
-                        ModuleAllocation &allocation,
-                        ModuleAxisInfoAnalysis &axisAnalysisPass,
-                        PatternBenefit benefit)
+  AtomicCASOpConversion(
+      TritonGPUToLLVMTypeConverter &converter, ModuleAllocation &allocation,
+      ConvertTritonGPUOpToLLVMPatternBase::IndexCacheInfo &indexCacheInfo,
+      ModuleAxisInfoAnalysis &axisAnalysisPass, PatternBenefit benefit)
       : ConvertTritonGPUOpToLLVMPattern<triton::AtomicCASOp>(
-            converter, allocation, benefit),
+            converter, allocation, indexCacheInfo, benefit),
         LoadStoreConversionBase(axisAnalysisPass) {}
 
   LogicalResult
@@ -460,12 +737,12 @@ struct AtomicRMWOpConversion
   using ConvertTritonGPUOpToLLVMPattern<
       triton::AtomicRMWOp>::ConvertTritonGPUOpToLLVMPattern;
 
-  AtomicRMWOpConversion(TritonGPUToLLVMTypeConverter &converter,
-                        ModuleAllocation &allocation,
-                        ModuleAxisInfoAnalysis &axisAnalysisPass,
-                        PatternBenefit benefit)
+  AtomicRMWOpConversion(
+      TritonGPUToLLVMTypeConverter &converter, ModuleAllocation &allocation,
+      ConvertTritonGPUOpToLLVMPatternBase::IndexCacheInfo &indexCacheInfo,
+      ModuleAxisInfoAnalysis &axisAnalysisPass, PatternBenefit benefit)
       : ConvertTritonGPUOpToLLVMPattern<triton::AtomicRMWOp>(
-            converter, allocation, benefit),
+            converter, allocation, indexCacheInfo, benefit),
         LoadStoreConversionBase(axisAnalysisPass) {}
 
   LogicalResult
@@ -766,12 +1043,14 @@ struct InsertSliceAsyncOpConversion
     }
 
     // %other
+    // cp.async can only fill masked-off elements with zeros. Any other value,
+    // -0.0 included, is written with a regular shared store to the words
+    // whose copy is predicated off, so that it cannot race with the
+    // asynchronous copy.
     SmallVector<Value> otherElems;
+    bool otherIsZero = !other || matchPattern(other, m_Zero()) ||
+                       matchPattern(other, m_PosZeroFloat());
     if (llOther) {
-      // FIXME(Keren): always assume other is 0 for now
-      // It's not necessary for now because the pipeline pass will skip
-      // generating insert_slice_async if the load op has any "other" tensor.
-      // assert(false && "insert_slice_async: Other value not supported yet");
       otherElems = getTypeConverter()->unpackLLElements(loc, llOther, rewriter,
                                                         other.getType());
       assert(srcElems.size() == otherElems.size());
@@ -833,35 +1112,79 @@ struct InsertSliceAsyncOpConversion
             ptxBuilder.newAddrOperand(srcElems[elemIdx + wordElemIdx], "l");
         auto *copySize = ptxBuilder.newConstantOperand(byteWidth);
         auto *srcSize = copySize;
-        if (op.getMask()) {
+        if (op.getMask() && otherIsZero) {
           // We don't use predicate in this case, setting src-size to 0
           // if there's any mask. cp.async will automatically fill the
           // remaining slots with 0 if cp-size > src-size.
-          // XXX(Keren): Always assume other = 0 for now.
           auto selectOp = select(maskElems[elemIdx + wordElemIdx],
                                  i32_val(byteWidth), i32_val(0));
           srcSize = ptxBuilder.newOperand(selectOp, "r");
+          copyAsyncOp(dstOperand, srcOperand, copySize, srcSize);
+        } else if (op.getMask()) {
+          copyAsyncOp(dstOperand, srcOperand, copySize, srcSize)
+              .predicate(maskElems[elemIdx + wordElemIdx], "b");
+        } else {
+          copyAsyncOp(dstOperand, srcOperand, copySize, srcSize);
         }
-        copyAsyncOp(dstOperand, srcOperand, copySize, srcSize);
         ptxBuilder.launch(rewriter, loc, void_ty(getContext()));
+
+        if (op.getMask() && !otherIsZero)
+          storeOtherToShared(loc, rewriter, basePtr,
+                             wordElemIdx * resByteWidth,
+                             ArrayRef<Value>(otherElems)
+                                 .slice(elemIdx + wordElemIdx, numWordElems),
+                             resElemTy, maskElems[elemIdx + wordElemIdx]);
       }
     }
 
     rewriter.replaceOp(op, llDst);
     return success();
   }
+
+private:
+  // Write `otherElems` to the shared memory word at `basePtr + byteOffset` if
+  // `mask` is false.
+  void storeOtherToShared(Location loc, ConversionPatternRewriter &rewriter,
+                          Value basePtr, unsigned byteOffset,
+                          ArrayRef<Value> otherElems, Type elemTy,
+                          Value mask) const {
+    unsigned bitWidth = otherElems.size() * elemTy.getIntOrFloatBitWidth();
+    assert(bitWidth % 32 == 0 && "Unexpected width of cp.async word");
+    unsigned numRegs = bitWidth / 32;
+    auto wordTy = vec_ty(elemTy, otherElems.size());
+    Value word = undef(wordTy);
+    for (auto en : llvm::enumerate(otherElems))
+      word = insert_element(wordTy, word, bitcast(en.value(), elemTy),
+                            i32_val(en.index()));
+    auto regsTy = vec_ty(i32_ty, numRegs);
+    word = bitcast(word, regsTy);
+
+    PTXBuilder ptxBuilder;
+    SmallVector<std::pair<Value, std::string>> regs;
+    for (unsigned r = 0; r < numRegs; ++r)
+      regs.emplace_back(extract_element(i32_ty, word, i32_val(r)), "r");
+    auto *valOperand = numRegs == 1
+                           ? ptxBuilder.newOperand(regs[0].first, "r")
+                           : ptxBuilder.newListOperand(regs);
+    auto *addrOperand = ptxBuilder.newAddrOperand(basePtr, "r", byteOffset);
+    auto &st = ptxBuilder.create<>("st")->shared().v(numRegs).b(32);
+    st(addrOperand, valOperand).predicateNot(mask, "b");
+    ptxBuilder.launch(rewriter, loc, void_ty(rewriter.getContext()));
+  }
 };
 
 void populateLoadStoreOpToLLVMPatterns(
     TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
     ModuleAxisInfoAnalysis &axisInfoAnalysis, ModuleAllocation &allocation,
     ConvertTritonGPUOpToLLVMPatternBase::IndexCacheInfo &indexCacheInfo,
-    PatternBenefit benefit) {
-  patterns.add<LoadOpConversion>(typeConverter, axisInfoAnalysis, benefit);
-  patterns.add<StoreOpConversion>(typeConverter, axisInfoAnalysis, benefit);
-  patterns.add<AtomicCASOpConversion>(typeConverter, allocation,
+    int computeCapability, PatternBenefit benefit) {
+  patterns.add<LoadOpConversion>(typeConverter, indexCacheInfo,
+                                 axisInfoAnalysis, computeCapability, benefit);
+  patterns.add<StoreOpConversion>(typeConverter, indexCacheInfo,
+                                  axisInfoAnalysis, computeCapability, benefit);
+  patterns.add<AtomicCASOpConversion>(typeConverter, allocation, indexCacheInfo,
                                       axisInfoAnalysis, benefit);
-  patterns.add<AtomicRMWOpConversion>(typeConverter, allocation,
+  patterns.add<AtomicRMWOpConversion>(typeConverter, allocation, indexCacheInfo,
                                       axisInfoAnalysis, benefit);
   patterns.add<InsertSliceOpConversion>(typeConverter, allocation,
                                         indexCacheInfo, benefit);
@@ -6,16 +6,57 @@ using namespace mlir::triton;
 
 using ::mlir::LLVM::delinearize;
 using ::mlir::LLVM::linearize;
+using ::mlir::LLVM::reduxSync;
 using ::mlir::LLVM::shflSync;
 using ::mlir::LLVM::storeShared;
 using ::mlir::triton::gpu::getOrder;
 using ::mlir::triton::gpu::getTotalElemsPerThread;
 
+// The redux.sync operation that computes the combine region of `op`, if it is
+// a single 32-bit integer add, min, max, and, or or xor of its arguments
+static std::optional<StringRef> getReduxKind(triton::ReduceOp op) {
+  if (op.getNumOperands() != 1 ||
+      !op.getInputTypes()[0].getElementType().isInteger(32))
+    return std::nullopt;
+  Block &block = op.getCombineOp().front();
+  if (block.getOperations().size() != 2)
+    return std::nullopt;
+  Operation *combine = &block.front();
+  Operation *terminator = block.getTerminator();
+  if (combine->getNumOperands() != 2 ||
+      terminator->getOperand(0) != combine->getResult(0) ||
+      !llvm::is_contained(combine->getOperands(), block.getArgument(0)) ||
+      !llvm::is_contained(combine->getOperands(), block.getArgument(1)))
+    return std::nullopt;
+  if (isa<arith::AddIOp>(combine))
+    return StringRef("add.s32");
+  if (isa<arith::MinSIOp>(combine))
+    return StringRef("min.s32");
+  if (isa<arith::MinUIOp>(combine))
+    return StringRef("min.u32");
+  if (isa<arith::MaxSIOp>(combine))
+    return StringRef("max.s32");
+  if (isa<arith::MaxUIOp>(combine))
+    return StringRef("max.u32");
+  if (isa<arith::AndIOp>(combine))
+    return StringRef("and.b32");
+  if (isa<arith::OrIOp>(combine))
+    return StringRef("or.b32");
+  if (isa<arith::XOrIOp>(combine))
+    return StringRef("xor.b32");
+  return std::nullopt;
+}
+
 struct ReduceOpConversion
     : public ConvertTritonGPUOpToLLVMPattern<triton::ReduceOp> {
 public:
-  using ConvertTritonGPUOpToLLVMPattern<
-      triton::ReduceOp>::ConvertTritonGPUOpToLLVMPattern;
+  ReduceOpConversion(
+      TritonGPUToLLVMTypeConverter &typeConverter, ModuleAllocation &allocation,
+      ConvertTritonGPUOpToLLVMPatternBase::IndexCacheInfo &indexCacheInfo,
+      int computeCapability, PatternBenefit benefit)
+      : ConvertTritonGPUOpToLLVMPattern<triton::ReduceOp>(
+            typeConverter, allocation, indexCacheInfo, benefit),
+        computeCapability(computeCapability) {}
 
   LogicalResult
   matchAndRewrite(triton::ReduceOp op, OpAdaptor adaptor,
@@ -26,6 +67,8 @@ public:
   }
 
 private:
+  int computeCapability;
+
   void accumulate(ConversionPatternRewriter &rewriter, Region &combineOp,
                   llvm::SmallVectorImpl<Value> &acc, ValueRange cur,
                   bool isFirst) const {
@@ -81,6 +124,36 @@ private:
     return srcValues;
   }
 
+  // Reduces each accumulator of `accs` across the `numLanes` consecutive lanes
+  // that hold its values. The accumulators are shuffled together so that
+  // values narrower than 32 bits share shuffles. Full-warp reductions of a
+  // 32-bit integer use redux.sync on sm_80+.
+  void warpReduce(ConversionPatternRewriter &rewriter, Location loc,
+                  triton::ReduceOp op,
+                  MutableArrayRef<SmallVector<Value>> accs,
+                  unsigned numLanes) const {
+    if (numLanes == 32 && computeCapability >= 80) {
+      if (std::optional<StringRef> kind = getReduxKind(op)) {
+        for (SmallVector<Value> &acc : accs)
+          acc[0] = reduxSync(loc, rewriter, acc[0], *kind);
+        return;
+      }
+    }
+    for (unsigned N = numLanes / 2; N > 0; N >>= 1) {
+      SmallVector<Value> vals;
+      for (SmallVector<Value> &acc : accs)
+        vals.append(acc.begin(), acc.end());
+      SmallVector<Value> shfl = shflSync(loc, rewriter, vals, N);
+      unsigned offset = 0;
+      for (SmallVector<Value> &acc : accs) {
+        unsigned numVals = acc.size();
+        accumulate(rewriter, op.getCombineOp(), acc,
+                   ArrayRef<Value>(shfl).slice(offset, numVals), false);
+        offset += numVals;
+      }
+    }
+  }
+
   // Calculates the write index in the shared memory where we would be writing
   // the within-thread accumulations before we start doing across-threads
   // accumulations. `index` is the index of the within-thread accumulations in
@@ -387,19 +460,14 @@ private:
     Value zero = i32_val(0);
     Value laneZero = icmp_eq(laneIdAxis, zero);
 
-    for (auto it : accs) {
-      const SmallVector<unsigned> &key = it.first;
-      SmallVector<Value> acc = it.second;
-
-      // Reduce within warps
-      for (unsigned N = sizeIntraWarps / 2; N > 0; N >>= 1) {
-        SmallVector<Value> shfl(op.getNumOperands());
-        for (unsigned i = 0; i < op.getNumOperands(); ++i) {
-          shfl[i] = shflSync(loc, rewriter, acc[i], N);
-        }
-        accumulate(rewriter, *combineOp, acc, shfl, false);
-      }
+    // Reduce within warps
+    SmallVector<SmallVector<Value>> warpAccs;
+    for (auto &it : accs)
+      warpAccs.push_back(it.second);
+    warpReduce(rewriter, loc, op, warpAccs, sizeIntraWarps);
 
+    for (auto [it, acc] : llvm::zip(accs, warpAccs)) {
+      const SmallVector<unsigned> &key = it.first;
       SmallVector<Value> writeIdx = indices[key];
       writeIdx[axis] = (sizeInterWarps == 1) ? zero : warpIdAxis;
       Value writeOffset =
@@ -424,26 +492,27 @@ private:
         product<unsigned>(triton::gpu::getWarpsPerCTA(srcLayout)) *
         triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
     unsigned elemsPerThread = std::max<unsigned>(elems / numThreads, 1);
-    Value readOffset = threadId;
+    SmallVector<Value> readOffsets;
+    SmallVector<SmallVector<Value>> roundAccs(elemsPerThread);
     for (unsigned round = 0; round < elemsPerThread; ++round) {
       // FIXME(Qingyi): need predicate icmp_slt(threadId,
       // i32_val(sizeInerWarps))
-      SmallVector<Value> acc(op.getNumOperands());
+      Value readOffset =
+          round == 0 ? threadId : add(threadId, i32_val(round * numThreads));
+      readOffsets.push_back(readOffset);
       for (unsigned i = 0; i < op.getNumOperands(); ++i) {
         Value readPtr = gep(elemPtrTys[i], smemBases[i], readOffset);
-        acc[i] = load(readPtr);
+        roundAccs[round].push_back(load(readPtr));
       }
+    }
 
-      for (unsigned N = sizeInterWarps / 2; N > 0; N >>= 1) {
-        SmallVector<Value> shfl(op.getNumOperands());
-        for (unsigned i = 0; i < op.getNumOperands(); ++i) {
-          shfl[i] = shflSync(loc, rewriter, acc[i], N);
-        }
-        accumulate(rewriter, *combineOp, acc, shfl, false);
-      }
+    // The rounds are independent, reduce them together
+    warpReduce(rewriter, loc, op, roundAccs, sizeInterWarps);
 
+    for (unsigned round = 0; round < elemsPerThread; ++round) {
+      SmallVector<Value> &acc = roundAccs[round];
       // only the first thread in each sizeInterWarps is writing
-      Value writeOffset = readOffset;
+      Value writeOffset = readOffsets[round];
       SmallVector<Value> writePtrs(op.getNumOperands());
       for (unsigned i = 0; i < op.getNumOperands(); ++i) {
         writePtrs[i] = gep(elemPtrTys[i], smemBases[i], writeOffset);
@@ -457,10 +526,6 @@ private:
       for (unsigned i = 0; i < op.getNumOperands(); ++i) {
         storeShared(rewriter, loc, writePtrs[i], acc[i], pred);
       }
-
-      if (round != elemsPerThread - 1) {
-        readOffset = add(readOffset, i32_val(numThreads));
-      }
     }
 
     // We could avoid this barrier in some of the layouts, however this is not
@@ -506,7 +571,7 @@ void populateReduceOpToLLVMPatterns(
     TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
     ModuleAllocation &allocation,
     ConvertTritonGPUOpToLLVMPatternBase::IndexCacheInfo &indexCacheInfo,
-    PatternBenefit benefit) {
+    int computeCapability, PatternBenefit benefit) {
   patterns.add<ReduceOpConversion>(typeConverter, allocation, indexCacheInfo,
-                                   benefit);
+                                   computeCapability, benefit);
 }
@@ -7,11 +7,13 @@ using namespace mlir::triton;
 
 using ::mlir::LLVM::delinearize;
 using ::mlir::LLVM::linearize;
+using ::mlir::LLVM::shflDownSync;
 using ::mlir::LLVM::shflUpSync;
 using ::mlir::LLVM::storeShared;
 
 // Apply the region of the scan op to the acc and cur values and update acc
-// inplace with the result.
+// inplace with the result. `acc` comes before `cur` in the scan order, which
+// in a reverse scan is the opposite of the order of the combine arguments.
 static void accumulate(ConversionPatternRewriter &rewriter, Region &combineOp,
                        Value &acc, Value cur) {
   if (!acc) {
@@ -25,6 +27,8 @@ static void accumulate(ConversionPatternRewriter &rewriter, Region &combineOp,
   auto &newScan = parent.front();
   auto returnOp = dyn_cast<triton::ScanReturnOp>(newScan.getTerminator());
   llvm::SmallVector<Value> combineArgs = {acc, cur};
+  if (cast<triton::ScanOp>(combineOp.getParentOp()).getReverse())
+    std::swap(combineArgs[0], combineArgs[1]);
   rewriter.inlineBlockBefore(&newScan, &*rewriter.getInsertionPoint(),
                              combineArgs);
   auto results = returnOp.getResult();
@@ -33,6 +37,30 @@ static void accumulate(ConversionPatternRewriter &rewriter, Region &combineOp,
   rewriter.eraseOp(returnOp);
 }
 
+// Reverse the order of the elements of a thread along the axis, both within
+// chunks of contiguous elements and across blocks. A reverse scan is a forward
+// scan of the flipped elements by the flipped lanes and warps.
+static void flipSrcValues(SmallVector<Value> &srcValues,
+                          ScanLoweringHelper &helper) {
+  int scanElementsPerThreads = helper.getAxisNumElementsPerThread();
+  int elementStride = helper.getAxisElementStride();
+  int elemsPerBlock =
+      scanElementsPerThreads * helper.getNonAxisNumElementsPerThread();
+  int numScanBlocks = helper.getAxisNumBlocks();
+  int blockStride = helper.getAxisBlockStride();
+  SmallVector<Value> flipped(srcValues.size());
+  for (int srcIndex = 0, e = srcValues.size(); srcIndex < e; srcIndex++) {
+    int elementIdx = (srcIndex / elementStride) % scanElementsPerThreads;
+    int axisBlockId = (srcIndex / elemsPerBlock / blockStride) % numScanBlocks;
+    int dstIndex =
+        srcIndex +
+        (scanElementsPerThreads - 1 - 2 * elementIdx) * elementStride +
+        (numScanBlocks - 1 - 2 * axisBlockId) * blockStride * elemsPerBlock;
+    flipped[dstIndex] = srcValues[srcIndex];
+  }
+  srcValues = std::move(flipped);
+}
+
 // Scan a contiguous elements within a thread and update `srcValues` in place.
 static void scanThreadContiguousElements(SmallVector<Value> &srcValues,
                                          ConversionPatternRewriter &rewriter,
@@ -65,21 +93,31 @@ static void warpScan(SmallVector<Value> &srcValues,
   unsigned elementStride = helper.getAxisElementStride();
   unsigned threadStride = helper.getAxisThreadStride();
   unsigned scanDim = helper.getAxisNumThreadsPerWarp();
+  SmallVector<unsigned> lastIndices;
   for (unsigned srcIndex = 0; srcIndex < srcValues.size(); srcIndex++) {
     unsigned elementIdx = (srcIndex / elementStride) % scanElementsPerThreads;
     // Only consider the last element of each contiguous chunk of elements.
     if (elementIdx != scanElementsPerThreads - 1)
       continue;
-    // Reduce within warps.
-    Value acc = srcValues[srcIndex];
-    for (unsigned i = 1; i <= (scanDim) / 2; i = i << 1) {
-      Value shfl = shflUpSync(loc, rewriter, acc, i * threadStride);
-      Value tempAcc = acc;
-      accumulate(rewriter, helper.getCombineOp(), tempAcc, shfl);
-      Value mask = icmp_slt(laneId, i32_val(i));
-      acc = select(mask, acc, tempAcc);
+    lastIndices.push_back(srcIndex);
+  }
+  // Reduce within warps. The chunks are shuffled together so that values
+  // narrower than 32 bits share shuffles.
+  for (unsigned i = 1; i <= (scanDim) / 2; i = i << 1) {
+    SmallVector<Value> accs;
+    for (unsigned srcIndex : lastIndices)
+      accs.push_back(srcValues[srcIndex]);
+    // The previous lanes of a reverse scan are the next physical ones
+    SmallVector<Value> shfl =
+        helper.getReverse()
+            ? shflDownSync(loc, rewriter, accs, i * threadStride)
+            : shflUpSync(loc, rewriter, accs, i * threadStride);
+    Value mask = icmp_slt(laneId, i32_val(i));
+    for (auto [srcIndex, shflVal] : llvm::zip(lastIndices, shfl)) {
+      Value tempAcc = shflVal;
+      accumulate(rewriter, helper.getCombineOp(), tempAcc, srcValues[srcIndex]);
+      srcValues[srcIndex] = select(mask, srcValues[srcIndex], tempAcc);
     }
-    srcValues[srcIndex] = acc;
   }
 }
 
@@ -116,15 +154,41 @@ static void storeWarpAccumulator(SmallVector<Value> &srcValues,
   }
 }
 
+// Scan the partial reductions of the warps along the axis in place with a
+// Brent-Kung network: 2 * log2(numWarps) - 1 dependent combines instead of
+// numWarps - 1 for a sequential accumulation.
+static void scanWarpPartials(SmallVector<Value> &partials,
+                             ConversionPatternRewriter &rewriter,
+                             ScanLoweringHelper &helper) {
+  unsigned numWarps = partials.size();
+  assert(llvm::isPowerOf2_32(numWarps) && "Unexpected number of warps");
+  auto combine = [&](unsigned dst, unsigned src) {
+    Value acc = partials[src];
+    accumulate(rewriter, helper.getCombineOp(), acc, partials[dst]);
+    partials[dst] = acc;
+  };
+  // Up-sweep: every 2^k-th partial holds the reduction of the 2^k partials
+  // ending at it
+  for (unsigned d = 1; d < numWarps; d *= 2)
+    for (unsigned i = 2 * d - 1; i < numWarps; i += 2 * d)
+      combine(i, i - d);
+  // Down-sweep: complete the prefixes of the partials in between
+  for (unsigned d = numWarps / 4; d > 0; d /= 2)
+    for (unsigned i = 3 * d - 1; i < numWarps; i += 2 * d)
+      combine(i, i - d);
+}
+
 // Read the partial reductions from shared memory from each chunk of contiguous
 // elements for each warp and parallel scan. Then combine the partial reduction
 // with the right elements. Within a given contiguous element chunk we update
 // all the elements by accumulating the value from the last element of the
-// reduced value from the previous lane.
+// reduced value from the previous lane. For an exclusive scan the elements are
+// then shifted by one, the first element of the scan getting `identity`.
 static void AddPartialReduce(SmallVector<Value> &srcValues,
                              ConversionPatternRewriter &rewriter,
                              ScanLoweringHelper &helper, Value sharedMemoryPtr,
-                             Value warpId, Value laneId, Value parallelLaneId) {
+                             Value warpId, Value laneId, Value parallelLaneId,
+                             Value identity) {
   Location loc = helper.getLoc();
   unsigned numParallelLane = helper.getNonAxisNumThreadsPerCTA();
   unsigned numWarps = helper.getAxisNumWarps();
@@ -135,17 +199,14 @@ static void AddPartialReduce(SmallVector<Value> &srcValues,
   Value maskFirstWarp = icmp_eq(warpId, i32_val(0));
   Value maskFirstLane = icmp_eq(laneId, i32_val(0));
   Value maskFirstThread = and_(maskFirstWarp, maskFirstLane);
-  struct Accumulator {
-    Value acc;
-    Value maskedAcc;
-  };
   unsigned numScanBlocks = helper.getAxisNumBlocks();
   unsigned numParallelBlocks = helper.getNonAxisNumBlocks();
   assert(numScanBlocks * numParallelBlocks * parallelElementsPerThread *
              scanElementsPerThreads ==
          srcValues.size());
-  SmallVector<Accumulator> accumulators(numParallelBlocks *
-                                        parallelElementsPerThread);
+  // Reduction of the blocks already scanned along the axis
+  SmallVector<Value> accumulators(numParallelBlocks *
+                                  parallelElementsPerThread);
   unsigned chunkId = 0;
   unsigned blockStride = helper.getAxisBlockStride();
   for (unsigned srcIndex = 0; srcIndex < srcValues.size(); srcIndex++) {
@@ -162,25 +223,27 @@ static void AddPartialReduce(SmallVector<Value> &srcValues,
         ((blockId / blockStride) / numScanBlocks) * blockStride;
     unsigned accumulatorIndex = chunkId % parallelElementsPerThread +
                                 parallelBlockId * parallelElementsPerThread;
-    Accumulator &accumulator = accumulators[accumulatorIndex];
+    Value &accumulator = accumulators[accumulatorIndex];
+    SmallVector<Value> partials;
     for (unsigned i = 0; i < numWarps; ++i) {
       Value index = add(parallelLaneId,
                         i32_val(numParallelLane * (i + chunkId * numWarps)));
       Value ptr = gep(sharedMemoryPtr.getType(), sharedMemoryPtr, index);
-      Value partialReduce = load(ptr);
-      if (!accumulator.acc) {
-        accumulator.acc = partialReduce;
-        accumulator.maskedAcc = partialReduce;
-        continue;
-      }
-      accumulate(rewriter, helper.getCombineOp(), accumulator.acc,
-                 partialReduce);
-      Value mask = icmp_slt(warpId, i32_val(i + 1));
-      accumulator.maskedAcc =
-          select(mask, accumulator.maskedAcc, accumulator.acc);
+      partials.push_back(load(ptr));
     }
-    Value temp = srcValues[srcIndex];
-    accumulate(rewriter, helper.getCombineOp(), temp, accumulator.maskedAcc);
+    // Carry the previous blocks in the first partial, whose own prefix is the
+    // carry alone. Without a carry the prefix of the first warp is masked out
+    // below.
+    Value prefix = accumulator ? accumulator : partials[0];
+    accumulate(rewriter, helper.getCombineOp(), accumulator, partials[0]);
+    partials[0] = accumulator;
+    scanWarpPartials(partials, rewriter, helper);
+    for (unsigned i = 1; i < numWarps; ++i)
+      prefix = select(icmp_eq(warpId, i32_val(i)), partials[i - 1], prefix);
+    accumulator = partials.back();
+
+    Value temp = prefix;
+    accumulate(rewriter, helper.getCombineOp(), temp, srcValues[srcIndex]);
     unsigned axisBlockId = (blockId / blockStride) % numScanBlocks;
     if (axisBlockId == 0) {
       // For the first warp and first chunk we don't have anything to
@@ -190,11 +253,14 @@ static void AddPartialReduce(SmallVector<Value> &srcValues,
     srcValues[srcIndex] = temp;
     // Update the rest of the contiguous elements.
     Value lastElement =
-        shflUpSync(loc, rewriter, srcValues[srcIndex], threadStride);
-    lastElement = select(maskFirstLane, accumulator.maskedAcc, lastElement);
+        helper.getReverse()
+            ? shflDownSync(loc, rewriter, srcValues[srcIndex], threadStride)
+            : shflUpSync(loc, rewriter, srcValues[srcIndex], threadStride);
+    lastElement = select(maskFirstLane, prefix, lastElement);
     for (unsigned i = 1; i < scanElementsPerThreads; ++i) {
-      Value laneValue = srcValues[srcIndex - i * elementStride];
-      accumulate(rewriter, helper.getCombineOp(), laneValue, lastElement);
+      Value laneValue = lastElement;
+      accumulate(rewriter, helper.getCombineOp(), laneValue,
+                 srcValues[srcIndex - i * elementStride]);
       if (axisBlockId == 0) {
         // For the first warp and first chunk we don't have anything to
         // accumulate.
@@ -203,9 +269,17 @@ static void AddPartialReduce(SmallVector<Value> &srcValues,
       }
       srcValues[srcIndex - i * elementStride] = laneValue;
     }
-    // For the next chunk start back from the value containing the
-    // accumulated value of all the warps.
-    accumulator.maskedAcc = accumulator.acc;
+    if (identity) {
+      // `lastElement` is the reduction of everything before the chunk
+      for (unsigned i = 0; i + 1 < scanElementsPerThreads; ++i)
+        srcValues[srcIndex - i * elementStride] =
+            srcValues[srcIndex - (i + 1) * elementStride];
+      Value first = lastElement;
+      if (axisBlockId == 0)
+        first = select(maskFirstThread, identity, first);
+      srcValues[srcIndex - (scanElementsPerThreads - 1) * elementStride] =
+          first;
+    }
     chunkId++;
   }
 }
@@ -287,6 +361,18 @@ ScanOpConversion::emitFastScan(triton::ScanOp op, triton::ScanOpAdaptor adaptor,
   auto type = op.getOperand(0).getType().cast<RankedTensorType>();
   SmallVector<Value> srcValues =
       getTypeConverter()->unpackLLElements(loc, input, rewriter, type);
+  if (helper.getReverse()) {
+    laneIdAxis =
+        sub(i32_val(helper.getAxisNumThreadsPerWarp() - 1), laneIdAxis);
+    warpIdAxis = sub(i32_val(helper.getAxisNumWarps() - 1), warpIdAxis);
+    flipSrcValues(srcValues, helper);
+  }
+  Value identity;
+  if (helper.getExclusive()) {
+    TypedAttr neutral = *op.getNeutralElement();
+    identity = rewriter.create<LLVM::ConstantOp>(
+        loc, getTypeConverter()->convertType(neutral.getType()), neutral);
+  }
 
   // Scan contigous elements in a thread and update `srcValues`.
   scanThreadContiguousElements(srcValues, rewriter, helper);
@@ -305,7 +391,9 @@ ScanOpConversion::emitFastScan(triton::ScanOp op, triton::ScanOpAdaptor adaptor,
   // warpId. Then update each chunk of contiguous elements by adding the
   // accumulated value from the previous lane.
   AddPartialReduce(srcValues, rewriter, helper, baseSharedMemPtr, warpIdAxis,
-                   laneIdAxis, flatIdParallel);
+                   laneIdAxis, flatIdParallel, identity);
+  if (helper.getReverse())
+    flipSrcValues(srcValues, helper);
 
   Value results = getTypeConverter()->packLLElements(loc, srcValues, rewriter,
                                                      input.getType());
@@ -167,16 +167,61 @@ struct CacheKeyDenseMapInfo {
   }
 };
 
-class ConvertTritonGPUOpToLLVMPatternBase {
+// Materializes the thread id and the indices of the elements of distributed
+// layouts once per function, at its entry, so that all the lowering patterns
+// and blocks of the function share them.
+class IndexCache {
 public:
-  // Two levels of value cache in emitting indices calculation:
-  // Key: pair<layout, shape>
-  struct IndexCacheInfo {
+  struct FuncIndices {
+    Value threadId;
+    // Two levels of value cache in emitting indices calculation:
+    // Key: pair<layout, shape>
     DenseMap<IndexCacheKeyT, SmallVector<Value>, CacheKeyDenseMapInfo>
-        *baseIndexCache;
+        baseIndices;
     DenseMap<IndexCacheKeyT, SmallVector<SmallVector<Value>>,
-             CacheKeyDenseMapInfo> *indexCache;
-    OpBuilder::InsertPoint *indexInsertPoint;
+             CacheKeyDenseMapInfo>
+        indices;
+    // After the indices materialized so far
+    OpBuilder::InsertPoint insertPoint;
+  };
+
+  // The indices of the function `rewriter` inserts into
+  FuncIndices &getFuncIndices(ConversionPatternRewriter &rewriter) {
+    auto func = rewriter.getInsertionBlock()
+                    ->getParent()
+                    ->getParentOfType<LLVM::LLVMFuncOp>();
+    return funcIndices[func];
+  }
+
+  // Moves `rewriter` to where the indices of its function are materialized
+  void setInsertionPoint(FuncIndices &indices,
+                         ConversionPatternRewriter &rewriter) {
+    if (indices.insertPoint.isSet()) {
+      rewriter.restoreInsertionPoint(indices.insertPoint);
+    } else {
+      auto func = rewriter.getInsertionBlock()
+                      ->getParent()
+                      ->getParentOfType<LLVM::LLVMFuncOp>();
+      rewriter.setInsertionPointToStart(&func.getBody().front());
+    }
+  }
+
+  void recordHit() { ++numHits; }
+  void recordMiss() { ++numMisses; }
+  unsigned getNumHits() const { return numHits; }
+  unsigned getNumMisses() const { return numMisses; }
+
+private:
+  DenseMap<Operation *, FuncIndices> funcIndices;
+  unsigned numHits = 0;
+  unsigned numMisses = 0;
+};
+
+class ConvertTritonGPUOpToLLVMPatternBase {
+public:
+  // Indices are shared across patterns through the IndexCache, if any
+  struct IndexCacheInfo {
+    IndexCache *indexCache = nullptr;
   };
 
   explicit ConvertTritonGPUOpToLLVMPatternBase(
@@ -218,6 +263,23 @@ public:
   }
 
   Value getThreadId(ConversionPatternRewriter &rewriter, Location loc) const {
+    IndexCache *cache = indexCacheInfo.indexCache;
+    if (!cache)
+      return emitThreadId(rewriter, loc);
+    auto &indices = cache->getFuncIndices(rewriter);
+    if (indices.threadId) {
+      cache->recordHit();
+      return indices.threadId;
+    }
+    cache->recordMiss();
+    ConversionPatternRewriter::InsertionGuard guard(rewriter);
+    cache->setInsertionPoint(indices, rewriter);
+    indices.threadId = emitThreadId(rewriter, loc);
+    indices.insertPoint = rewriter.saveInsertionPoint();
+    return indices.threadId;
+  }
+
+  Value emitThreadId(ConversionPatternRewriter &rewriter, Location loc) const {
     auto tid = rewriter.create<::mlir::gpu::ThreadIdOp>(
         loc, ::mlir::gpu::Dimension::x);
     return rewriter.create<arith::IndexCastOp>(loc, i32_ty, tid);
@@ -540,39 +602,44 @@ public:
                                             Attribute layout,
                                             RankedTensorType type) const {
     IndexCacheKeyT key = std::make_pair(layout, type);
-    auto cache = indexCacheInfo.baseIndexCache;
-    auto insertPt = indexCacheInfo.indexInsertPoint;
-    if (cache && cache->count(key) > 0) {
-      return cache->lookup(key);
-    } else {
-      ConversionPatternRewriter::InsertionGuard guard(rewriter);
-      if (cache)
-        restoreInsertionPointIfSet(insertPt, rewriter);
-      SmallVector<Value> result;
-      if (auto blockedLayout = layout.dyn_cast<BlockedEncodingAttr>()) {
-        result =
-            emitBaseIndexForBlockedLayout(loc, rewriter, blockedLayout, type);
-      } else if (auto mmaLayout = layout.dyn_cast<MmaEncodingAttr>()) {
-        if (mmaLayout.isVolta())
-          result = emitBaseIndexForMmaLayoutV1(loc, rewriter, mmaLayout, type);
-        if (mmaLayout.isAmpere())
-          result = emitBaseIndexForMmaLayoutV2(loc, rewriter, mmaLayout, type);
-      } else if (auto sliceLayout = layout.dyn_cast<SliceEncodingAttr>()) {
-        auto parentLayout = sliceLayout.getParent();
-        auto parentShape = sliceLayout.paddedShape(type.getShape());
-        RankedTensorType parentTy = RankedTensorType::get(
-            parentShape, type.getElementType(), parentLayout);
-        result = emitBaseIndexForLayout(loc, rewriter, parentLayout, parentTy);
-        result.erase(result.begin() + sliceLayout.getDim());
-      } else {
-        llvm_unreachable("unsupported emitBaseIndexForLayout");
-      }
-      if (cache) {
-        cache->insert(std::make_pair(key, result));
-        *insertPt = rewriter.saveInsertionPoint();
+    IndexCache *cache = indexCacheInfo.indexCache;
+    if (cache) {
+      auto &indices = cache->getFuncIndices(rewriter);
+      auto it = indices.baseIndices.find(key);
+      if (it != indices.baseIndices.end()) {
+        cache->recordHit();
+        return it->second;
       }
-      return result;
+      cache->recordMiss();
+    }
+    ConversionPatternRewriter::InsertionGuard guard(rewriter);
+    if (cache)
+      cache->setInsertionPoint(cache->getFuncIndices(rewriter), rewriter);
+    SmallVector<Value> result;
+    if (auto blockedLayout = layout.dyn_cast<BlockedEncodingAttr>()) {
+      result =
+          emitBaseIndexForBlockedLayout(loc, rewriter, blockedLayout, type);
+    } else if (auto mmaLayout = layout.dyn_cast<MmaEncodingAttr>()) {
+      if (mmaLayout.isVolta())
+        result = emitBaseIndexForMmaLayoutV1(loc, rewriter, mmaLayout, type);
+      if (mmaLayout.isAmpere())
+        result = emitBaseIndexForMmaLayoutV2(loc, rewriter, mmaLayout, type);
+    } else if (auto sliceLayout = layout.dyn_cast<SliceEncodingAttr>()) {
+      auto parentLayout = sliceLayout.getParent();
+      auto parentShape = sliceLayout.paddedShape(type.getShape());
+      RankedTensorType parentTy = RankedTensorType::get(
+          parentShape, type.getElementType(), parentLayout);
+      result = emitBaseIndexForLayout(loc, rewriter, parentLayout, parentTy);
+      result.erase(result.begin() + sliceLayout.getDim());
+    } else {
+      llvm_unreachable("unsupported emitBaseIndexForLayout");
     }
+    if (cache) {
+      auto &indices = cache->getFuncIndices(rewriter);
+      indices.baseIndices.insert(std::make_pair(key, result));
+      indices.insertPoint = rewriter.saveInsertionPoint();
+    }
+    return result;
   }
 
   SmallVector<SmallVector<unsigned>>
@@ -598,46 +665,40 @@ public:
                                               Attribute layout,
                                               RankedTensorType type) const {
     IndexCacheKeyT key(layout, type);
-    auto cache = indexCacheInfo.indexCache;
-    auto insertPt = indexCacheInfo.indexInsertPoint;
-    if (cache && cache->count(key) > 0) {
-      return cache->lookup(key);
-    } else {
-      ConversionPatternRewriter::InsertionGuard guard(b);
-      if (cache)
-        restoreInsertionPointIfSet(insertPt, b);
-      SmallVector<SmallVector<Value>> result;
-      if (auto blocked = layout.dyn_cast<BlockedEncodingAttr>()) {
-        result = emitIndicesForDistributedLayout(loc, b, blocked, type);
-      } else if (auto mma = layout.dyn_cast<MmaEncodingAttr>()) {
-        result = emitIndicesForDistributedLayout(loc, b, mma, type);
-      } else if (auto slice = layout.dyn_cast<SliceEncodingAttr>()) {
-        result = emitIndicesForDistributedLayout(loc, b, slice, type);
-      } else {
-        llvm_unreachable(
-            "emitIndices for layouts other than blocked & slice not "
-            "implemented yet");
-      }
-      if (cache) {
-        cache->insert(std::make_pair(key, result));
-        *insertPt = b.saveInsertionPoint();
+    IndexCache *cache = indexCacheInfo.indexCache;
+    if (cache) {
+      auto &indices = cache->getFuncIndices(b);
+      auto it = indices.indices.find(key);
+      if (it != indices.indices.end()) {
+        cache->recordHit();
+        return it->second;
       }
-      return result;
+      cache->recordMiss();
     }
-  }
-
-private:
-  void restoreInsertionPointIfSet(OpBuilder::InsertPoint *insertPt,
-                                  ConversionPatternRewriter &rewriter) const {
-    if (insertPt->isSet()) {
-      rewriter.restoreInsertionPoint(*insertPt);
+    ConversionPatternRewriter::InsertionGuard guard(b);
+    if (cache)
+      cache->setInsertionPoint(cache->getFuncIndices(b), b);
+    SmallVector<SmallVector<Value>> result;
+    if (auto blocked = layout.dyn_cast<BlockedEncodingAttr>()) {
+      result = emitIndicesForDistributedLayout(loc, b, blocked, type);
+    } else if (auto mma = layout.dyn_cast<MmaEncodingAttr>()) {
+      result = emitIndicesForDistributedLayout(loc, b, mma, type);
+    } else if (auto slice = layout.dyn_cast<SliceEncodingAttr>()) {
+      result = emitIndicesForDistributedLayout(loc, b, slice, type);
     } else {
-      auto func =
-          rewriter.getInsertionPoint()->getParentOfType<LLVM::LLVMFuncOp>();
-      rewriter.setInsertionPointToStart(&func.getBody().front());
+      llvm_unreachable(
+          "emitIndices for layouts other than blocked & slice not "
+          "implemented yet");
     }
+    if (cache) {
+      auto &indices = cache->getFuncIndices(b);
+      indices.indices.insert(std::make_pair(key, result));
+      indices.insertPoint = b.saveInsertionPoint();
+    }
+    return result;
   }
 
+private:
   // -----------------------------------------------------------------------
   // Blocked layout indices
   // -----------------------------------------------------------------------
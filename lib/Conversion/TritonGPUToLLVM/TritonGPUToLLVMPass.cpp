@@ -293,8 +293,12 @@ class ConvertTritonGPUToLLVM
     : public ConvertTritonGPUToLLVMBase<ConvertTritonGPUToLLVM> {
 
 public:
-  explicit ConvertTritonGPUToLLVM(int computeCapability, bool isROCM)
-      : computeCapability(computeCapability), isROCM(isROCM) {}
+  explicit ConvertTritonGPUToLLVM(int computeCapability, bool isROCM,
+                                  bool nativeFp8) {
+    this->computeCapability = computeCapability;
+    this->isROCM = isROCM;
+    this->nativeFp8 = nativeFp8;
+  }
 
   void runOnOperation() override {
     MLIRContext *context = &getContext();
@@ -354,25 +358,24 @@ public:
     // Rewrite ops
     RewritePatternSet patterns(context);
     // TritonGPU lowering patterns
-    OpBuilder::InsertPoint indexInsertPoint;
+    IndexCache indexCache;
     ConvertTritonGPUOpToLLVMPatternBase::IndexCacheInfo indexCacheInfo{
-        &baseIndexCache, &indexCache, &indexInsertPoint};
-    // TODO: enable index cache if there are multiple functions
-    if (axisInfoAnalysis.getNumFunctions() > 1) {
-      indexCacheInfo = {nullptr, nullptr, nullptr};
-    }
+        &indexCache};
     populateTritonGPUToLLVMPatterns(typeConverter, patterns, allocation,
                                     indexCacheInfo, /*benefit=*/1);
     populateConvertLayoutOpToLLVMPatterns(typeConverter, patterns, allocation,
                                           indexCacheInfo, /*benefit=*/1);
     populateDotOpToLLVMPatterns(typeConverter, patterns, allocation,
                                 /*benefit=*/1);
-    populateElementwiseOpToLLVMPatterns(typeConverter, patterns, /*benefit=*/1);
+    populateElementwiseOpToLLVMPatterns(typeConverter, patterns,
+                                        computeCapability, nativeFp8,
+                                        /*benefit=*/1);
     populateLoadStoreOpToLLVMPatterns(typeConverter, patterns, axisInfoAnalysis,
                                       allocation, indexCacheInfo,
-                                      /*benefit=*/1);
+                                      computeCapability, /*benefit=*/1);
     populateReduceOpToLLVMPatterns(typeConverter, patterns, allocation,
-                                   indexCacheInfo, /*benefit=*/1);
+                                   indexCacheInfo, computeCapability,
+                                   /*benefit=*/1);
     populateScanOpToLLVMPatterns(typeConverter, patterns, allocation,
                                  indexCacheInfo, /*benefit=*/1);
     populateViewOpToLLVMPatterns(typeConverter, patterns, /*benefit=*/1);
@@ -389,19 +392,11 @@ public:
                                                           patterns);
     if (failed(applyPartialConversion(mod, target, std::move(patterns))))
       return signalPassFailure();
+    numIndexCacheHits = indexCache.getNumHits();
+    numIndexCacheMisses = indexCache.getNumMisses();
   }
 
 private:
-  using IndexCacheKeyT = std::pair<Attribute, RankedTensorType>;
-  DenseMap<IndexCacheKeyT, SmallVector<Value>, CacheKeyDenseMapInfo>
-      baseIndexCache;
-  DenseMap<IndexCacheKeyT, SmallVector<SmallVector<Value>>,
-           CacheKeyDenseMapInfo>
-      indexCache;
-
-  int computeCapability{};
-  bool isROCM{};
-
   void initSharedMemory(ModuleAllocation &allocation,
                         TritonGPUToLLVMTypeConverter &typeConverter) {
     ModuleOp mod = getOperation();
@@ -603,8 +598,10 @@ namespace mlir {
 namespace triton {
 
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertTritonGPUToLLVMPass(int computeCapability, bool isROCM) {
-  return std::make_unique<::ConvertTritonGPUToLLVM>(computeCapability, isROCM);
+createConvertTritonGPUToLLVMPass(int computeCapability, bool isROCM,
+                                 bool nativeFp8) {
+  return std::make_unique<::ConvertTritonGPUToLLVM>(computeCapability, isROCM,
+                                                    nativeFp8);
 }
 
 } // namespace triton
@@ -160,33 +160,107 @@ Value storeShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
   return builder.launch(rewriter, loc, void_ty(ctx));
 }
 
-static Value commonShflSync(Location loc, ConversionPatternRewriter &rewriter,
-                            Value val, int i, const std::string &shuffleType,
-                            const std::string &clamp) {
-  unsigned bits = val.getType().getIntOrFloatBitWidth();
+// The lane operand is built by `getLane` so that immediate and register lanes
+// share the 64-bit split and the sub-word widening
+static Value
+commonShflSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
+               function_ref<PTXBuilder::Operand *(PTXBuilder &)> getLane,
+               const std::string &shuffleType, const std::string &clamp) {
+  Type type = val.getType();
+  unsigned bits = type.getIntOrFloatBitWidth();
 
   if (bits == 64) {
     Type vecTy = vec_ty(f32_ty, 2);
     Value vec = bitcast(val, vecTy);
     Value val0 = extract_element(f32_ty, vec, i32_val(0));
     Value val1 = extract_element(f32_ty, vec, i32_val(1));
-    val0 = commonShflSync(loc, rewriter, val0, i, shuffleType, clamp);
-    val1 = commonShflSync(loc, rewriter, val1, i, shuffleType, clamp);
+    val0 = commonShflSync(loc, rewriter, val0, getLane, shuffleType, clamp);
+    val1 = commonShflSync(loc, rewriter, val1, getLane, shuffleType, clamp);
     vec = undef(vecTy);
     vec = insert_element(vecTy, vec, val0, i32_val(0));
     vec = insert_element(vecTy, vec, val1, i32_val(1));
-    return bitcast(vec, val.getType());
+    return bitcast(vec, type);
+  }
+  if (bits < 32) {
+    Value word = type.isa<IntegerType>() ? val : bitcast(val, int_ty(bits));
+    word = commonShflSync(loc, rewriter, zext(i32_ty, word), getLane,
+                          shuffleType, clamp);
+    word = rewriter.create<LLVM::TruncOp>(loc, int_ty(bits), word);
+    return type.isa<IntegerType>() ? word : bitcast(word, type);
   }
 
   PTXBuilder builder;
   auto &shfl = builder.create("shfl.sync")->o(shuffleType).o("b32");
   auto *dOpr = builder.newOperand("=r");
   auto *aOpr = builder.newOperand(val, "r");
-  auto *bOpr = builder.newConstantOperand(i);
+  auto *bOpr = getLane(builder);
   auto *cOpr = builder.newConstantOperand(clamp);
   auto *maskOpr = builder.newConstantOperand("0xffffffff");
   shfl(dOpr, aOpr, bOpr, cOpr, maskOpr);
-  return builder.launch(rewriter, loc, val.getType(), false);
+  return builder.launch(rewriter, loc, type, false);
+}
+
+static Value commonShflSync(Location loc, ConversionPatternRewriter &rewriter,
+                            Value val, int i, const std::string &shuffleType,
+                            const std::string &clamp) {
+  return commonShflSync(
+      loc, rewriter, val,
+      [&](PTXBuilder &builder) { return builder.newConstantOperand(i); },
+      shuffleType, clamp);
+}
+
+// Values narrower than 32 bits are packed into 32-bit words so that they share
+// shuffles, the others are shuffled on their own
+static SmallVector<Value>
+commonShflSync(Location loc, ConversionPatternRewriter &rewriter,
+               ArrayRef<Value> vals, int i, const std::string &shuffleType,
+               const std::string &clamp) {
+  SmallVector<Value> results(vals.size());
+  SmallVector<unsigned> wordVals;
+  unsigned wordBits = 0;
+  auto shuffleWord = [&]() {
+    if (wordVals.empty())
+      return;
+    Value word = i32_val(0);
+    unsigned offset = 0;
+    for (unsigned idx : wordVals) {
+      Type type = vals[idx].getType();
+      unsigned bits = type.getIntOrFloatBitWidth();
+      Value bitsVal = vals[idx];
+      if (!type.isa<IntegerType>())
+        bitsVal = bitcast(bitsVal, int_ty(bits));
+      word = or_(word, shl(zext(i32_ty, bitsVal), i32_val(offset)));
+      offset += bits;
+    }
+    word = commonShflSync(loc, rewriter, word, i, shuffleType, clamp);
+    offset = 0;
+    for (unsigned idx : wordVals) {
+      Type type = vals[idx].getType();
+      unsigned bits = type.getIntOrFloatBitWidth();
+      Value bitsVal = rewriter.create<LLVM::TruncOp>(
+          loc, int_ty(bits),
+          rewriter.create<LLVM::LShrOp>(loc, word, i32_val(offset)));
+      results[idx] =
+          type.isa<IntegerType>() ? bitsVal : bitcast(bitsVal, type);
+      offset += bits;
+    }
+    wordVals.clear();
+    wordBits = 0;
+  };
+
+  for (auto [idx, val] : llvm::enumerate(vals)) {
+    unsigned bits = val.getType().getIntOrFloatBitWidth();
+    if (bits >= 32) {
+      results[idx] = commonShflSync(loc, rewriter, val, i, shuffleType, clamp);
+      continue;
+    }
+    if (wordBits + bits > 32)
+      shuffleWord();
+    wordVals.push_back(idx);
+    wordBits += bits;
+  }
+  shuffleWord();
+  return results;
 }
 
 Value shflSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
@@ -194,11 +268,51 @@ Value shflSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
   return commonShflSync(loc, rewriter, val, i, "bfly", "0x1f");
 }
 
+SmallVector<Value> shflSync(Location loc, ConversionPatternRewriter &rewriter,
+                            ArrayRef<Value> vals, int i) {
+  return commonShflSync(loc, rewriter, vals, i, "bfly", "0x1f");
+}
+
 Value shflUpSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
                  int i) {
   return commonShflSync(loc, rewriter, val, i, "up", "0x0");
 }
 
+SmallVector<Value> shflUpSync(Location loc, ConversionPatternRewriter &rewriter,
+                              ArrayRef<Value> vals, int i) {
+  return commonShflSync(loc, rewriter, vals, i, "up", "0x0");
+}
+
+Value shflDownSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                   int i) {
+  return commonShflSync(loc, rewriter, val, i, "down", "0x1f");
+}
+
+SmallVector<Value> shflDownSync(Location loc,
+                                ConversionPatternRewriter &rewriter,
+                                ArrayRef<Value> vals, int i) {
+  return commonShflSync(loc, rewriter, vals, i, "down", "0x1f");
+}
+
+Value reduxSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                StringRef kind) {
+  PTXBuilder builder;
+  auto &redux = builder.create("redux.sync")->o(kind.str());
+  auto *dOpr = builder.newOperand("=r");
+  auto *aOpr = builder.newOperand(val, "r");
+  auto *maskOpr = builder.newConstantOperand("0xffffffff");
+  redux(dOpr, aOpr, maskOpr);
+  return builder.launch(rewriter, loc, val.getType(), false);
+}
+
+Value shflIdxSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                  Value i) {
+  return commonShflSync(
+      loc, rewriter, val,
+      [&](PTXBuilder &builder) { return builder.newOperand(i, "r"); }, "idx",
+      "0x1f");
+}
+
 Value addStringToModule(Location loc, ConversionPatternRewriter &rewriter,
                         StringRef key, StringRef content) {
   auto moduleOp = rewriter.getBlock()->getParent()->getParentOfType<ModuleOp>();
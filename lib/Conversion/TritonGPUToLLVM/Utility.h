@@ -287,6 +287,23 @@ Value shflSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
                int i);
 Value shflUpSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
                  int i);
+Value shflDownSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                   int i);
+// Shuffles several values at once, packing the ones narrower than 32 bits
+// into shared 32-bit shuffles
+SmallVector<Value> shflSync(Location loc, ConversionPatternRewriter &rewriter,
+                            ArrayRef<Value> vals, int i);
+SmallVector<Value> shflUpSync(Location loc, ConversionPatternRewriter &rewriter,
+                              ArrayRef<Value> vals, int i);
+SmallVector<Value> shflDownSync(Location loc,
+                                ConversionPatternRewriter &rewriter,
+                                ArrayRef<Value> vals, int i);
+// Reduces the 32-bit integer `val` across the warp with redux.sync (sm_80+),
+// `kind` is the operation and type suffix, e.g. "add.s32"
+Value reduxSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                StringRef kind);
+Value shflIdxSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
+                  Value i);
 
 Value addStringToModule(Location loc, ConversionPatternRewriter &rewriter,
                         StringRef key, StringRef content);
@@ -558,7 +558,8 @@ struct TritonScanPattern : public OpConversionPattern<triton::ScanOp> {
   matchAndRewrite(triton::ScanOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     auto newScan = rewriter.create<triton::ScanOp>(
-        op.getLoc(), adaptor.getOperands(), adaptor.getAxis());
+        op.getLoc(), adaptor.getOperands(), adaptor.getAxis(),
+        adaptor.getReverse(), adaptor.getExclusive());
     addNamedAttrs(newScan, adaptor.getAttributes());
 
     auto &newCombineOp = newScan.getCombineOp();
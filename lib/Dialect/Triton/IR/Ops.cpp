@@ -1,3 +1,4 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
@@ -561,11 +562,13 @@ unsigned ReduceOp::getNumOperands() { return this->getOperands().size(); }
 
 //-- ScanOp --
 void ScanOp::build(mlir::OpBuilder &builder, mlir::OperationState &state,
-                   mlir::ValueRange operands, int axis) {
+                   mlir::ValueRange operands, int axis, bool reverse,
+                   bool exclusive) {
   SmallVector<Type> inferredReturnTypes;
   for (auto arg : operands)
     inferredReturnTypes.push_back(arg.getType());
-  ReduceOp::build(builder, state, inferredReturnTypes, operands, axis);
+  ScanOp::build(builder, state, inferredReturnTypes, operands, axis, reverse,
+                exclusive);
 }
 
 mlir::LogicalResult mlir::triton::ScanOp::inferReturnTypes(
@@ -586,9 +589,29 @@ mlir::LogicalResult mlir::triton::ScanOp::verify() {
       return this->emitOpError() << "operands must be RankedTensorType";
     }
   }
+  if (getExclusive() && !getNeutralElement()) {
+    return this->emitOpError()
+           << "exclusive scan needs a combine region with a neutral element";
+  }
   return success();
 }
 
+std::optional<TypedAttr> ScanOp::getNeutralElement() {
+  Block &block = getCombineOp().front();
+  if (block.getNumArguments() != 2 || block.getOperations().size() != 2)
+    return std::nullopt;
+  Operation &combine = block.front();
+  if (combine.getNumOperands() != 2 || combine.getNumResults() != 1 ||
+      block.getTerminator()->getOperand(0) != combine.getResult(0))
+    return std::nullopt;
+  Value lhs = combine.getOperand(0);
+  Value rhs = combine.getOperand(1);
+  if (lhs == rhs || !llvm::is_contained(block.getArguments(), lhs) ||
+      !llvm::is_contained(block.getArguments(), rhs))
+    return std::nullopt;
+  return arith::getNeutralElement(&combine);
+}
+
 //-- SplatOp --
 OpFoldResult SplatOp::fold(FoldAdaptor adaptor) {
   auto value = adaptor.getSrc();
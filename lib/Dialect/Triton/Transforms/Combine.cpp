@@ -100,6 +100,54 @@ public:
   }
 };
 
+// addptr(addptr(ptr, cst0), cst1) => addptr(ptr, cst0 + cst1)
+// addptr(addptr(ptr, cst), idx) => addptr(addptr(ptr, idx), cst)
+// Constant offsets are kept outermost so that they can be folded into the
+// immediate offset of loads and stores
+class CombineAddPtrPattern : public mlir::OpRewritePattern<triton::AddPtrOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+
+  mlir::LogicalResult
+  matchAndRewrite(triton::AddPtrOp op,
+                  mlir::PatternRewriter &rewriter) const override {
+    auto innerOp = op.getPtr().getDefiningOp<triton::AddPtrOp>();
+    if (!innerOp)
+      return mlir::failure();
+    APInt innerOffset, outerOffset;
+    if (!mlir::matchPattern(innerOp.getOffset(), m_ConstantInt(&innerOffset)))
+      return mlir::failure();
+
+    if (!mlir::matchPattern(op.getOffset(), m_ConstantInt(&outerOffset))) {
+      if (!innerOp->hasOneUse())
+        return mlir::failure();
+      Value ptr = rewriter.create<triton::AddPtrOp>(
+          op.getLoc(), op.getType(), innerOp.getPtr(), op.getOffset());
+      rewriter.replaceOpWithNewOp<triton::AddPtrOp>(op, op.getType(), ptr,
+                                                    innerOp.getOffset());
+      return mlir::success();
+    }
+
+    // Offsets of different widths are extended separately
+    Type offsetType = op.getOffset().getType();
+    if (innerOp.getOffset().getType() != offsetType)
+      return mlir::failure();
+    bool overflow = false;
+    APInt sum = innerOffset.sadd_ov(outerOffset, overflow);
+    if (overflow)
+      return mlir::failure();
+    TypedAttr sumAttr;
+    if (auto shapedType = offsetType.dyn_cast<ShapedType>())
+      sumAttr = DenseElementsAttr::get(shapedType, sum);
+    else
+      sumAttr = IntegerAttr::get(offsetType, sum);
+    Value offset = rewriter.create<arith::ConstantOp>(op.getLoc(), sumAttr);
+    rewriter.replaceOpWithNewOp<triton::AddPtrOp>(op, op.getType(),
+                                                  innerOp.getPtr(), offset);
+    return mlir::success();
+  }
+};
+
 // sum(x[:, :, None] * y[None, :, :], 1)
 // -> dot(x, y)
 class CombineBroadcastMulReducePattern : public mlir::RewritePattern {
@@ -204,7 +252,7 @@ public:
     patterns.add<CombineDotAddFRevPattern>(context);
     // %}
     patterns.add<CombineSelectMaskedLoadPattern>(context);
-    // patterns.add<CombineAddPtrPattern>(context);
+    patterns.add<CombineAddPtrPattern>(context);
     patterns.add<CombineBroadcastConstantPattern>(context);
     patterns.add<CombineBroadcastMulReducePattern>(context);
 
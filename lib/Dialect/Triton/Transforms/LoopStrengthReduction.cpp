@@ -0,0 +1,192 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include <memory>
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace {
+
+/// Offsets that are affine functions of the induction variable of a loop, and
+/// the loop-invariant amount by which they grow from one iteration to the next
+class AffineOffsets {
+  scf::ForOp forOp;
+  OpBuilder &builder;
+
+  bool isInvariant(Value v) { return forOp.isDefinedOutsideOfLoop(v); }
+
+  Value zeroLike(Value v) {
+    return builder.create<arith::ConstantOp>(
+        forOp.getLoc(), v.getType(), builder.getZeroAttr(v.getType()));
+  }
+
+public:
+  AffineOffsets(scf::ForOp forOp, OpBuilder &builder)
+      : forOp(forOp), builder(builder) {}
+
+  bool isAffine(Value v) {
+    if (isInvariant(v) || v == forOp.getInductionVar())
+      return true;
+    Operation *op = v.getDefiningOp();
+    if (!op || op->getBlock() != forOp.getBody())
+      return false;
+    if (isa<arith::IndexCastOp, triton::SplatOp, triton::BroadcastOp,
+            triton::ExpandDimsOp>(op))
+      return isAffine(op->getOperand(0));
+    if (isa<arith::AddIOp, arith::SubIOp>(op))
+      return isAffine(op->getOperand(0)) && isAffine(op->getOperand(1));
+    if (isa<arith::MulIOp>(op))
+      return (isInvariant(op->getOperand(0)) && isAffine(op->getOperand(1))) ||
+             (isInvariant(op->getOperand(1)) && isAffine(op->getOperand(0)));
+    if (isa<arith::ShLIOp>(op))
+      return isInvariant(op->getOperand(1)) && isAffine(op->getOperand(0));
+    return false;
+  }
+
+  /// The value of affine `v` at the iteration where the induction variable is
+  /// `iv`, built in front of the loop
+  Value getValueAt(Value v, Value iv, IRMapping &mapping) {
+    if (isInvariant(v))
+      return v;
+    if (v == forOp.getInductionVar())
+      return iv;
+    if (Value mapped = mapping.lookupOrNull(v))
+      return mapped;
+    Operation *op = v.getDefiningOp();
+    for (Value operand : op->getOperands())
+      mapping.map(operand, getValueAt(operand, iv, mapping));
+    return builder.clone(*op, mapping)->getResult(0);
+  }
+
+  /// The increment of affine `v` per iteration of the loop, built in front of
+  /// the loop, or a null value if it is zero
+  Value getIncrement(Value v) {
+    if (isInvariant(v))
+      return Value();
+    if (v == forOp.getInductionVar())
+      return forOp.getStep();
+    Operation *op = v.getDefiningOp();
+    if (isa<arith::IndexCastOp, triton::SplatOp, triton::BroadcastOp,
+            triton::ExpandDimsOp>(op)) {
+      Value inc = getIncrement(op->getOperand(0));
+      if (!inc)
+        return Value();
+      IRMapping mapping;
+      mapping.map(op->getOperand(0), inc);
+      return builder.clone(*op, mapping)->getResult(0);
+    }
+    if (isa<arith::AddIOp, arith::SubIOp>(op)) {
+      Value lhs = getIncrement(op->getOperand(0));
+      Value rhs = getIncrement(op->getOperand(1));
+      if (!rhs)
+        return lhs;
+      if (!lhs) {
+        if (isa<arith::AddIOp>(op))
+          return rhs;
+        lhs = zeroLike(rhs);
+      }
+      IRMapping mapping;
+      mapping.map(op->getOperand(0), lhs);
+      mapping.map(op->getOperand(1), rhs);
+      return builder.clone(*op, mapping)->getResult(0);
+    }
+    // x * c, c * x and x << c
+    unsigned affineIdx =
+        isa<arith::MulIOp>(op) && isInvariant(op->getOperand(0)) ? 1 : 0;
+    Value inc = getIncrement(op->getOperand(affineIdx));
+    if (!inc)
+      return Value();
+    IRMapping mapping;
+    mapping.map(op->getOperand(affineIdx), inc);
+    return builder.clone(*op, mapping)->getResult(0);
+  }
+};
+
+class LoopStrengthReductionPass
+    : public TritonLoopStrengthReductionBase<LoopStrengthReductionPass> {
+public:
+  void reduce(scf::ForOp forOp);
+
+  void runOnOperation() override {
+    // Post-order: the initial pointers of an inner loop may then be reduced
+    // in the outer one
+    SmallVector<scf::ForOp> loops;
+    getOperation().walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+    for (scf::ForOp forOp : loops)
+      reduce(forOp);
+  }
+};
+
+void LoopStrengthReductionPass::reduce(scf::ForOp forOp) {
+  OpBuilder builder(forOp);
+  AffineOffsets offsets(forOp, builder);
+  SmallVector<triton::AddPtrOp> addPtrs;
+  for (auto addPtrOp : forOp.getBody()->getOps<triton::AddPtrOp>())
+    if (forOp.isDefinedOutsideOfLoop(addPtrOp.getPtr()) &&
+        !forOp.isDefinedOutsideOfLoop(addPtrOp.getOffset()) &&
+        offsets.isAffine(addPtrOp.getOffset()))
+      addPtrs.push_back(addPtrOp);
+  if (addPtrs.empty())
+    return;
+
+  // Start the pointers at the first iteration and advance them by the
+  // increment of their offsets
+  SmallVector<Value> newIterOperands = forOp.getIterOperands();
+  SmallVector<Value> increments;
+  for (triton::AddPtrOp addPtrOp : addPtrs) {
+    IRMapping mapping;
+    Value offset = addPtrOp.getOffset();
+    Value initOffset =
+        offsets.getValueAt(offset, forOp.getLowerBound(), mapping);
+    newIterOperands.push_back(builder.create<triton::AddPtrOp>(
+        addPtrOp.getLoc(), addPtrOp.getType(), addPtrOp.getPtr(),
+        initOffset));
+    increments.push_back(offsets.getIncrement(offset));
+  }
+  auto newForOp = builder.create<scf::ForOp>(
+      forOp.getLoc(), forOp.getLowerBound(), forOp.getUpperBound(),
+      forOp.getStep(), newIterOperands);
+  Block *newBody = newForOp.getBody();
+  newBody->getOperations().splice(newBody->end(),
+                                  forOp.getBody()->getOperations());
+  forOp.getInductionVar().replaceAllUsesWith(newForOp.getInductionVar());
+  for (auto [oldArg, newArg] :
+       llvm::zip(forOp.getRegionIterArgs(), newForOp.getRegionIterArgs()))
+    oldArg.replaceAllUsesWith(newArg);
+
+  auto yieldOp = cast<scf::YieldOp>(newBody->getTerminator());
+  builder.setInsertionPoint(yieldOp);
+  unsigned numIterArgs = forOp.getNumIterOperands();
+  for (auto [i, addPtrOp] : llvm::enumerate(addPtrs)) {
+    Value ptr = newForOp.getRegionIterArgs()[numIterArgs + i];
+    Value next = ptr;
+    if (increments[i])
+      next = builder.create<triton::AddPtrOp>(addPtrOp.getLoc(), ptr.getType(),
+                                              ptr, increments[i]);
+    yieldOp->insertOperands(yieldOp->getNumOperands(), next);
+    addPtrOp.replaceAllUsesWith(ptr);
+    addPtrOp.erase();
+  }
+  for (auto [oldResult, newResult] :
+       llvm::zip(forOp.getResults(), newForOp.getResults()))
+    oldResult.replaceAllUsesWith(newResult);
+  forOp.erase();
+
+  // Remove the offset computations that are no longer used
+  for (Operation &op : llvm::make_early_inc_range(llvm::reverse(*newBody)))
+    if (isOpTriviallyDead(&op))
+      op.erase();
+}
+
+} // namespace
+
+std::unique_ptr<Pass> triton::createLoopStrengthReductionPass() {
+  return std::make_unique<LoopStrengthReductionPass>();
+}
@@ -1,4 +1,5 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/Pass/Pass.h"
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/Triton/Transforms/Passes.h"
@@ -21,8 +22,14 @@ private:
   SmallVector<Value> offsets;
   ArrayRef<int64_t> tensorShape;
 
-  // A cache to avoid generating the same offset with range
-  DenseMap<unsigned, Value> cachedOffsetWithRange;
+  // The offsets of every element of the block relative to its first element.
+  // They only depend on the strides, so they are generated once, where the
+  // tensor pointer is made, and reused by every load/store in a loop
+  Value elementOffsets;
+
+  // The ranges of the block along each dimension, expanded to its rank. They
+  // are loop-invariant too, and used for the boundary checks
+  SmallVector<Value> elementRanges;
 
 public:
   RewritedInfo() = default;
@@ -41,77 +48,83 @@ public:
 
   unsigned int length() const { return shape.size(); }
 
+  // The constant value of `v`, looking through the sign extension of offsets
+  static std::optional<int64_t> getConstant(Value v) {
+    if (auto extOp = v.getDefiningOp<arith::ExtSIOp>())
+      v = extOp.getIn();
+    return getConstantIntValue(v);
+  }
+
   Value getOffset(unsigned i) { return offsets[i]; }
 
   SmallVector<Value> getOffsets() { return offsets; }
 
-  void setOffset(unsigned i, Value newOffset) {
-    offsets[i] = newOffset;
-    cachedOffsetWithRange.clear();
-  }
+  void setOffset(unsigned i, Value newOffset) { offsets[i] = newOffset; }
 
   void setOffsets(const SmallVector<Value> &newOffsets) {
     offsets = newOffsets;
-    cachedOffsetWithRange.clear();
   }
 
-  Value getExpandedOffsetWithRange(OpBuilder &builder, const Location &loc,
-                                   unsigned i) {
-    if (cachedOffsetWithRange.count(i))
-      return cachedOffsetWithRange[i];
-
-    // Add range
-    auto indexI32RowType =
-        RankedTensorType::get({tensorShape[i]}, builder.getI32Type());
-    auto indexRowType =
-        RankedTensorType::get({tensorShape[i]}, builder.getI64Type());
-    Value splatOffset =
-        builder.create<triton::SplatOp>(loc, indexRowType, offsets[i]);
-    Value range = builder.create<triton::MakeRangeOp>(loc, indexI32RowType, 0,
-                                                      tensorShape[i]);
-    Value i64Range = builder.create<arith::ExtSIOp>(loc, indexRowType, range);
-
-    // Expand dimensions
-    Value expandedResult =
-        builder.create<arith::AddIOp>(loc, splatOffset, i64Range);
-    for (int j = 0; j < tensorShape.size(); ++j) {
-      if (j == i)
-        continue;
-      expandedResult =
-          builder.create<triton::ExpandDimsOp>(loc, expandedResult, j);
-    }
+  void generateElementOffsets(OpBuilder &builder, const Location &loc) {
+    auto indexTensorType =
+        RankedTensorType::get(tensorShape, builder.getI64Type());
+    elementOffsets = Value();
+    elementRanges.clear();
+    for (unsigned i = 0; i < tensorShape.size(); ++i) {
+      // Generate the range of the dimension and expand it
+      auto indexI32RowType =
+          RankedTensorType::get({tensorShape[i]}, builder.getI32Type());
+      auto indexRowType =
+          RankedTensorType::get({tensorShape[i]}, builder.getI64Type());
+      Value range = builder.create<triton::MakeRangeOp>(loc, indexI32RowType,
+                                                        0, tensorShape[i]);
+      Value expandedRange =
+          builder.create<arith::ExtSIOp>(loc, indexRowType, range);
+      for (int j = 0; j < tensorShape.size(); ++j) {
+        if (j == i)
+          continue;
+        expandedRange =
+            builder.create<triton::ExpandDimsOp>(loc, expandedRange, j);
+      }
+      elementRanges.push_back(expandedRange);
+
+      // We must splat strides into the expanded shape not a row for retaining
+      // the divisibility information given by strides
+      Value splatStride = builder.create<triton::SplatOp>(
+          loc, expandedRange.getType(), strides[i]);
+      Value rangeWithStride =
+          builder.create<arith::MulIOp>(loc, expandedRange, splatStride);
+      Value broadcasted = builder.create<triton::BroadcastOp>(
+          loc, indexTensorType, rangeWithStride);
 
-    return cachedOffsetWithRange[i] = expandedResult;
+      elementOffsets =
+          elementOffsets
+              ? builder.create<arith::AddIOp>(loc, elementOffsets, broadcasted)
+              : broadcasted;
+    }
   }
 
   Value generatePtr(OpBuilder &builder, const Location &loc) {
     assert(tensorShape.size() == offsets.size() &&
            tensorShape.size() == strides.size());
-    auto indexTensorType =
-        RankedTensorType::get(tensorShape, builder.getI64Type());
+    assert(elementOffsets && "element offsets should have been generated");
     auto ptrType = base.getType().cast<triton::PointerType>();
     auto ptrTensorType = RankedTensorType::get(tensorShape, ptrType);
 
-    // Generate offsets per dimension
-    Value ptr = builder.create<triton::SplatOp>(loc, ptrTensorType, base);
+    // Only the address of the first element depends on the offsets, so it is
+    // computed on scalars
+    Value scalarPtr = base;
     for (unsigned i = 0; i < tensorShape.size(); ++i) {
-      auto offsetWithRange = getExpandedOffsetWithRange(builder, loc, i);
-
-      // We must splat strides into the expanded shape not a row for retaining
-      // the divisibility information given by strides
-      Value splatStride = builder.create<triton::SplatOp>(
-          loc, offsetWithRange.getType(), strides[i]);
       Value offsetWithStride =
-          builder.create<arith::MulIOp>(loc, offsetWithRange, splatStride);
-      Value broadcasted = builder.create<triton::BroadcastOp>(
-          loc, indexTensorType, offsetWithStride);
-
-      // Add to the pointer
-      ptr = builder.create<triton::AddPtrOp>(loc, ptrTensorType, ptr,
-                                             broadcasted);
+          builder.create<arith::MulIOp>(loc, offsets[i], strides[i]);
+      scalarPtr = builder.create<triton::AddPtrOp>(loc, ptrType, scalarPtr,
+                                                   offsetWithStride);
     }
 
-    return ptr;
+    // Add the loop-invariant offsets of the elements
+    Value ptr = builder.create<triton::SplatOp>(loc, ptrTensorType, scalarPtr);
+    return builder.create<triton::AddPtrOp>(loc, ptrTensorType, ptr,
+                                            elementOffsets);
   }
 
   Value generateMask(OpBuilder &builder, const Location &loc,
@@ -119,31 +132,45 @@ public:
     if (!boundaryCheck.has_value())
       return {};
 
-    // Generate mask per dimension
+    // Generate mask per dimension. The element ranges are loop-invariant, so
+    // `0 <= offset + range < shape` is checked as `-offset <= range < shape -
+    // offset`: only the bounds, which are scalars, are computed in a loop
     auto maskTensorType =
         RankedTensorType::get(tensorShape, builder.getI1Type());
     Value mask;
     for (auto i : boundaryCheck.value()) {
-      auto offsetWithRange = getExpandedOffsetWithRange(builder, loc, i);
+      auto offset = getConstant(offsets[i]);
+      auto size = getConstant(shape[i]);
+      // Skip the dimensions that are statically in bounds
+      if (offset && size && *offset >= 0 && *offset + tensorShape[i] <= *size)
+        continue;
 
-      // Compare with lower bound
-      Value lowerBound = builder.create<mlir::arith::ConstantIntOp>(
-          loc, 0, builder.getI64Type());
-      Value splatLowerBound = builder.create<triton::SplatOp>(
-          loc, offsetWithRange.getType(), lowerBound);
-      Value cmpLower = builder.create<arith::CmpIOp>(
-          loc, arith::CmpIPredicate::sge, offsetWithRange, splatLowerBound);
+      Value range = elementRanges[i];
+      auto rangeType = range.getType();
 
       // Compare with upper bound
-      Value splatUpperBound = builder.create<triton::SplatOp>(
-          loc, offsetWithRange.getType(), shape[i]);
-      Value cmpUpper = builder.create<arith::CmpIOp>(
-          loc, arith::CmpIPredicate::slt, offsetWithRange, splatUpperBound);
+      Value upperBound =
+          builder.create<arith::SubIOp>(loc, shape[i], offsets[i]);
+      Value splatUpperBound =
+          builder.create<triton::SplatOp>(loc, rangeType, upperBound);
+      Value inBounds = builder.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::slt, range, splatUpperBound);
+
+      // Compare with lower bound, unless the offset is known non-negative
+      if (!offset || *offset < 0) {
+        Value zero = builder.create<mlir::arith::ConstantIntOp>(
+            loc, 0, builder.getI64Type());
+        Value lowerBound = builder.create<arith::SubIOp>(loc, zero, offsets[i]);
+        Value splatLowerBound =
+            builder.create<triton::SplatOp>(loc, rangeType, lowerBound);
+        Value cmpLower = builder.create<arith::CmpIOp>(
+            loc, arith::CmpIPredicate::sge, range, splatLowerBound);
+        inBounds = builder.create<arith::AndIOp>(loc, cmpLower, inBounds);
+      }
 
-      // And and broadcast
-      Value andResult = builder.create<arith::AndIOp>(loc, cmpLower, cmpUpper);
+      // Broadcast
       Value broadcasted =
-          builder.create<triton::BroadcastOp>(loc, maskTensorType, andResult);
+          builder.create<triton::BroadcastOp>(loc, maskTensorType, inBounds);
 
       // And up all results
       if (!mask) {
@@ -233,9 +260,10 @@ public:
     }
 
     // Save information
-    rewritedInfo[op.getResult()] =
-        RewritedInfo(op.getBase(), op.getShape(), op.getStrides(), i64Offsets,
-                     tensorType.getShape());
+    RewritedInfo info(op.getBase(), op.getShape(), op.getStrides(), i64Offsets,
+                      tensorType.getShape());
+    info.generateElementOffsets(builder, op.getLoc());
+    rewritedInfo[op.getResult()] = info;
 
     // Erase the original operation
     eraser.push(op);
@@ -297,12 +325,14 @@ public:
     // Generate new `ptr`, `mask` and `other`
     auto newPtr = info.generatePtr(builder, op->getLoc());
     auto newMask = info.generateMask(builder, op->getLoc(), boundaryCheck);
+    // `other` is only allowed with a mask, which may have been elided
     Value newOther;
-    if (auto loadOp = dyn_cast<triton::LoadOp>(op))
+    auto loadOp = dyn_cast<triton::LoadOp>(op);
+    if (newMask && loadOp)
       newOther = info.generateOther(builder, op->getLoc(), loadOp.getPadding());
 
     // Create a new operation
-    if (auto loadOp = dyn_cast<triton::LoadOp>(op)) {
+    if (loadOp) {
       auto newResult = builder.create<triton::LoadOp>(
           loadOp.getLoc(), newPtr, newMask, newOther, loadOp.getCache(),
           loadOp.getEvict(), loadOp.getIsVolatile());
@@ -3,6 +3,7 @@
 #include "triton/Analysis/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include <limits>
 #include <memory>
 
 using namespace mlir;
@@ -41,34 +42,83 @@ SmallVector<int64_t, 2> mmaVersionToShapePerWarp(int version) {
   }
 }
 
+// Accumulator registers per thread above which a warp tile is assumed to spill
+constexpr int64_t maxAccumulatorRegisters = 128;
+
+// Estimated bytes moved by `dotOp` over its whole K when its warps are
+// arranged as `warpsPerTile`. Every warp reads its rows of a and its columns
+// of b from shared memory, so square warp tiles maximize operand reuse. Warps
+// smaller than one instruction tile replicate it, and accumulators above the
+// register budget spill to local memory.
+int64_t getWarpTileCost(triton::DotOp dotOp, ArrayRef<unsigned> warpsPerTile) {
+  SmallVector<int64_t, 2> shapePerWarp = mmaVersionToShapePerWarp(2);
+  auto retType = dotOp.getType().cast<RankedTensorType>();
+  auto aType = dotOp.getA().getType().cast<RankedTensorType>();
+  auto shape = retType.getShape();
+  int64_t kSize = aType.getShape()[1];
+  int64_t elementBytes =
+      std::max<int64_t>(1, aType.getElementTypeBitWidth() / 8);
+  int64_t accBits = retType.getElementTypeBitWidth();
+
+  int64_t numWarps = warpsPerTile[0] * warpsPerTile[1];
+  int64_t warpM = std::max(shapePerWarp[0], shape[0] / warpsPerTile[0]);
+  int64_t warpN = std::max(shapePerWarp[1], shape[1] / warpsPerTile[1]);
+
+  // operand reads from shared memory
+  int64_t cost = numWarps * (warpM + warpN) * kSize * elementBytes;
+  // replicated instruction tiles read their operands again
+  int64_t instrTile = shapePerWarp[0] * shapePerWarp[1];
+  int64_t wastedTiles =
+      (numWarps * warpM * warpN - shape[0] * shape[1]) / instrTile;
+  cost += wastedTiles * (shapePerWarp[0] + shapePerWarp[1]) * kSize *
+          elementBytes;
+  // accumulator spills are stored and reloaded for every K step
+  int64_t accRegisters = warpM * warpN * accBits / 32 / 32;
+  if (accRegisters > maxAccumulatorRegisters)
+    cost += 2 * (accRegisters - maxAccumulatorRegisters) * 4 * 32 * numWarps *
+            kSize / shapePerWarp[0];
+  return cost;
+}
+
+// Warps are arranged jointly for all the dots of a chain (e.g. the two dots
+// of attention): the accumulator of a dot only feeds the a operand of the
+// next one in registers if both have a single warp along N. Otherwise it
+// round-trips through shared memory.
 SmallVector<unsigned, 2> warpsPerTileV2(triton::DotOp dotOp,
                                         const ArrayRef<int64_t> shape,
                                         int numWarps) {
   mlir::TransitiveFilter filter = [&dotOp](Operation *op) {
     return op->getParentRegion() == dotOp->getParentRegion();
   };
-  auto slices = mlir::getSlice(dotOp, {filter});
-  for (Operation *op : slices)
-    if (isa<triton::DotOp>(op) && (op != dotOp))
-      return {(unsigned)numWarps, 1};
-
-  SmallVector<unsigned, 2> ret = {1, 1};
-  SmallVector<int64_t, 2> shapePerWarp = {16, 8};
-  bool changed = false;
-  do {
-    changed = false;
-    if (ret[0] * ret[1] >= numWarps)
-      break;
-    if (shape[0] / shapePerWarp[0] / ret[0] >=
-        shape[1] / (shapePerWarp[1] * 2) / ret[1]) {
-      if (ret[0] < shape[0] / shapePerWarp[0]) {
-        ret[0] *= 2;
-      } else
-        ret[1] *= 2;
-    } else {
-      ret[1] *= 2;
+  SmallVector<triton::DotOp> chain;
+  for (Operation *op : mlir::getSlice(dotOp, {filter}))
+    if (auto dot = dyn_cast<triton::DotOp>(op))
+      chain.push_back(dot);
+
+  int64_t conversionBytes = 0;
+  for (triton::DotOp dot : chain) {
+    SetVector<Operation *> aSlice;
+    getBackwardSlice(dot.getA(), &aSlice, {filter});
+    for (Operation *op : aSlice)
+      if (auto producer = dyn_cast<triton::DotOp>(op)) {
+        auto type = producer.getType().cast<RankedTensorType>();
+        conversionBytes += 2 * product<int64_t>(type.getShape()) *
+                           type.getElementTypeBitWidth() / 8;
+      }
+  }
+
+  SmallVector<unsigned, 2> ret = {(unsigned)numWarps, 1};
+  int64_t bestCost = std::numeric_limits<int64_t>::max();
+  for (unsigned m = numWarps; m >= 1; m /= 2) {
+    SmallVector<unsigned, 2> candidate = {m, numWarps / m};
+    int64_t cost = candidate[1] == 1 ? 0 : conversionBytes;
+    for (triton::DotOp dot : chain)
+      cost += getWarpTileCost(dot, candidate);
+    if (cost < bestCost) {
+      bestCost = cost;
+      ret = candidate;
     }
-  } while (true);
+  }
   return ret;
 }
 
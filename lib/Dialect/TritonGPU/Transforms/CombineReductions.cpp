@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+// This pass combines independent reductions of the same layout and axis.
+//
+// For example:
+// %sum = tt.reduce(%x) {axis = 1} ({ addf })
+// %x2 = arith.mulf %x, %x
+// %sum2 = tt.reduce(%x2) {axis = 1} ({ addf })
+//
+// will be translated to
+//
+// %x2 = arith.mulf %x, %x
+// %sum, %sum2 = tt.reduce(%x, %x2) {axis = 1} ({ addf, addf })
+//
+// so that both reductions share one round-trip through shared memory.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "mlir/Transforms/RegionUtils.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+
+#include <optional>
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+/// Whether `a` and `b` reduce tensors of the same shape and layout along the
+/// same axis
+bool isCompatible(triton::ReduceOp a, triton::ReduceOp b) {
+  auto aTy = a.getInputTypes()[0];
+  auto bTy = b.getInputTypes()[0];
+  return a.getAxis() == b.getAxis() && aTy.getShape() == bTy.getShape() &&
+         aTy.getEncoding() == bTy.getEncoding();
+}
+
+/// The operations between `a` and `b` that `b` depends on, through its
+/// operands or the values its combine region captures, in program order, or
+/// std::nullopt if `b` depends on `a` or on an operation that cannot be moved
+/// above `a`
+std::optional<SmallVector<Operation *>> getOpsToHoist(triton::ReduceOp a,
+                                                      triton::ReduceOp b) {
+  Block *block = a->getBlock();
+  SetVector<Operation *> slice;
+  SetVector<Value> captured;
+  getUsedValuesDefinedAbove(b.getCombineOp(), captured);
+  SmallVector<Value> worklist(b->getOperands());
+  worklist.append(captured.begin(), captured.end());
+  while (!worklist.empty()) {
+    Operation *def = worklist.pop_back_val().getDefiningOp();
+    if (!def || def->getBlock() != block || def->isBeforeInBlock(a) ||
+        slice.contains(def))
+      continue;
+    if (def == a.getOperation() || def->getNumRegions() != 0 ||
+        !isMemoryEffectFree(def))
+      return std::nullopt;
+    slice.insert(def);
+    worklist.append(def->operand_begin(), def->operand_end());
+  }
+  SmallVector<Operation *> ops = slice.takeVector();
+  llvm::sort(ops, [](Operation *lhs, Operation *rhs) {
+    return lhs->isBeforeInBlock(rhs);
+  });
+  return ops;
+}
+
+/// Replace `a` and `b` by a reduction of the operands of both, built in place
+/// of `a`. The combine region takes the accumulators of `a` and `b`, then the
+/// current values of `a` and `b`.
+triton::ReduceOp combine(triton::ReduceOp a, triton::ReduceOp b) {
+  OpBuilder builder(a);
+  SmallVector<Value> operands(a.getOperands());
+  operands.append(b.getOperands().begin(), b.getOperands().end());
+  auto combined =
+      builder.create<triton::ReduceOp>(a.getLoc(), operands, a.getAxis());
+
+  Block *aBody = a.getBody();
+  Block *bBody = b.getBody();
+  unsigned numA = a.getNumOperands();
+  unsigned numB = b.getNumOperands();
+  SmallVector<Type> argTys;
+  SmallVector<Location> argLocs;
+  for (unsigned i = 0; i < 2; ++i) {
+    for (BlockArgument arg : aBody->getArguments().slice(i * numA, numA)) {
+      argTys.push_back(arg.getType());
+      argLocs.push_back(arg.getLoc());
+    }
+    for (BlockArgument arg : bBody->getArguments().slice(i * numB, numB)) {
+      argTys.push_back(arg.getType());
+      argLocs.push_back(arg.getLoc());
+    }
+  }
+  Block *body =
+      builder.createBlock(&combined.getCombineOp(), {}, argTys, argLocs);
+  IRMapping mapping;
+  for (unsigned i = 0; i < numA; ++i) {
+    mapping.map(aBody->getArgument(i), body->getArgument(i));
+    mapping.map(aBody->getArgument(numA + i),
+                body->getArgument(numA + numB + i));
+  }
+  for (unsigned i = 0; i < numB; ++i) {
+    mapping.map(bBody->getArgument(i), body->getArgument(numA + i));
+    mapping.map(bBody->getArgument(numB + i),
+                body->getArgument(2 * numA + numB + i));
+  }
+  SmallVector<Value> results;
+  for (Block *src : {aBody, bBody}) {
+    for (Operation &op : src->without_terminator())
+      builder.clone(op, mapping);
+    for (Value result : src->getTerminator()->getOperands())
+      results.push_back(mapping.lookupOrDefault(result));
+  }
+  builder.create<triton::ReduceReturnOp>(a.getLoc(), results);
+
+  a->replaceAllUsesWith(combined->getResults().take_front(numA));
+  b->replaceAllUsesWith(combined->getResults().drop_front(numA));
+  a->erase();
+  b->erase();
+  return combined;
+}
+
+class CombineReductionsPass
+    : public TritonGPUCombineReductionsBase<CombineReductionsPass> {
+public:
+  void combineInBlock(Block *block) {
+    SmallVector<triton::ReduceOp> reduceOps(block->getOps<triton::ReduceOp>());
+    // Reductions that later ones may still be combined into
+    SmallVector<triton::ReduceOp> heads;
+    for (triton::ReduceOp reduceOp : reduceOps) {
+      bool combined = false;
+      for (triton::ReduceOp &head : heads) {
+        if (!isCompatible(head, reduceOp))
+          continue;
+        std::optional<SmallVector<Operation *>> toHoist =
+            getOpsToHoist(head, reduceOp);
+        if (!toHoist)
+          continue;
+        for (Operation *op : *toHoist)
+          op->moveBefore(head);
+        head = combine(head, reduceOp);
+        combined = true;
+        break;
+      }
+      if (!combined)
+        heads.push_back(reduceOp);
+    }
+  }
+
+  void runOnOperation() override {
+    SmallVector<Block *> blocks;
+    getOperation().walk([&](Block *block) { blocks.push_back(block); });
+    for (Block *block : blocks)
+      combineInBlock(block);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::createTritonGPUCombineReductionsPass() {
+  return std::make_unique<CombineReductionsPass>();
+}
@@ -0,0 +1,95 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+// Estimated 32-bit registers per thread taken by a value of type `type`, or
+// std::nullopt if it does not live in registers.
+std::optional<int64_t> getRegisters(Type type) {
+  Type elementTy = getElementTypeOrSelf(type);
+  int64_t bits = elementTy.isa<triton::PointerType>()
+                     ? 64
+                     : std::max(8u, elementTy.getIntOrFloatBitWidth());
+  // predicates take a register each
+  if (elementTy.isInteger(1))
+    bits = 32;
+  auto tensorType = type.dyn_cast<RankedTensorType>();
+  if (!tensorType)
+    return ceil<int64_t>(bits, 32);
+  Attribute encoding = tensorType.getEncoding();
+  if (!encoding || encoding.isa<triton::gpu::SharedEncodingAttr>())
+    return std::nullopt;
+  return ceil<int64_t>(triton::gpu::getTotalElemsPerThread(type) * bits, 32);
+}
+
+bool canHoist(Operation *op, scf::ForOp forOp) {
+  if (op->getNumRegions() != 0 || !isMemoryEffectFree(op))
+    return false;
+  // The loop may not run at all: ops that can trap, such as a division by a
+  // value that may be zero, must not be executed ahead of it
+  if (!isSpeculatable(op))
+    return false;
+  // Tensor constants are cheaper to rematerialize than to keep live
+  if (op->hasTrait<OpTrait::ConstantLike>() &&
+      op->getResult(0).getType().isa<RankedTensorType>())
+    return false;
+  return llvm::all_of(op->getOperands(),
+                      [&](Value v) { return forOp.isDefinedOutsideOfLoop(v); });
+}
+
+class LoopInvariantCodeMotionPass
+    : public TritonGPULoopInvariantCodeMotionBase<LoopInvariantCodeMotionPass> {
+public:
+  LoopInvariantCodeMotionPass() = default;
+  LoopInvariantCodeMotionPass(int maxHoistedRegisters) {
+    this->maxHoistedRegisters = maxHoistedRegisters;
+  }
+
+  void hoist(scf::ForOp forOp) {
+    int64_t budget = maxHoistedRegisters;
+    for (Operation &op :
+         llvm::make_early_inc_range(forOp.getBody()->without_terminator())) {
+      if (!canHoist(&op, forOp))
+        continue;
+      // The results are now live across the loop, operands used only by `op`
+      // are not anymore
+      int64_t cost = 0;
+      bool inRegisters = true;
+      for (Value result : op.getResults()) {
+        std::optional<int64_t> registers = getRegisters(result.getType());
+        inRegisters &= registers.has_value();
+        cost += registers.value_or(0);
+      }
+      if (!inRegisters)
+        continue;
+      for (Value operand : op.getOperands())
+        if (operand.getDefiningOp() && operand.hasOneUse())
+          cost -= getRegisters(operand.getType()).value_or(0);
+      if (cost > budget)
+        continue;
+      budget -= std::max<int64_t>(cost, 0);
+      op.moveBefore(forOp);
+    }
+  }
+
+  void runOnOperation() override {
+    // Post-order: values hoisted out of an inner loop may then be hoisted out
+    // of the outer one
+    getOperation().walk([&](scf::ForOp forOp) { hoist(forOp); });
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass>
+mlir::createTritonGPULoopInvariantCodeMotionPass(int maxHoistedRegisters) {
+  return std::make_unique<LoopInvariantCodeMotionPass>(maxHoistedRegisters);
+}
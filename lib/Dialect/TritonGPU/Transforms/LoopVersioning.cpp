@@ -0,0 +1,354 @@
+//===----------------------------------------------------------------------===//
+//
+// This pass versions loops over tiles into an unmasked main loop and a masked
+// remainder.
+//
+// For example:
+// scf.for %iv = %lb to %ub step %c128 iter_args(...) {
+//   %offs = splat(index_cast %iv) + make_range(0, 128)
+//   %mask = %offs < splat(%n)
+//   %x = tt.load %ptrs, %mask
+//   ...
+// }
+//
+// will be translated to
+//
+// %last = %n - 128 + 1
+// %iters = min(ceildiv(max(%last - %lb, 0), %c128),
+//              ceildiv(max(%ub - %lb, 0), %c128))
+// %split = %lb + %iters * %c128
+// %main = scf.for %iv = %lb to %split step %c128 iter_args(...) {
+//   %x = tt.load %ptrs
+//   ...
+// }
+// scf.if (%n & 15) == 0 {
+//   %n16 = (%n >> 4) << 4
+//   scf.for %i = 0 to %ub - %split step %c128 iter_args(... = %main) {
+//     %iv = %split + %i
+//     <original body using %n16>
+//   }
+// } else {
+//   scf.for %i = 0 to %ub - %split step %c128 iter_args(... = %main) {
+//     %iv = %split + %i
+//     <original body>
+//   }
+// }
+//
+// The remainder loop starts from 0 so that AxisInfo, which only derives the
+// divisibility of induction variables with a constant lower bound, knows that
+// %iv is a multiple of the step. Its masks are only vectorized when their
+// bound is divisible, which is checked at runtime.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/IRMapping.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+/// A mask that is all true as long as iv * scale + width <= bound
+struct TileMask {
+  Value bound;
+  int64_t width;
+  int64_t scale;
+};
+
+/// Look through the expansions and broadcasts of a tensor
+Value stripExpansions(Value v) {
+  while (v.getDefiningOp<triton::BroadcastOp>() ||
+         v.getDefiningOp<triton::ExpandDimsOp>())
+    v = v.getDefiningOp()->getOperand(0);
+  return v;
+}
+
+Value getSplatSource(Value v) {
+  if (auto splat = stripExpansions(v).getDefiningOp<triton::SplatOp>())
+    return splat.getSrc();
+  return Value();
+}
+
+bool isInductionVar(Value v, scf::ForOp forOp) {
+  if (auto cast = v.getDefiningOp<arith::IndexCastOp>())
+    v = cast.getIn();
+  return v == forOp.getInductionVar();
+}
+
+/// C if `v` is `iv * C`, with C a positive constant, or 1 if it is `iv`
+std::optional<int64_t> getInductionVarScale(Value v, scf::ForOp forOp) {
+  if (isInductionVar(v, forOp))
+    return 1;
+  if (auto cast = v.getDefiningOp<arith::IndexCastOp>())
+    v = cast.getIn();
+  auto mul = v.getDefiningOp<arith::MulIOp>();
+  if (!mul)
+    return std::nullopt;
+  for (auto [iv, factor] : {std::make_pair(mul.getLhs(), mul.getRhs()),
+                            std::make_pair(mul.getRhs(), mul.getLhs())}) {
+    std::optional<int64_t> scale = getConstantIntValue(factor);
+    if (scale && *scale > 0 && isInductionVar(iv, forOp))
+      return scale;
+  }
+  return std::nullopt;
+}
+
+std::optional<int64_t> getRangeWidth(Value v) {
+  auto range = stripExpansions(v).getDefiningOp<triton::MakeRangeOp>();
+  if (!range || range.getStart() != 0)
+    return std::nullopt;
+  return range.getEnd();
+}
+
+std::optional<TileMask> matchTileMask(Value mask, scf::ForOp forOp) {
+  auto cmp = stripExpansions(mask).getDefiningOp<arith::CmpIOp>();
+  if (!cmp || cmp.getPredicate() != arith::CmpIPredicate::slt)
+    return std::nullopt;
+  Value rhs = getSplatSource(cmp.getRhs());
+  if (!rhs)
+    return std::nullopt;
+
+  // make_range(0, B) < splat(N - iv * C)
+  if (std::optional<int64_t> width = getRangeWidth(cmp.getLhs())) {
+    auto sub = rhs.getDefiningOp<arith::SubIOp>();
+    if (!sub || !forOp.isDefinedOutsideOfLoop(sub.getLhs()))
+      return std::nullopt;
+    if (std::optional<int64_t> scale =
+            getInductionVarScale(sub.getRhs(), forOp))
+      return TileMask{sub.getLhs(), *width, *scale};
+    return std::nullopt;
+  }
+
+  // splat(iv * C) + make_range(0, B) < splat(N)
+  auto add = stripExpansions(cmp.getLhs()).getDefiningOp<arith::AddIOp>();
+  if (!add || !forOp.isDefinedOutsideOfLoop(rhs))
+    return std::nullopt;
+  for (auto [ivSplat, range] : {std::make_pair(add.getLhs(), add.getRhs()),
+                                std::make_pair(add.getRhs(), add.getLhs())}) {
+    Value iv = getSplatSource(ivSplat);
+    std::optional<int64_t> width = getRangeWidth(range);
+    if (!iv || !width)
+      continue;
+    if (std::optional<int64_t> scale = getInductionVarScale(iv, forOp))
+      return TileMask{rhs, *width, *scale};
+  }
+  return std::nullopt;
+}
+
+/// Whether `v` is known at compile time to be a multiple of `alignment`
+bool isKnownMultiple(Value v, int64_t alignment) {
+  if (std::optional<int64_t> cst = getConstantIntValue(v))
+    return *cst % alignment == 0;
+  auto arg = v.dyn_cast<BlockArgument>();
+  if (!arg)
+    return false;
+  auto funcOp = dyn_cast<triton::FuncOp>(arg.getOwner()->getParentOp());
+  if (!funcOp)
+    return false;
+  auto divisibility = funcOp.getArgAttrOfType<IntegerAttr>(
+      arg.getArgNumber(), "tt.divisibility");
+  return divisibility && divisibility.getInt() % alignment == 0;
+}
+
+class LoopVersioningPass
+    : public TritonGPULoopVersioningBase<LoopVersioningPass> {
+public:
+  LoopVersioningPass() = default;
+  LoopVersioningPass(int alignment) { this->alignment = alignment; }
+
+  LogicalResult versionLoop(scf::ForOp forOp);
+
+  void guardRemainder(scf::ForOp forOp, ArrayRef<TileMask> masks);
+
+  void runOnOperation() override {
+    if (alignment <= 1 || !llvm::isPowerOf2_32(alignment)) {
+      getOperation().emitError() << "invalid alignment " << alignment;
+      return signalPassFailure();
+    }
+    SmallVector<scf::ForOp> loops;
+    getOperation().walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+    for (scf::ForOp forOp : loops)
+      (void)versionLoop(forOp);
+  }
+};
+
+LogicalResult LoopVersioningPass::versionLoop(scf::ForOp forOp) {
+  // Find the loads and stores whose mask is a bounds check of the tile
+  SmallVector<unsigned> unmaskedIdx;
+  SmallVector<TileMask> masks;
+  for (auto op : llvm::enumerate(forOp.getBody()->getOperations())) {
+    Value mask;
+    if (auto loadOp = dyn_cast<triton::LoadOp>(op.value()))
+      mask = loadOp.getMask();
+    else if (auto storeOp = dyn_cast<triton::StoreOp>(op.value()))
+      mask = storeOp.getMask();
+    if (!mask)
+      continue;
+    std::optional<TileMask> tileMask = matchTileMask(mask, forOp);
+    if (tileMask && tileMask->bound.getType().isInteger(32)) {
+      unmaskedIdx.push_back(op.index());
+      masks.push_back(*tileMask);
+    }
+  }
+  if (masks.empty())
+    return failure();
+  auto step = forOp.getStep().getDefiningOp<arith::ConstantIndexOp>();
+  if (!step || step.value() <= 0)
+    return failure();
+
+  // Split before the first iteration where some mask may be partially false:
+  // the masks are all true for iv < (N - B) / C + 1
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  Value last;
+  for (TileMask &mask : masks) {
+    Value bound;
+    if (mask.scale == 1) {
+      bound = builder.create<arith::SubIOp>(
+          loc, mask.bound,
+          builder.create<arith::ConstantIntOp>(loc, mask.width - 1, 32));
+    } else {
+      Value span = builder.create<arith::SubIOp>(
+          loc, mask.bound,
+          builder.create<arith::ConstantIntOp>(loc, mask.width, 32));
+      bound = builder.create<arith::AddIOp>(
+          loc,
+          builder.create<arith::FloorDivSIOp>(
+              loc, span,
+              builder.create<arith::ConstantIntOp>(loc, mask.scale, 32)),
+          builder.create<arith::ConstantIntOp>(loc, 1, 32));
+    }
+    last = last ? builder.create<arith::MinSIOp>(loc, last, bound) : bound;
+  }
+  // The split is kept a multiple of the step from the lower bound, so that
+  // AxisInfo derives the divisibility of the remainder induction variable
+  Value lb = forOp.getLowerBound();
+  Value ub = forOp.getUpperBound();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  auto countIters = [&](Value end) -> Value {
+    Value span = builder.create<arith::MaxSIOp>(
+        loc, builder.create<arith::SubIOp>(loc, end, lb), zero);
+    return builder.create<arith::CeilDivSIOp>(loc, span, forOp.getStep());
+  };
+  Value numIters = builder.create<arith::MinSIOp>(
+      loc,
+      countIters(builder.create<arith::IndexCastOp>(
+          loc, builder.getIndexType(), last)),
+      countIters(ub));
+  Value split = builder.create<arith::AddIOp>(
+      loc, lb, builder.create<arith::MulIOp>(loc, numIters, forOp.getStep()));
+
+  // Main loop
+  IRMapping mapping;
+  auto mainLoop = cast<scf::ForOp>(builder.clone(*forOp, mapping));
+  mainLoop.setUpperBound(split);
+  SmallVector<Operation *> mainOps;
+  for (Operation &op : mainLoop.getBody()->getOperations())
+    mainOps.push_back(&op);
+  for (unsigned idx : unmaskedIdx) {
+    Operation *op = mainOps[idx];
+    builder.setInsertionPoint(op);
+    if (auto loadOp = dyn_cast<triton::LoadOp>(op)) {
+      Value newLoad = builder.create<triton::LoadOp>(
+          loadOp.getLoc(), loadOp.getPtr(), loadOp.getCache(),
+          loadOp.getEvict(), loadOp.getIsVolatile());
+      loadOp.getResult().replaceAllUsesWith(newLoad);
+    } else {
+      auto storeOp = cast<triton::StoreOp>(op);
+      builder.create<triton::StoreOp>(storeOp.getLoc(), storeOp.getPtr(),
+                                      storeOp.getValue(), storeOp.getCache(),
+                                      storeOp.getEvict());
+    }
+    op->erase();
+  }
+
+  // Remainder loop, rebased to start from 0
+  builder.setInsertionPoint(forOp);
+  forOp.setLowerBound(zero);
+  forOp.setUpperBound(builder.create<arith::SubIOp>(loc, ub, split));
+  for (auto init : llvm::enumerate(forOp.getIterOpOperands()))
+    init.value().set(mainLoop.getResult(init.index()));
+  Value iv = forOp.getInductionVar();
+  builder.setInsertionPointToStart(forOp.getBody());
+  Value rebasedIv = builder.create<arith::AddIOp>(loc, split, iv);
+  iv.replaceAllUsesExcept(rebasedIv, rebasedIv.getDefiningOp());
+
+  guardRemainder(forOp, masks);
+  return success();
+}
+
+void LoopVersioningPass::guardRemainder(scf::ForOp forOp,
+                                        ArrayRef<TileMask> masks) {
+  // The masked accesses of the remainder are only vectorized if AxisInfo
+  // knows their bounds are divisible
+  SmallVector<Value> bounds;
+  for (const TileMask &mask : masks)
+    if (!llvm::is_contained(bounds, mask.bound) &&
+        !isKnownMultiple(mask.bound, alignment))
+      bounds.push_back(mask.bound);
+  if (bounds.empty())
+    return;
+
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  Value isDivisible;
+  for (Value bound : bounds) {
+    Value lowBits = builder.create<arith::AndIOp>(
+        loc, bound,
+        builder.create<arith::ConstantIntOp>(loc, alignment - 1, 32));
+    Value boundDivisible = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, lowBits,
+        builder.create<arith::ConstantIntOp>(loc, 0, 32));
+    isDivisible =
+        isDivisible
+            ? builder.create<arith::AndIOp>(loc, isDivisible, boundDivisible)
+            : boundDivisible;
+  }
+
+  // The bounds are rebuilt from their high bits in the guarded copy, along
+  // with their splats hoisted out of the loop
+  auto buildGuarded = [&](OpBuilder &b, Location loc) {
+    IRMapping mapping;
+    Value shift = b.create<arith::ConstantIntOp>(
+        loc, llvm::Log2_32(alignment), 32);
+    for (Value bound : bounds) {
+      Value multiple = b.create<arith::ShLIOp>(
+          loc, b.create<arith::ShRUIOp>(loc, bound, shift), shift);
+      mapping.map(bound, multiple);
+      for (Operation *user : bound.getUsers()) {
+        auto splat = dyn_cast<triton::SplatOp>(user);
+        if (!splat || forOp->isAncestor(splat) ||
+            llvm::none_of(splat->getUsers(), [&](Operation *splatUser) {
+              return forOp->isAncestor(splatUser);
+            }))
+          continue;
+        mapping.map(splat.getResult(),
+                    b.create<triton::SplatOp>(loc, splat.getType(), multiple)
+                        .getResult());
+      }
+    }
+    Operation *guardedLoop = b.clone(*forOp, mapping);
+    b.create<scf::YieldOp>(loc, guardedLoop->getResults());
+  };
+  auto ifOp = builder.create<scf::IfOp>(
+      loc, isDivisible, buildGuarded, [&](OpBuilder &b, Location loc) {
+        b.create<scf::YieldOp>(loc, forOp.getResults());
+      });
+  for (auto [result, guardedResult] :
+       llvm::zip(forOp.getResults(), ifOp.getResults()))
+    result.replaceUsesWithIf(guardedResult, [&](OpOperand &use) {
+      return !ifOp->isAncestor(use.getOwner());
+    });
+  forOp->moveBefore(ifOp.elseBlock()->getTerminator());
+}
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::createTritonGPULoopVersioningPass(int alignment) {
+  return std::make_unique<LoopVersioningPass>(alignment);
+}
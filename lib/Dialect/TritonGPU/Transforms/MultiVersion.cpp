@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+// This pass versions kernels on the alignment of their arguments at runtime.
+// There is a single specialized version, guarded by one test over all the
+// arguments: if any one of them is not divisible, the whole kernel falls back
+// to the generic version. Only pointers and the integers that are multiplied
+// into offsets (strides) are tested; sizes used as loop or mask bounds are not,
+// and at most `max-args` arguments are, pointers first.
+//
+// For example, with alignment=16:
+// tt.func @kernel(%ptr: !tt.ptr<f32>, %stride: i32) {
+//   <body using %ptr and %stride>
+//   tt.return
+// }
+//
+// will be translated to
+//
+// tt.func @kernel(%ptr: !tt.ptr<f32>, %stride: i32) {
+//   %ptr_aligned = (ptr_to_int(%ptr) & 15) == 0
+//   %stride_aligned = (%stride & 15) == 0
+//   scf.if %ptr_aligned && %stride_aligned {
+//     %ptr16 = int_to_ptr((ptr_to_int(%ptr) >> 4) << 4)
+//     %stride16 = (%stride >> 4) << 4
+//     <body using %ptr16 and %stride16>
+//   } else {
+//     <body using %ptr and %stride>
+//   }
+//   tt.return
+// }
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+/// Whether the integer `v` is, possibly after casts and broadcasts, an
+/// operand of a multiplication, i.e. scales an offset like a stride does.
+/// Sizes that only bound loops and masks (`cmp`, `make_range`, `scf.for`) are
+/// not.
+bool isMultiplied(Value v) {
+  SmallVector<Value> worklist{v};
+  DenseSet<Value> seen;
+  while (!worklist.empty()) {
+    Value cur = worklist.pop_back_val();
+    if (!seen.insert(cur).second)
+      continue;
+    for (Operation *user : cur.getUsers()) {
+      if (isa<arith::MulIOp>(user))
+        return true;
+      if (isa<arith::ExtSIOp, arith::ExtUIOp, arith::TruncIOp,
+              arith::IndexCastOp, triton::SplatOp, triton::BroadcastOp,
+              triton::ExpandDimsOp>(user))
+        worklist.push_back(user->getResult(0));
+    }
+  }
+  return false;
+}
+
+/// Whether `arg` is a scalar pointer, or an integer multiplied into offsets,
+/// whose alignment is worth testing at runtime
+bool needsVersioning(triton::FuncOp funcOp, BlockArgument arg,
+                     int64_t alignment) {
+  if (arg.use_empty())
+    return false;
+  Type type = arg.getType();
+  if (auto ptrTy = type.dyn_cast<triton::PointerType>()) {
+    if (ptrTy.getPointeeType().isa<RankedTensorType>())
+      return false;
+  } else if (!type.isInteger(32) && !type.isInteger(64)) {
+    return false;
+  } else if (!isMultiplied(arg)) {
+    return false;
+  }
+  auto divisibility = funcOp.getArgAttrOfType<IntegerAttr>(
+      arg.getArgNumber(), "tt.divisibility");
+  return !divisibility || divisibility.getInt() % alignment != 0;
+}
+
+class MultiVersionPass : public TritonGPUMultiVersionBase<MultiVersionPass> {
+public:
+  MultiVersionPass() = default;
+  MultiVersionPass(int alignment, int maxArgs) {
+    this->alignment = alignment;
+    this->maxArgs = maxArgs;
+  }
+
+  LogicalResult multiVersion(triton::FuncOp funcOp);
+
+  void runOnOperation() override {
+    if (alignment <= 1 || !llvm::isPowerOf2_32(alignment)) {
+      getOperation().emitError() << "invalid alignment " << alignment;
+      return signalPassFailure();
+    }
+    getOperation().walk(
+        [&](triton::FuncOp funcOp) { (void)multiVersion(funcOp); });
+  }
+};
+
+LogicalResult MultiVersionPass::multiVersion(triton::FuncOp funcOp) {
+  if (!funcOp.isPublic() || !funcOp.getBody().hasOneBlock())
+    return failure();
+  Block &entry = funcOp.getBody().front();
+  auto returnOp = dyn_cast<triton::ReturnOp>(entry.getTerminator());
+  if (!returnOp || returnOp.getNumOperands() != 0)
+    return failure();
+  SmallVector<BlockArgument> args;
+  for (BlockArgument arg : funcOp.getArguments())
+    if (needsVersioning(funcOp, arg, alignment))
+      args.push_back(arg);
+  if (args.empty())
+    return failure();
+  // Each tested argument makes the specialized body less likely to run: keep
+  // the pointers, which decide the vector width of loads and stores, first.
+  llvm::stable_sort(args, [](BlockArgument a, BlockArgument b) {
+    return a.getType().isa<triton::PointerType>() &&
+           !b.getType().isa<triton::PointerType>();
+  });
+  if (args.size() > static_cast<size_t>(maxArgs))
+    args.resize(maxArgs);
+  SmallVector<Operation *> body;
+  for (Operation &op : entry.without_terminator())
+    body.push_back(&op);
+
+  Location loc = funcOp.getLoc();
+  OpBuilder builder(returnOp);
+  auto asInteger = [&](Value v) -> Value {
+    if (v.getType().isa<triton::PointerType>())
+      return builder.create<triton::PtrToIntOp>(loc, builder.getI64Type(), v);
+    return v;
+  };
+
+  // Test the alignment of the arguments
+  Value isAligned;
+  for (BlockArgument arg : args) {
+    Value bits = asInteger(arg);
+    Value lowBits = builder.create<arith::AndIOp>(
+        loc, bits,
+        builder.create<arith::ConstantIntOp>(loc, alignment - 1,
+                                             bits.getType()));
+    Value argAligned = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, lowBits,
+        builder.create<arith::ConstantIntOp>(loc, 0, bits.getType()));
+    isAligned = isAligned
+                    ? builder.create<arith::AndIOp>(loc, isAligned, argAligned)
+                    : argAligned;
+  }
+  auto ifOp = builder.create<scf::IfOp>(loc, isAligned,
+                                        /*withElseRegion=*/true);
+
+  // Generic body
+  for (Operation *op : body)
+    op->moveBefore(ifOp.elseBlock()->getTerminator());
+
+  // Specialized body. The arguments are rebuilt from their high bits so that
+  // AxisInfo knows they are multiples of the alignment.
+  builder.setInsertionPoint(ifOp.thenBlock()->getTerminator());
+  IRMapping mapping;
+  unsigned shift = llvm::Log2_32(alignment);
+  for (BlockArgument arg : args) {
+    Value bits = asInteger(arg);
+    Value shiftAmount =
+        builder.create<arith::ConstantIntOp>(loc, shift, bits.getType());
+    Value multiple = builder.create<arith::ShLIOp>(
+        loc, builder.create<arith::ShRUIOp>(loc, bits, shiftAmount),
+        shiftAmount);
+    if (arg.getType().isa<triton::PointerType>())
+      multiple =
+          builder.create<triton::IntToPtrOp>(loc, arg.getType(), multiple);
+    mapping.map(arg, multiple);
+  }
+  for (Operation *op : body)
+    builder.clone(*op, mapping);
+  return success();
+}
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::createTritonGPUMultiVersionPass(int alignment,
+                                                            int maxArgs) {
+  return std::make_unique<MultiVersionPass>(alignment, maxArgs);
+}
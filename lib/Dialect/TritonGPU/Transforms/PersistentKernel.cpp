@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+// This pass turns kernels that compute one tile per program into persistent
+// kernels that loop over tiles.
+//
+// For example:
+// tt.func @kernel(%args...) {
+//   %pid = tt.get_program_id x : i32
+//   %range = tt.make_range ...
+//   <per-tile body using %pid and %range>
+//   tt.return
+// }
+//
+// will be translated to
+//
+// tt.func @kernel(%args..., %num_tiles: i32 {tt.num_tiles}) {
+//   %range = tt.make_range ...
+//   %pid = tt.get_program_id x : i32
+//   %num_programs = tt.get_num_programs {axis = 0 : i32} : i32
+//   scf.while (%tile = %pid) : (i32) -> i32 {
+//     %cond = arith.cmpi slt, %tile, %num_tiles : i32
+//     scf.condition(%cond) %tile : i32
+//   } do {
+//   ^bb0(%tile: i32):
+//     <per-tile body using %tile and %range>
+//     %next = arith.addi %tile, %num_programs : i32
+//     scf.yield %next : i32
+//   }
+//   tt.return
+// }
+//
+// With the atomic scheduler, the next tile is claimed from a global counter
+// instead: %next = atomic_add(%counter, 1) + %num_programs.
+//
+// The grid the kernel must now be launched with is recorded in the
+// `triton_gpu.persistent-grid` module attribute.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+class PersistentKernelPass
+    : public TritonGPUPersistentKernelBase<PersistentKernelPass> {
+public:
+  PersistentKernelPass() = default;
+  PersistentKernelPass(bool atomicScheduler, int numPrograms) {
+    this->atomicScheduler = atomicScheduler;
+    this->numPrograms = numPrograms;
+  }
+
+  LogicalResult makePersistent(triton::FuncOp funcOp);
+
+  void runOnOperation() override {
+    if (numPrograms < 0) {
+      getOperation().emitError() << "invalid number of programs "
+                                 << numPrograms;
+      return signalPassFailure();
+    }
+    ModuleOp m = getOperation();
+    bool changed = false;
+    m.walk([&](triton::FuncOp funcOp) {
+      if (succeeded(makePersistent(funcOp)))
+        changed = true;
+    });
+    if (changed)
+      m->setAttr("triton_gpu.persistent-grid",
+                 IntegerAttr::get(IntegerType::get(m.getContext(), 32),
+                                  numPrograms));
+  }
+};
+
+LogicalResult PersistentKernelPass::makePersistent(triton::FuncOp funcOp) {
+  if (!funcOp.isPublic() || !funcOp.getBody().hasOneBlock())
+    return failure();
+  Block &entry = funcOp.getBody().front();
+  auto returnOp = dyn_cast<triton::ReturnOp>(entry.getTerminator());
+  if (!returnOp || returnOp.getNumOperands() != 0)
+    return failure();
+
+  // Only kernels over a 1D grid of tiles are supported
+  SmallVector<triton::GetProgramIdOp> pids;
+  bool hasOtherAxis = false;
+  funcOp.walk([&](triton::GetProgramIdOp op) {
+    if (op.getAxis() != triton::ProgramIDDim::X)
+      hasOtherAxis = true;
+    pids.push_back(op);
+  });
+  if (pids.empty() || hasOtherAxis)
+    return failure();
+
+  Location loc = funcOp.getLoc();
+  OpBuilder builder(funcOp);
+  Type i32Ty = builder.getI32Type();
+  unsigned numArgs = funcOp.getNumArguments();
+  funcOp.insertArgument(
+      numArgs, i32Ty,
+      builder.getDictionaryAttr(
+          builder.getNamedAttr("tt.num_tiles", builder.getUnitAttr())),
+      loc);
+  Value numTiles = funcOp.getArgument(numArgs);
+  Value counter;
+  if (atomicScheduler) {
+    funcOp.insertArgument(
+        numArgs + 1, triton::PointerType::get(i32Ty, 1),
+        builder.getDictionaryAttr(
+            builder.getNamedAttr("tt.tile_counter", builder.getUnitAttr())),
+        loc);
+    counter = funcOp.getArgument(numArgs + 1);
+  }
+
+  // The kernel was written for a grid of num_tiles programs
+  funcOp.walk([&](triton::GetNumProgramsOp op) {
+    if (op.getAxis() != 0)
+      return;
+    op.getResult().replaceAllUsesWith(numTiles);
+    op.erase();
+  });
+
+  // Ops that read the program id, have side effects or regions, or depend on
+  // such ops run once per tile. The other ops are hoisted out of the loop.
+  DenseSet<Operation *> perTile;
+  SmallVector<Operation *> perTileOps;
+  for (Operation &op : entry.without_terminator()) {
+    bool isPerTile = isa<triton::GetProgramIdOp>(op) ||
+                     op.getNumRegions() != 0 || !isMemoryEffectFree(&op) ||
+                     llvm::any_of(op.getOperands(), [&](Value v) {
+                       return perTile.contains(v.getDefiningOp());
+                     });
+    if (isPerTile) {
+      perTile.insert(&op);
+      perTileOps.push_back(&op);
+    }
+  }
+
+  builder.setInsertionPoint(returnOp);
+  Value pid =
+      builder.create<triton::GetProgramIdOp>(loc, i32Ty, triton::ProgramIDDim::X);
+  Value numPrograms = builder.create<triton::GetNumProgramsOp>(
+      loc, i32Ty, builder.getI32IntegerAttr(0));
+  auto whileOp =
+      builder.create<scf::WhileOp>(loc, TypeRange{i32Ty}, ValueRange{pid});
+  Block *before = builder.createBlock(&whileOp.getBefore(), {}, {i32Ty}, {loc});
+  Value cond = builder.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::slt, before->getArgument(0), numTiles);
+  builder.create<scf::ConditionOp>(loc, cond, before->getArguments());
+
+  Block *after = builder.createBlock(&whileOp.getAfter(), {}, {i32Ty}, {loc});
+  Value tile = after->getArgument(0);
+  for (Operation *op : perTileOps)
+    op->moveBefore(after, after->end());
+  for (triton::GetProgramIdOp op : pids) {
+    op.getResult().replaceAllUsesWith(tile);
+    op.erase();
+  }
+
+  builder.setInsertionPointToEnd(after);
+  Value next;
+  if (counter) {
+    Value one = builder.create<arith::ConstantIntOp>(loc, 1, 32);
+    Value claimed = builder.create<triton::AtomicRMWOp>(
+        loc, i32Ty, triton::RMWOp::ADD, counter, one, Value(),
+        triton::MemSemantic::ACQUIRE_RELEASE);
+    next = builder.create<arith::AddIOp>(loc, claimed, numPrograms);
+  } else {
+    next = builder.create<arith::AddIOp>(loc, tile, numPrograms);
+  }
+  builder.create<scf::YieldOp>(loc, next);
+  return success();
+}
+
+} // namespace
+
+std::unique_ptr<Pass>
+mlir::createTritonGPUPersistentKernelPass(bool atomicScheduler,
+                                          int numPrograms) {
+  return std::make_unique<PersistentKernelPass>(atomicScheduler, numPrograms);
+}
@@ -3,6 +3,7 @@
 #include "mlir/IR/TypeUtilities.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "triton/Analysis/Allocation.h"
 #include "triton/Analysis/AxisInfo.h"
 #include "triton/Analysis/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
@@ -111,7 +112,8 @@ class LoopPipeliner {
 
   /// Loads to be pipelined
   SetVector<Value> validLoads;
-  /// The value that each load will be mapped to (after layout conversion)
+  /// The value that each load will be mapped to (after layout conversion).
+  /// Loads that do not feed a dot are mapped to themselves.
   DenseMap<Value, Value> loadsMapping;
   /// load => buffer
   DenseMap<Value, Value> loadsBuffer;
@@ -137,6 +139,14 @@ class LoopPipeliner {
   /// numStages-1 is appended after the loop body.
   int numStages;
 
+  /// Shared memory available to the pipeline buffers, in bytes. When set,
+  /// numStages is only an upper bound; see selectNumStages.
+  int sharedMemoryCapacity;
+
+  /// Whether loads that do not feed a dot may be staged in shared memory and
+  /// converted back to their own layout
+  bool pipelineOtherLoads;
+
   /// Arg indicies
   size_t bufferIdx, loadIdx, depArgsBeginIdx, ivIndex;
   DenseMap<BlockArgument, size_t> depArgsIdx;
@@ -178,9 +188,25 @@ class LoopPipeliner {
   /// Check if none of the ops has valid uses
   LogicalResult checkOpUses(SetVector<Operation *> &ops);
 
+  /// Return true if `loadOp` can be staged in shared memory and converted back
+  /// to its own layout in the loop body
+  bool canPipelineInPlace(triton::LoadOp loadOp);
+
   /// Check if ops have dependencies that are not pipelinable
   void checkOpDeps(SetVector<Operation *> &ops);
 
+  /// Return the shared memory size, in bytes, of one stage of `loadOp`
+  int64_t getStageBytes(Value loadOp);
+
+  /// Return the largest scratch buffer, in bytes, that an operation of the
+  /// function containing the loop needs
+  int64_t getScratchBytes();
+
+  /// Lower numStages to the deepest pipeline whose buffers fit in
+  /// sharedMemoryCapacity, less the scratch buffers of the function, dropping
+  /// the largest loads if even a double buffer does not fit
+  LogicalResult selectNumStages(SetVector<Operation *> &ops);
+
   void createBufferTypes();
 
   void createOrderedDeps();
@@ -224,8 +250,11 @@ class LoopPipeliner {
   void finalizeYield(scf::ForOp newForOp, OpBuilder &builder);
 
 public:
-  LoopPipeliner(scf::ForOp forOp, int numStages)
-      : forOp(forOp), numStages(numStages) {
+  LoopPipeliner(scf::ForOp forOp, int numStages, int sharedMemoryCapacity = 0,
+                bool pipelineOtherLoads = false)
+      : forOp(forOp), numStages(numStages),
+        sharedMemoryCapacity(sharedMemoryCapacity),
+        pipelineOtherLoads(pipelineOtherLoads) {
     yieldOp = cast<scf::YieldOp>(forOp.getBody()->getTerminator());
   }
 
@@ -317,6 +346,27 @@ void LoopPipeliner::collectDeps(
   }
 }
 
+bool LoopPipeliner::canPipelineInPlace(triton::LoadOp loadOp) {
+  if (!pipelineOtherLoads)
+    return false;
+  // Loads that feed a dot keep the dot operand path, even when they have other
+  // uses: staging them twice would only add a round trip through shared memory
+  for (Operation *user : loadOp->getUsers())
+    if (auto cvt = dyn_cast<ttg::ConvertLayoutOp>(user))
+      if (cvt.getType()
+              .cast<RankedTensorType>()
+              .getEncoding()
+              .isa<ttg::DotOperandEncodingAttr>())
+        return false;
+  auto ty = loadOp.getType().cast<RankedTensorType>();
+  auto blockedEnc = ty.getEncoding().dyn_cast<ttg::BlockedEncodingAttr>();
+  if (!blockedEnc || ty.getRank() != 2)
+    return false;
+  // cp.async copies at least 4 bytes per thread
+  unsigned vec = blockedEnc.getSizePerThread()[blockedEnc.getOrder()[0]];
+  return vec * ty.getElementType().getIntOrFloatBitWidth() >= 32;
+}
+
 LogicalResult LoopPipeliner::checkOpUses(SetVector<Operation *> &ops) {
   DenseSet<Operation *> invalidOps;
   // Collect all ops' dependencies
@@ -336,10 +386,9 @@ LogicalResult LoopPipeliner::checkOpUses(SetVector<Operation *> &ops) {
             isCandidate = false;
             break;
           }
-      // We only pipeline loads that have one covert_layout (to dot_op) use
-      // TODO: lift this constraint in the future
+      // Loads that have one convert_layout (to dot_op) use are copied
+      // directly into the shared memory layout of the dot operand
       if (isCandidate && loadOp.getResult().hasOneUse()) {
-        isCandidate = false;
         Operation *use = *loadOp.getResult().getUsers().begin();
 
         // Advance to the first conversion as long as the use resides in shared
@@ -359,12 +408,16 @@ LogicalResult LoopPipeliner::checkOpUses(SetVector<Operation *> &ops) {
                                     .getType()
                                     .dyn_cast<RankedTensorType>())
             if (auto dotOpEnc = tensorType.getEncoding()
-                                    .dyn_cast<ttg::DotOperandEncodingAttr>()) {
-              isCandidate = true;
+                                    .dyn_cast<ttg::DotOperandEncodingAttr>())
               loadsMapping[loadOp] = convertLayout;
-            }
-      } else
-        isCandidate = false;
+      }
+      // Otherwise, stage the load in shared memory and convert it back to its
+      // own layout where it is used
+      if (isCandidate && !loadsMapping.count(loadOp)) {
+        isCandidate = canPipelineInPlace(loadOp);
+        if (isCandidate)
+          loadsMapping[loadOp] = loadOp;
+      }
 
       if (!isCandidate)
         invalidOps.insert(loadOp);
@@ -382,6 +435,67 @@ LogicalResult LoopPipeliner::checkOpUses(SetVector<Operation *> &ops) {
     return success();
 }
 
+int64_t LoopPipeliner::getStageBytes(Value loadOp) {
+  auto ty = loadOp.getType().cast<RankedTensorType>();
+  return product<int64_t>(ty.getShape()) *
+         ty.getElementType().getIntOrFloatBitWidth() / 8;
+}
+
+int64_t LoopPipeliner::getScratchBytes() {
+  int64_t scratchBytes = 0;
+  auto funcOp = forOp->getParentOfType<FunctionOpInterface>();
+  funcOp->walk([&](Operation *op) {
+    // Conversions to dot operands are decomposed through shared memory
+    // buffers later on; the ones in the loop are what gets pipelined.
+    if (auto cvt = dyn_cast<ttg::ConvertLayoutOp>(op))
+      if (cvt.getType()
+              .cast<RankedTensorType>()
+              .getEncoding()
+              .isa<ttg::DotOperandEncodingAttr>())
+        return;
+    if (auto bytes = triton::getScratchSizeInBytes(op))
+      scratchBytes = std::max<int64_t>(scratchBytes, *bytes);
+  });
+  return scratchBytes;
+}
+
+LogicalResult LoopPipeliner::selectNumStages(SetVector<Operation *> &ops) {
+  int maxStages = numStages;
+  // Scratch buffers only live during their operation, so at most the largest
+  // of them is allocated next to the pipeline buffers.
+  int64_t scratchBytes = getScratchBytes();
+  int64_t budget = sharedMemoryCapacity - scratchBytes;
+  while (!validLoads.empty()) {
+    int64_t stageBytes = 0;
+    for (Value loadOp : validLoads)
+      stageBytes += getStageBytes(loadOp);
+    // All loads share the same ring of buffers, so they are pipelined with the
+    // same depth.
+    int stages = std::min<int64_t>(maxStages, budget / stageBytes);
+    if (stages >= 2) {
+      numStages = stages;
+      auto remark = forOp.emitRemark()
+                    << "pipelined " << validLoads.size() << " load(s) with "
+                    << numStages << " stages using " << numStages * stageBytes
+                    << " bytes of shared memory";
+      if (scratchBytes > 0)
+        remark << " next to " << scratchBytes << " bytes of scratch";
+      return success();
+    }
+    // Not even a double buffer fits: leave the largest load in the loop body.
+    Value largest = *llvm::max_element(validLoads, [&](Value a, Value b) {
+      return getStageBytes(a) < getStageBytes(b);
+    });
+    largest.getDefiningOp()->emitRemark()
+        << "load not pipelined: " << 2 * getStageBytes(largest)
+        << " bytes of double buffering exceed the shared memory budget";
+    validLoads.remove(largest);
+    loadsMapping.erase(largest);
+    ops.remove(largest.getDefiningOp());
+  }
+  return failure();
+}
+
 void LoopPipeliner::checkOpDeps(SetVector<Operation *> &ops) {
   SetVector<BlockArgument> nonImmediateDepArgs;
   SetVector<Operation *> nonImmediateOps;
@@ -485,14 +599,26 @@ void LoopPipeliner::createBufferTypes() {
   for (auto loadCvt : loadsMapping) {
     auto loadOp = loadCvt.first;
     Value cvt = loadCvt.second;
-    auto dotOpEnc = cvt.getType()
-                        .cast<RankedTensorType>()
-                        .getEncoding()
-                        .cast<ttg::DotOperandEncodingAttr>();
     auto ty = loadOp.getType().cast<RankedTensorType>();
     SmallVector<int64_t> bufferShape(ty.getShape().begin(),
                                      ty.getShape().end());
     bufferShape.insert(bufferShape.begin(), numStages);
+    if (cvt == loadOp) {
+      // The buffer is read back in the load's own layout, with the same
+      // vectorization and no swizzling.
+      auto blockedEnc = ty.getEncoding().cast<ttg::BlockedEncodingAttr>();
+      auto order = blockedEnc.getOrder();
+      auto sharedEnc = ttg::SharedEncodingAttr::get(
+          ty.getContext(), blockedEnc.getSizePerThread()[order[0]],
+          /*perPhase=*/1, /*maxPhase=*/1, order);
+      loadsBufferType[loadOp] =
+          RankedTensorType::get(bufferShape, ty.getElementType(), sharedEnc);
+      continue;
+    }
+    auto dotOpEnc = cvt.getType()
+                        .cast<RankedTensorType>()
+                        .getEncoding()
+                        .cast<ttg::DotOperandEncodingAttr>();
     unsigned bitWidth = dotOpEnc.getMMAv2kWidth()
                             ? 32 / dotOpEnc.getMMAv2kWidth()
                             : ty.getElementType().getIntOrFloatBitWidth();
@@ -548,6 +674,9 @@ LogicalResult LoopPipeliner::initialize() {
   if (checkOpUses(ops).failed())
     return failure();
 
+  if (sharedMemoryCapacity > 0 && selectNumStages(ops).failed())
+    return failure();
+
   checkOpDeps(ops);
 
   createBufferTypes();
@@ -764,6 +893,18 @@ scf::ForOp LoopPipeliner::cloneForOp(ArrayRef<Value> newLoopArgs,
   // Clone the loop body, replace original args with args of the new ForOp
   // Insert async wait if necessary.
   for (Operation &op : forOp.getBody()->without_terminator()) {
+    // loads that do not feed a dot are read back from the extracted slice
+    if (op.getNumResults() == 1 && validLoads.contains(op.getResult(0)) &&
+        loadsMapping[op.getResult(0)] == op.getResult(0)) {
+      size_t i = std::distance(validLoads.begin(),
+                               llvm::find(validLoads, op.getResult(0)));
+      auto cvt = builder.create<ttg::ConvertLayoutOp>(
+          op.getLoc(), op.getResult(0).getType(),
+          newForOp.getRegionIterArgs()[loadIdx + i]);
+      mapping.map(op.getResult(0), cvt.getResult());
+      continue;
+    }
+
     // is modified
     auto it = std::find(validLoads.begin(), validLoads.end(), op.getOperand(0));
     if (it == validLoads.end()) {
@@ -773,6 +914,10 @@ scf::ForOp LoopPipeliner::cloneForOp(ArrayRef<Value> newLoopArgs,
 
     // we replace the use new load use with a convert layout
     size_t i = std::distance(validLoads.begin(), it);
+    if (loadsMapping[*it] == *it) {
+      builder.clone(op, mapping);
+      continue;
+    }
     auto cvtDstTy = op.getResult(0).getType().cast<RankedTensorType>();
     if (!cvtDstTy.getEncoding().isa<ttg::DotOperandEncodingAttr>()) {
       builder.clone(op, mapping);
@@ -973,10 +1118,18 @@ scf::ForOp LoopPipeliner::createNewForOp() {
 // ref: mlir/lib/Dialect/SCF/Transforms/LoopPipelining.cpp
 struct PipelinePass : public TritonGPUPipelineBase<PipelinePass> {
   PipelinePass() = default;
-  PipelinePass(int numStages) { this->numStages = numStages; }
+  PipelinePass(int numStages, bool autoNumStages, int computeCapability,
+               bool pipelineOtherLoads) {
+    this->numStages = numStages;
+    this->autoNumStages = autoNumStages;
+    this->computeCapability = computeCapability;
+    this->pipelineOtherLoads = pipelineOtherLoads;
+  }
 
   void runOnOperation() override {
     int numStages = this->numStages;
+    int sharedMemoryCapacity =
+        autoNumStages ? getSharedMemoryCapacity(computeCapability) : 0;
 
     if (numStages <= 1)
       return;
@@ -993,7 +1146,8 @@ struct PipelinePass : public TritonGPUPipelineBase<PipelinePass> {
 
     // Do the pipelining
     getOperation()->walk([&](scf::ForOp forOp) -> void {
-      LoopPipeliner pipeliner(forOp, numStages);
+      LoopPipeliner pipeliner(forOp, numStages, sharedMemoryCapacity,
+                              pipelineOtherLoads);
 
       if (pipeliner.initialize().failed())
         return;
@@ -1011,6 +1165,10 @@ struct PipelinePass : public TritonGPUPipelineBase<PipelinePass> {
 };
 } // anonymous namespace
 
-std::unique_ptr<Pass> mlir::createTritonGPUPipelinePass(int numStages) {
-  return std::make_unique<PipelinePass>(numStages);
+std::unique_ptr<Pass>
+mlir::createTritonGPUPipelinePass(int numStages, bool autoNumStages,
+                                  int computeCapability,
+                                  bool pipelineOtherLoads) {
+  return std::make_unique<PipelinePass>(numStages, autoNumStages,
+                                        computeCapability, pipelineOtherLoads);
 }
@@ -24,9 +24,15 @@
 //   ...
 //   scf.yield %next_a, ..., %a_prefetch_next
 // }
+//
+// The width of the slices is inferred from the K of the MMA instruction and
+// the register budget of the prefetched operands. On large-K tiles, two slices
+// are kept in flight instead of one: the loop carries the first two slices and
+// each slice is converted two dots ahead of its use.
 //===----------------------------------------------------------------------===//
 
 #include "mlir/IR/IRMapping.h"
+#include "triton/Analysis/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 
@@ -37,17 +43,30 @@ using namespace mlir;
 
 namespace {
 
+/// 32-bit registers per thread that the slices of a and b in flight may take
+constexpr int64_t prefetchRegisterBudget = 32;
+
+/// How the K dimension of one dot is prefetched
+struct PrefetchShape {
+  /// K of each prefetched slice
+  unsigned width = 32;
+  /// number of slices in flight
+  unsigned depth = 1;
+  /// kWidth of the slices: that of the dot operands, or width / 8 when the
+  /// operands have none
+  unsigned kWidth = 0;
+};
+
 class Prefetcher {
   /// cache the ForOp we are working on
   scf::ForOp forOp;
   /// cache the YieldOp of this ForOp
   scf::YieldOp yieldOp;
-  ///
-  // TODO: add a hook to infer prefetchWidth
-  unsigned prefetchWidth = 32;
 
   /// dots to be prefetched
   SetVector<Value> dots;
+  /// dot => prefetch shape
+  DenseMap<Value, PrefetchShape> dot2Shape;
   /// dot => dot operand
   DenseMap<Value, Value> dot2aLoopArg;
   DenseMap<Value, Value> dot2aHeaderDef;
@@ -57,15 +76,19 @@ class Prefetcher {
   DenseMap<Value, Value> dot2bYield;
   DenseMap<Value, SmallVector<Value>> dot2aVals;
   DenseMap<Value, SmallVector<Value>> dot2bVals;
-  /// operand => defining
-  DenseMap<Value, Value> operand2headPrefetch;
+  /// dot => (a, b) slices prefetched before the loop, for each slice in
+  /// flight
+  DenseMap<Value, SmallVector<Value>> dot2headPrefetch;
 
   LogicalResult isForOpOperand(Value v);
 
-  Value generatePrefetch(Value v, unsigned opIdx, bool isPrologue,
-                         Attribute dotEncoding, OpBuilder &builder,
-                         std::optional<int64_t> offsetK = std::nullopt,
-                         std::optional<int64_t> shapeK = std::nullopt);
+  /// Infer the slice width and depth of `dot`, whose operands have `kWidth`
+  PrefetchShape inferPrefetchShape(triton::DotOp dot, unsigned kWidth);
+
+  /// Convert the slice [offsetK, offsetK + shape.width) of K of `v`
+  Value generatePrefetch(Value v, unsigned opIdx, Attribute dotEncoding,
+                         const PrefetchShape &shape, int64_t offsetK,
+                         OpBuilder &builder);
 
   void cloneElementwiseOps(Value &bRem, const SmallVector<Value> &vals,
                            OpBuilder &builder);
@@ -102,10 +125,50 @@ void Prefetcher::cloneElementwiseOps(Value &ret, const SmallVector<Value> &vals,
     ret = mapping.lookup(vals.back());
 }
 
-Value Prefetcher::generatePrefetch(Value v, unsigned opIdx, bool isPrologue,
-                                   Attribute dotEncoding, OpBuilder &builder,
-                                   std::optional<int64_t> offsetK,
-                                   std::optional<int64_t> shapeK) {
+PrefetchShape Prefetcher::inferPrefetchShape(triton::DotOp dot,
+                                             unsigned kWidth) {
+  auto aType = dot.getA().getType().cast<RankedTensorType>();
+  auto bType = dot.getB().getType().cast<RankedTensorType>();
+  int64_t kSize = aType.getShape()[1];
+  unsigned elementWidth = aType.getElementTypeBitWidth();
+
+  // Start from the K of one MMA instruction: k16 for 16-bit operands, k8 for
+  // tf32 and k32 for int8
+  PrefetchShape shape;
+  if (kWidth == 0) {
+    shape.width = 256 / elementWidth;
+    shape.kWidth = shape.width / 8;
+    return shape;
+  }
+  shape.width = 8 * kWidth;
+  shape.kWidth = kWidth;
+
+  auto dotEncoding = dot.getType().cast<RankedTensorType>().getEncoding();
+  int64_t numThreads =
+      32 * product<unsigned>(triton::gpu::getWarpsPerCTA(dotEncoding));
+  auto getRegisters = [&](int64_t width) {
+    int64_t bits = (aType.getShape()[0] + bType.getShape()[1]) * width *
+                   elementWidth;
+    return bits / 32 / numThreads;
+  };
+
+  // Keep a second slice in flight if there are enough dots to hide it behind
+  if (kSize / shape.width >= 4 &&
+      2 * getRegisters(shape.width) <= prefetchRegisterBudget)
+    shape.depth = 2;
+  // Widen the slices as long as they fit in registers and there are still two
+  // dots per slice in flight
+  while (kSize % (2 * shape.width) == 0 &&
+         kSize / (2 * shape.width) >= 2 * shape.depth &&
+         shape.depth * getRegisters(2 * shape.width) <= prefetchRegisterBudget)
+    shape.width *= 2;
+  return shape;
+}
+
+Value Prefetcher::generatePrefetch(Value v, unsigned opIdx,
+                                   Attribute dotEncoding,
+                                   const PrefetchShape &prefetchShape,
+                                   int64_t offsetK, OpBuilder &builder) {
   // opIdx: 0 => a, 1 => b
   auto type = v.getType().cast<RankedTensorType>();
   SmallVector<int64_t> shape{type.getShape().begin(), type.getShape().end()};
@@ -114,16 +177,9 @@ Value Prefetcher::generatePrefetch(Value v, unsigned opIdx, bool isPrologue,
 
   auto intAttr = [&](int64_t val) { return builder.getI64IntegerAttr(val); };
 
-  // k => (prefetchWidth, k - prefetchWidth)
   int64_t kIdx = opIdx == 0 ? 1 : 0;
-
-  offset[kIdx] = isPrologue ? 0 : prefetchWidth;
-  shape[kIdx] = isPrologue ? prefetchWidth : (shape[kIdx] - prefetchWidth);
-
-  if (shapeK)
-    shape[kIdx] = *shapeK;
-  if (offsetK)
-    offset[kIdx] = *offsetK;
+  offset[kIdx] = offsetK;
+  shape[kIdx] = prefetchShape.width;
 
   Value newSmem = builder.create<triton::gpu::ExtractSliceOp>(
       v.getLoc(), RankedTensorType::get(shape, elementType, type.getEncoding()),
@@ -132,7 +188,7 @@ Value Prefetcher::generatePrefetch(Value v, unsigned opIdx, bool isPrologue,
       SmallVector<OpFoldResult>{intAttr(1), intAttr(1)});
 
   auto dotOperandEnc = triton::gpu::DotOperandEncodingAttr::get(
-      builder.getContext(), opIdx, dotEncoding, prefetchWidth / 8);
+      builder.getContext(), opIdx, dotEncoding, prefetchShape.kWidth);
   Value prefetchSlice = builder.create<triton::gpu::ConvertLayoutOp>(
       v.getLoc(), RankedTensorType::get(shape, elementType, dotOperandEnc),
       newSmem);
@@ -209,15 +265,10 @@ LogicalResult Prefetcher::initialize() {
 
     auto kSize = aType.getShape()[1];
 
-    // works better with nvidia tensor cores
-    unsigned elementWidth = aType.getElementTypeBitWidth();
-    if (aKWidth == 0)
-      prefetchWidth = 256 / elementWidth;
-    else
-      prefetchWidth = 8 * aKWidth;
+    PrefetchShape shape = inferPrefetchShape(dot, aKWidth);
 
-    // Skip prefetching if kSize is less than prefetchWidth
-    if (kSize < prefetchWidth)
+    // Skip prefetching if kSize is not a multiple of the slice width
+    if (kSize < shape.width || kSize % shape.width != 0)
       continue;
     auto aVals = getPrefetchSrc(dot.getA());
     auto bVals = getPrefetchSrc(dot.getB());
@@ -230,6 +281,7 @@ LogicalResult Prefetcher::initialize() {
       // Only prefetch loop arg
       if (aHeaderDef && bHeaderDef) {
         dots.insert(dot);
+        dot2Shape[dot] = shape;
         dot2aVals[dot] = aVals;
         dot2bVals[dot] = bVals;
         dot2aHeaderDef[dot] = aHeaderDef;
@@ -251,31 +303,33 @@ void Prefetcher::emitPrologue() {
   for (Value dot : dots) {
     Attribute dotEncoding =
         dot.getType().cast<RankedTensorType>().getEncoding();
-    Value aPrefetched =
-        generatePrefetch(dot2aHeaderDef[dot], 0, true, dotEncoding, builder);
-    cloneElementwiseOps(aPrefetched, dot2aVals[dot], builder);
-    Value bPrefetched =
-        generatePrefetch(dot2bHeaderDef[dot], 1, true, dotEncoding, builder);
-    cloneElementwiseOps(bPrefetched, dot2bVals[dot], builder);
-
-    operand2headPrefetch[dot.getDefiningOp<triton::DotOp>().getA()] =
-        aPrefetched;
-    operand2headPrefetch[dot.getDefiningOp<triton::DotOp>().getB()] =
-        bPrefetched;
+    const PrefetchShape &shape = dot2Shape[dot];
+    for (unsigned i = 0; i < shape.depth; ++i) {
+      Value aPrefetched = generatePrefetch(dot2aHeaderDef[dot], 0, dotEncoding,
+                                           shape, i * shape.width, builder);
+      cloneElementwiseOps(aPrefetched, dot2aVals[dot], builder);
+      Value bPrefetched = generatePrefetch(dot2bHeaderDef[dot], 1, dotEncoding,
+                                           shape, i * shape.width, builder);
+      cloneElementwiseOps(bPrefetched, dot2bVals[dot], builder);
+
+      dot2headPrefetch[dot].push_back(aPrefetched);
+      dot2headPrefetch[dot].push_back(bPrefetched);
+    }
   }
 }
 
 scf::ForOp Prefetcher::createNewForOp() {
   OpBuilder builder(forOp);
 
+  // Order of new args: (original args), then (a slice, b slice) for each slice
+  // in flight of each dot
   SmallVector<Value> loopArgs;
   for (auto v : forOp.getIterOperands())
     loopArgs.push_back(v);
+  DenseMap<Value, unsigned> dot2PrefetchArgIdx;
   for (Value dot : dots) {
-    loopArgs.push_back(
-        operand2headPrefetch[dot.getDefiningOp<triton::DotOp>().getA()]);
-    loopArgs.push_back(
-        operand2headPrefetch[dot.getDefiningOp<triton::DotOp>().getB()]);
+    dot2PrefetchArgIdx[dot] = loopArgs.size();
+    loopArgs.append(dot2headPrefetch[dot]);
   }
 
   auto newForOp = builder.create<scf::ForOp>(
@@ -289,52 +343,45 @@ scf::ForOp Prefetcher::createNewForOp() {
   mapping.map(forOp.getInductionVar(), newForOp.getInductionVar());
 
   for (Operation &op : forOp.getBody()->without_terminator()) {
-    Operation *newOp = builder.clone(op, mapping);
     auto dot = dyn_cast<triton::DotOp>(&op);
-    if (dot && dots.contains(dot)) {
-      Attribute dotEncoding =
-          dot.getType().cast<RankedTensorType>().getEncoding();
-      // prefetched dot
-      Operation *firstDot = builder.clone(*dot, mapping);
-      if (Value a = operand2headPrefetch.lookup(dot.getA()))
-        firstDot->setOperand(
-            0, newForOp.getRegionIterArgForOpOperand(*a.use_begin()));
-      if (Value b = operand2headPrefetch.lookup(dot.getB()))
-        firstDot->setOperand(
-            1, newForOp.getRegionIterArgForOpOperand(*b.use_begin()));
-
-      // remaining part
-      int64_t kOff = prefetchWidth;
-      int64_t kRem =
-          dot.getA().getType().cast<RankedTensorType>().getShape()[1] -
-          prefetchWidth;
-      Operation *prevDot = firstDot;
-      while (kRem != 0) {
-        // int64_t kShape = largestPow2(kRem);
-        int64_t kShape = prefetchWidth;
-        auto insertionPoint = builder.saveInsertionPoint();
-        builder.setInsertionPoint(prevDot);
-        Value aRem =
-            generatePrefetch(mapping.lookup(dot2aLoopArg[dot]), 0, false,
-                             dotEncoding, builder, kOff, kShape);
-        cloneElementwiseOps(aRem, dot2aVals[dot], builder);
-        Value bRem =
-            generatePrefetch(mapping.lookup(dot2bLoopArg[dot]), 1, false,
-                             dotEncoding, builder, kOff, kShape);
-        cloneElementwiseOps(bRem, dot2bVals[dot], builder);
-        builder.restoreInsertionPoint(insertionPoint);
-        newOp = builder.clone(*dot, mapping);
-        newOp->setOperand(0, aRem);
-        newOp->setOperand(1, bRem);
-        newOp->setOperand(2, prevDot->getResult(0));
-        prevDot = newOp;
-        kOff += kShape;
-        kRem -= kShape;
+    if (!dot || !dots.contains(dot)) {
+      builder.clone(op, mapping);
+      continue;
+    }
+
+    // Split the dot along K. The first shape.depth slices are loop
+    // arguments; every other slice is converted shape.depth dots ahead of
+    // its use.
+    Attribute dotEncoding =
+        dot.getType().cast<RankedTensorType>().getEncoding();
+    int64_t kSize =
+        dot.getA().getType().cast<RankedTensorType>().getShape()[1];
+    const PrefetchShape &shape = dot2Shape[dot];
+    unsigned argIdx = dot2PrefetchArgIdx[dot];
+    SmallVector<Operation *> slicedDots;
+    for (unsigned i = 0, e = kSize / shape.width; i < e; ++i) {
+      Value a, b;
+      if (i < shape.depth) {
+        a = newForOp.getRegionIterArgs()[argIdx + 2 * i];
+        b = newForOp.getRegionIterArgs()[argIdx + 2 * i + 1];
+      } else {
+        OpBuilder::InsertionGuard g(builder);
+        builder.setInsertionPoint(slicedDots[i - shape.depth]);
+        a = generatePrefetch(mapping.lookup(dot2aLoopArg[dot]), 0, dotEncoding,
+                             shape, i * shape.width, builder);
+        cloneElementwiseOps(a, dot2aVals[dot], builder);
+        b = generatePrefetch(mapping.lookup(dot2bLoopArg[dot]), 1, dotEncoding,
+                             shape, i * shape.width, builder);
+        cloneElementwiseOps(b, dot2bVals[dot], builder);
       }
+      Operation *newOp = builder.clone(*dot, mapping);
+      newOp->setOperand(0, a);
+      newOp->setOperand(1, b);
+      if (!slicedDots.empty())
+        newOp->setOperand(2, slicedDots.back()->getResult(0));
+      slicedDots.push_back(newOp);
     }
-    // update mapping of results
-    for (unsigned dstIdx : llvm::seq(unsigned(0), op.getNumResults()))
-      mapping.map(op.getResult(dstIdx), newOp->getResult(dstIdx));
+    mapping.map(dot.getResult(), slicedDots.back()->getResult(0));
   }
 
   // prefetch next iteration
@@ -344,15 +391,19 @@ scf::ForOp Prefetcher::createNewForOp() {
   for (Value dot : dots) {
     Attribute dotEncoding =
         dot.getType().cast<RankedTensorType>().getEncoding();
-    Value aToYield = generatePrefetch(mapping.lookup(dot2aYield[dot]), 0, true,
-                                      dotEncoding, builder);
-    cloneElementwiseOps(aToYield, dot2aVals[dot], builder);
-    yieldValues.push_back(aToYield);
-    // bToYield
-    Value bToYield = generatePrefetch(mapping.lookup(dot2bYield[dot]), 1, true,
-                                      dotEncoding, builder);
-    cloneElementwiseOps(bToYield, dot2bVals[dot], builder);
-    yieldValues.push_back(bToYield);
+    const PrefetchShape &shape = dot2Shape[dot];
+    for (unsigned i = 0; i < shape.depth; ++i) {
+      Value aToYield = generatePrefetch(mapping.lookup(dot2aYield[dot]), 0,
+                                        dotEncoding, shape, i * shape.width,
+                                        builder);
+      cloneElementwiseOps(aToYield, dot2aVals[dot], builder);
+      yieldValues.push_back(aToYield);
+      Value bToYield = generatePrefetch(mapping.lookup(dot2bYield[dot]), 1,
+                                        dotEncoding, shape, i * shape.width,
+                                        builder);
+      cloneElementwiseOps(bToYield, dot2bVals[dot], builder);
+      yieldValues.push_back(bToYield);
+    }
   }
   // Update ops of yield
   if (!yieldValues.empty())
@@ -0,0 +1,250 @@
+//===----------------------------------------------------------------------===//
+//
+// This pass remaps the program ids of GEMM-like kernels so that programs that
+// run at the same time reuse the same rows of A and columns of B in L2.
+//
+// For example, with "grouped-row" and a group of 8:
+// %m = tt.get_program_id x
+// %n = tt.get_program_id y
+//
+// will be translated to
+//
+// %linear = %x + %y * num_programs(x)
+// %band = %linear / (8 * num_programs(y))
+// %rows = min(num_programs(x) - %band * 8, 8)
+// %local = %linear % (8 * num_programs(y))
+// %m = %band * 8 + %local % %rows
+// %n = %local / %rows
+//
+// Kernels launched on a 1D grid that split `tt.get_program_id x` row-major
+// into (pid / num_pid_n, pid % num_pid_n) name the argument num_pid_n is
+// derived from with a `triton_gpu.rasterization-columns = [arg, block]`
+// attribute. The program id itself is then the linear id, the grid has
+// cdiv(%arg, block) columns, and the id is replaced by %m * columns + %n so
+// that the kernel's own split yields the remapped tile.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/ADT/StringSwitch.h"
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+enum class RasterOrder { GroupedRow, Morton, Hilbert };
+
+/// Builds the i32 index arithmetic of the remapping
+class TileIndexBuilder {
+  OpBuilder &builder;
+  Location loc;
+
+public:
+  TileIndexBuilder(OpBuilder &builder, Location loc)
+      : builder(builder), loc(loc) {}
+
+  Value i32(int64_t v) {
+    return builder.create<arith::ConstantIntOp>(loc, v, 32);
+  }
+  Value add(Value a, Value b) { return builder.create<arith::AddIOp>(loc, a, b); }
+  Value sub(Value a, Value b) { return builder.create<arith::SubIOp>(loc, a, b); }
+  Value mul(Value a, Value b) { return builder.create<arith::MulIOp>(loc, a, b); }
+  Value div(Value a, Value b) {
+    return builder.create<arith::DivUIOp>(loc, a, b);
+  }
+  Value rem(Value a, Value b) {
+    return builder.create<arith::RemUIOp>(loc, a, b);
+  }
+  Value min(Value a, Value b) {
+    return builder.create<arith::MinUIOp>(loc, a, b);
+  }
+  Value bit(Value v, unsigned i) {
+    return builder.create<arith::AndIOp>(
+        loc, builder.create<arith::ShRUIOp>(loc, v, i32(i)), i32(1));
+  }
+  Value eq(Value a, Value b) {
+    return builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq, a, b);
+  }
+  Value ult(Value a, Value b) {
+    return builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ult, a,
+                                         b);
+  }
+  Value select(Value cond, Value a, Value b) {
+    return builder.create<arith::SelectOp>(loc, cond, a, b);
+  }
+
+  /// Coordinates of the `index`-th point of a Z-order curve over a
+  /// 2^bits x 2^bits square
+  std::pair<Value, Value> morton(Value index, unsigned bits) {
+    Value row = i32(0);
+    Value col = i32(0);
+    for (unsigned i = 0; i < bits; ++i) {
+      row = builder.create<arith::OrIOp>(
+          loc, row,
+          builder.create<arith::ShLIOp>(loc, bit(index, 2 * i), i32(i)));
+      col = builder.create<arith::OrIOp>(
+          loc, col,
+          builder.create<arith::ShLIOp>(loc, bit(index, 2 * i + 1), i32(i)));
+    }
+    return {row, col};
+  }
+
+  /// Coordinates of the `index`-th point of a Hilbert curve over a
+  /// size x size square
+  std::pair<Value, Value> hilbert(Value index, unsigned size) {
+    Value x = i32(0);
+    Value y = i32(0);
+    Value t = index;
+    for (unsigned s = 1; s < size; s *= 2) {
+      Value rx = bit(t, 1);
+      Value ry = builder.create<arith::AndIOp>(
+          loc, builder.create<arith::XOrIOp>(loc, t, rx), i32(1));
+      // rotate the quadrant
+      Value ryZero = eq(ry, i32(0));
+      Value flip = builder.create<arith::AndIOp>(loc, ryZero, eq(rx, i32(1)));
+      Value xFlipped = select(flip, sub(i32(s - 1), x), x);
+      Value yFlipped = select(flip, sub(i32(s - 1), y), y);
+      x = add(select(ryZero, yFlipped, xFlipped), mul(i32(s), rx));
+      y = add(select(ryZero, xFlipped, yFlipped), mul(i32(s), ry));
+      t = builder.create<arith::ShRUIOp>(loc, t, i32(2));
+    }
+    return {y, x};
+  }
+};
+
+class RasterizePass : public TritonGPURasterizeBase<RasterizePass> {
+public:
+  LogicalResult rasterize(triton::FuncOp funcOp, RasterOrder order,
+                          unsigned group);
+
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+    auto orderAttr = m->getAttrOfType<StringAttr>("triton_gpu.rasterization");
+    if (!orderAttr)
+      return;
+    std::optional<RasterOrder> order =
+        llvm::StringSwitch<std::optional<RasterOrder>>(orderAttr.getValue())
+            .Case("grouped-row", RasterOrder::GroupedRow)
+            .Case("morton", RasterOrder::Morton)
+            .Case("hilbert", RasterOrder::Hilbert)
+            .Default(std::nullopt);
+    if (!order) {
+      m.emitError() << "unknown rasterization order " << orderAttr;
+      return signalPassFailure();
+    }
+    unsigned group = 8;
+    if (auto groupAttr =
+            m->getAttrOfType<IntegerAttr>("triton_gpu.rasterization-group"))
+      group = groupAttr.getInt();
+    if (group == 0 ||
+        (*order != RasterOrder::GroupedRow && !llvm::isPowerOf2_32(group))) {
+      m.emitError() << "invalid rasterization group " << group;
+      return signalPassFailure();
+    }
+    m.walk([&](triton::FuncOp funcOp) {
+      if (failed(rasterize(funcOp, *order, group)))
+        signalPassFailure();
+    });
+  }
+};
+
+LogicalResult RasterizePass::rasterize(triton::FuncOp funcOp,
+                                       RasterOrder order, unsigned group) {
+  SmallVector<triton::GetProgramIdOp> pidsX, pidsY;
+  funcOp.walk([&](triton::GetProgramIdOp op) {
+    if (op.getAxis() == triton::ProgramIDDim::X)
+      pidsX.push_back(op);
+    else if (op.getAxis() == triton::ProgramIDDim::Y)
+      pidsY.push_back(op);
+  });
+  if (pidsX.empty())
+    return success();
+
+  // Without a y id, the shape of the grid cannot be recovered from the launch
+  // and has to come from the kernel arguments
+  auto columnsAttr = funcOp->getAttrOfType<DenseI32ArrayAttr>(
+      "triton_gpu.rasterization-columns");
+  bool linearGrid = pidsY.empty();
+  if (linearGrid) {
+    if (!columnsAttr)
+      return success();
+    ArrayRef<int32_t> columns = columnsAttr.asArrayRef();
+    if (columns.size() != 2 || columns[0] < 0 ||
+        columns[0] >= (int32_t)funcOp.getNumArguments() ||
+        !funcOp.getArgument(columns[0]).getType().isInteger(32) ||
+        columns[1] <= 0)
+      return funcOp.emitError()
+             << "invalid rasterization columns " << columnsAttr;
+  }
+
+  Location loc = funcOp.getLoc();
+  OpBuilder builder(funcOp.getBody());
+  TileIndexBuilder b(builder, loc);
+  Type i32Ty = builder.getI32Type();
+  Value x = builder.create<triton::GetProgramIdOp>(loc, i32Ty,
+                                                   triton::ProgramIDDim::X);
+  Value gridM = builder.create<triton::GetNumProgramsOp>(
+      loc, i32Ty, builder.getI32IntegerAttr(0));
+  Value linear, gridN;
+  if (linearGrid) {
+    ArrayRef<int32_t> columns = columnsAttr.asArrayRef();
+    Value block = b.i32(columns[1]);
+    Value size = funcOp.getArgument(columns[0]);
+    gridN = b.div(b.add(size, b.i32(columns[1] - 1)), block);
+    linear = x;
+    gridM = b.div(gridM, gridN);
+  } else {
+    Value y = builder.create<triton::GetProgramIdOp>(loc, i32Ty,
+                                                     triton::ProgramIDDim::Y);
+    gridN = builder.create<triton::GetNumProgramsOp>(
+        loc, i32Ty, builder.getI32IntegerAttr(1));
+    linear = b.add(x, b.mul(y, gridM));
+  }
+
+  // Split the linear id into bands of `group` rows
+  Value groupSize = b.i32(group);
+  Value bandTiles = b.mul(groupSize, gridN);
+  Value firstRow = b.mul(b.div(linear, bandTiles), groupSize);
+  Value bandRows = b.min(b.sub(gridM, firstRow), groupSize);
+  Value local = b.rem(linear, bandTiles);
+  Value row = b.add(firstRow, b.rem(local, bandRows));
+  Value col = b.div(local, bandRows);
+
+  if (order != RasterOrder::GroupedRow) {
+    // Follow the curve within the group x group squares of full bands
+    Value squareTiles = b.i32(group * group);
+    Value fullSquares = b.div(gridN, groupSize);
+    Value inSquare = builder.create<arith::AndIOp>(
+        loc, b.eq(bandRows, groupSize),
+        b.ult(local, b.mul(fullSquares, squareTiles)));
+    Value square = b.div(local, squareTiles);
+    Value within = b.rem(local, squareTiles);
+    auto [dRow, dCol] = order == RasterOrder::Morton
+                            ? b.morton(within, llvm::Log2_32(group))
+                            : b.hilbert(within, group);
+    row = b.select(inSquare, b.add(firstRow, dRow), row);
+    col = b.select(inSquare, b.add(b.mul(square, groupSize), dCol), col);
+  }
+
+  if (linearGrid)
+    row = b.add(b.mul(row, gridN), col);
+  for (triton::GetProgramIdOp op : pidsX) {
+    op.getResult().replaceAllUsesWith(row);
+    op.erase();
+  }
+  for (triton::GetProgramIdOp op : pidsY) {
+    op.getResult().replaceAllUsesWith(col);
+    op.erase();
+  }
+  return success();
+}
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::createTritonGPURasterizePass() {
+  return std::make_unique<RasterizePass>();
+}
@@ -327,9 +327,11 @@ public:
 //
 class RematerializeForward : public mlir::RewritePattern {
 public:
-  explicit RematerializeForward(mlir::MLIRContext *context)
+  explicit RematerializeForward(mlir::MLIRContext *context,
+                                RematerializationCache *cache = nullptr)
       : mlir::RewritePattern(triton::gpu::ConvertLayoutOp::getOperationName(),
-                             1, context) {}
+                             1, context),
+        cache(cache) {}
 
   mlir::LogicalResult
   matchAndRewrite(mlir::Operation *cvtOp,
@@ -366,7 +368,8 @@ public:
 
     for (Operation *op : cvtSlices) {
       // don't rematerialize anything expensive
-      if (isExpensiveToRemat(op, srcEncoding))
+      if (cache ? cache->isExpensiveToRemat(op, srcEncoding)
+                : isExpensiveToRemat(op, srcEncoding))
         return failure();
       // don't rematerialize non-element-wise
       if (!op->hasTrait<mlir::OpTrait::SameOperandsAndResultEncoding>() &&
@@ -382,7 +385,7 @@ public:
         SetVector<Attribute> layout;
         llvm::MapVector<Value, Attribute> toConvert;
         int numAddedConvs = simulateBackwardRematerialization(
-            argOp, processed, layout, toConvert, srcEncoding);
+            argOp, processed, layout, toConvert, srcEncoding, cache);
         if (argOp && !isa<triton::gpu::ConvertLayoutOp>(argOp) &&
             cvtSlices.count(argOp) == 0 && numAddedConvs > 0)
           return failure();
@@ -394,8 +397,15 @@ public:
       return failure();
 
     pushConversionForward(cvt, cvtSlices, rewriter);
+    // pushConversionForward moves operations in place, which the rewriter
+    // does not report to the cache.
+    if (cache)
+      cache->clear();
     return success();
   }
+
+private:
+  RematerializationCache *cache;
 };
 
 // Layout conversions are expensive. They require going through
@@ -406,9 +416,11 @@ public:
 // are reachable from it without passing through any memory operation.
 class RematerializeBackward : public mlir::RewritePattern {
 public:
-  explicit RematerializeBackward(mlir::MLIRContext *context)
+  explicit RematerializeBackward(mlir::MLIRContext *context,
+                                 RematerializationCache *cache = nullptr)
       : mlir::RewritePattern(triton::gpu::ConvertLayoutOp::getOperationName(),
-                             3, context) {}
+                             3, context),
+        cache(cache) {}
 
   mlir::LogicalResult
   matchAndRewrite(mlir::Operation *cvt,
@@ -433,15 +445,22 @@ public:
     SetVector<Attribute> layout;
     llvm::MapVector<Value, Attribute> toConvert;
     if (simulateBackwardRematerialization(cvt, processed, layout, toConvert,
-                                          targetType.getEncoding()) > 0)
+                                          targetType.getEncoding(), cache) > 0)
       return mlir::failure();
 
     IRMapping mapping;
     rematerializeConversionChain(toConvert, rewriter, processed, mapping);
     rewriter.replaceOp(cvt, mapping.lookup(cvt->getOperand(0)));
+    // rematerializeConversionChain moves operations in place, which the
+    // rewriter does not report to the cache.
+    if (cache)
+      cache->clear();
 
     return mlir::success();
   }
+
+private:
+  RematerializationCache *cache;
 };
 
 // -----------------------------------------------------------------------------
@@ -450,8 +469,10 @@ public:
 
 class MoveConvertOutOfLoop : public mlir::RewritePattern {
 public:
-  explicit MoveConvertOutOfLoop(mlir::MLIRContext *context)
-      : mlir::RewritePattern(scf::ForOp::getOperationName(), 1, context) {}
+  explicit MoveConvertOutOfLoop(mlir::MLIRContext *context,
+                                RematerializationCache *cache = nullptr)
+      : mlir::RewritePattern(scf::ForOp::getOperationName(), 1, context),
+        cache(cache) {}
 
   SmallVector<Value, 4>
   rematerializeForLoop(mlir::PatternRewriter &rewriter, scf::ForOp &forOp,
@@ -507,7 +528,7 @@ public:
       if (!iterArg.value().getType().isa<RankedTensorType>())
         continue;
       SmallVector<Operation *> cvts;
-      if (canMoveOutOfLoop(iterArg.value(), cvts).failed())
+      if (canMoveOutOfLoop(iterArg.value(), cvts, cache).failed())
         continue;
       // check
       for (auto *op : cvts) {
@@ -516,11 +537,18 @@ public:
         auto newFor = rematerializeForLoop(rewriter, forOp, iterArg.index(),
                                            targetType, cvt);
         rewriter.replaceOp(forOp, newFor);
+        // rematerializeForLoop moves operations in place, which the rewriter
+        // does not report to the cache.
+        if (cache)
+          cache->clear();
         return success();
       }
     }
     return failure();
   }
+
+private:
+  RematerializationCache *cache;
 };
 
 //
@@ -580,6 +608,488 @@ public:
   }
 };
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+
+// Deterministic alternative to the greedy rematerialization patterns above.
+//
+// Layouts are seeded on "anchor" operations (expensive loads and stores, dots,
+// atomics and ops whose encoding cannot be inverted) and propagated forward
+// through the def-use graph, including loop-carried values of scf.for and the
+// results of scf.if. A value reachable from several anchors may end up with
+// several candidate encodings; a small cost model then picks one per value,
+// and the function is rewritten once, inserting a conversion only where a
+// value is consumed in an encoding different from the one it was assigned.
+// Values are visited in program order so the result does not depend on any
+// worklist order.
+class LayoutPropagation {
+public:
+  // Candidate encodings for a given value.
+  struct LayoutInfo {
+    LayoutInfo(Attribute encoding) { encodings.insert(encoding); }
+    LayoutInfo() {}
+    llvm::SmallSetVector<Attribute, 4> encodings;
+  };
+
+  explicit LayoutPropagation(triton::FuncOp funcOp) : funcOp(funcOp) {}
+
+  // Seed the layout of anchor operations.
+  void initAnchorLayout();
+  // Propagate the anchor layouts to all reachable values.
+  void propagateLayout();
+  // Pick a single encoding for every value with several candidates.
+  void resolveConflicts();
+  // Rewrite the function so that every value uses its assigned encoding.
+  void rewrite();
+
+private:
+  SmallVector<Value> propagateToUsers(Value value, LayoutInfo &info);
+  void setEncoding(ValueRange values, LayoutInfo &info,
+                   SmallVector<Value> &changed, Operation *op);
+  int64_t getConflictCost(Value value, Attribute encoding);
+
+  void rewriteRegion(Region &region);
+  Operation *rewriteOp(Operation *op);
+  Operation *rewriteForOp(scf::ForOp forOp);
+  Operation *rewriteIfOp(scf::IfOp ifOp);
+  void rewriteYieldOp(scf::YieldOp yieldOp);
+  void rewriteReduceToScalar(Operation *reduceOp);
+  Operation *cloneElementwise(OpBuilder &rewriter, Operation *op,
+                              Attribute encoding);
+  void map(Value oldV, Value newV);
+  Value getValueAs(Value value, Attribute encoding);
+
+  // Assigned encodings, in the order values were first reached.
+  llvm::MapVector<Value, LayoutInfo> layouts;
+  // Rewritten value for a given (original value, encoding) pair.
+  DenseMap<std::pair<Value, Attribute>, Value> rewriteMapping;
+  // Conversions created by getValueAs, so that a value converted to the same
+  // encoding twice shares a single conversion.
+  DenseMap<std::pair<Value, Attribute>, Value> convertMapping;
+  std::vector<Operation *> opToDelete;
+  triton::FuncOp funcOp;
+};
+
+// Operations whose layout should not be changed; layouts are propagated
+// starting from them.
+static bool isLayoutAnchor(Operation *op) {
+  if (isa<triton::LoadOp, triton::StoreOp>(op)) {
+    Attribute encoding;
+    return isExpensiveLoadOrStore(op, encoding);
+  }
+  return isa<triton::DotOp, triton::AtomicRMWOp, triton::AtomicCASOp,
+             triton::ViewOp, triton::CatOp>(op);
+}
+
+// Operations through which a layout can be propagated from operands to
+// results.
+static bool canPropagateThrough(Operation *op) {
+  return op->hasTrait<mlir::OpTrait::SameOperandsAndResultEncoding>() ||
+         op->hasTrait<mlir::OpTrait::Elementwise>() ||
+         isa<triton::ReduceOp, triton::ExpandDimsOp,
+             triton::gpu::ConvertLayoutOp>(op);
+}
+
+// Reductions to a scalar can have their operand encoding changed without
+// affecting their result.
+static bool reduceToScalar(Operation *op) {
+  return isa<triton::ReduceOp>(op) &&
+         !op->getResultTypes()[0].isa<RankedTensorType>();
+}
+
+static bool isDistributedTensor(Value value) {
+  auto tensorType = value.getType().dyn_cast<RankedTensorType>();
+  return tensorType && tensorType.getEncoding() &&
+         triton::gpu::isaDistributedLayout(tensorType.getEncoding());
+}
+
+void LayoutPropagation::initAnchorLayout() {
+  funcOp.walk([&](Operation *op) {
+    if (!isLayoutAnchor(op))
+      return;
+    for (Value result : op->getResults()) {
+      if (!isDistributedTensor(result))
+        continue;
+      auto encoding = result.getType().cast<RankedTensorType>().getEncoding();
+      layouts.insert({result, LayoutInfo(encoding)});
+    }
+  });
+}
+
+void LayoutPropagation::setEncoding(ValueRange values, LayoutInfo &info,
+                                    SmallVector<Value> &changed,
+                                    Operation *op) {
+  for (Value value : values) {
+    if (!isDistributedTensor(value))
+      continue;
+    bool hasChanged = false;
+    for (Attribute encoding : info.encodings) {
+      Attribute dstEncoding;
+      if (failed(inferDstEncoding(encoding, op, dstEncoding)))
+        continue;
+      hasChanged |= layouts[value].encodings.insert(dstEncoding);
+    }
+    if (hasChanged)
+      changed.push_back(value);
+  }
+}
+
+SmallVector<Value> LayoutPropagation::propagateToUsers(Value value,
+                                                       LayoutInfo &info) {
+  SmallVector<Value> changed;
+  for (OpOperand &use : value.getUses()) {
+    Operation *user = use.getOwner();
+    if (auto forOp = dyn_cast<scf::ForOp>(user)) {
+      if (use.getOperandNumber() < forOp.getNumControlOperands())
+        continue;
+      Value arg = forOp.getRegionIterArgForOpOperand(use);
+      Value result = forOp.getResultForOpOperand(use);
+      setEncoding({arg, result}, info, changed, user);
+      continue;
+    }
+    if (auto yieldOp = dyn_cast<scf::YieldOp>(user)) {
+      Operation *parent = yieldOp->getParentOp();
+      SmallVector<Value> valuesToPropagate;
+      if (isa<scf::ForOp, scf::IfOp>(parent))
+        valuesToPropagate.push_back(parent->getResult(use.getOperandNumber()));
+      if (auto forOp = dyn_cast<scf::ForOp>(parent))
+        valuesToPropagate.push_back(
+            forOp.getRegionIterArgs()[use.getOperandNumber()]);
+      setEncoding(valuesToPropagate, info, changed, user);
+      continue;
+    }
+    // Anchors keep their own layout.
+    if (isLayoutAnchor(user))
+      continue;
+    if (canPropagateThrough(user))
+      setEncoding(user->getResults(), info, changed, user);
+  }
+  return changed;
+}
+
+void LayoutPropagation::propagateLayout() {
+  SmallVector<Value> queue;
+  for (auto &it : layouts)
+    queue.push_back(it.first);
+  while (!queue.empty()) {
+    Value currentValue = queue.pop_back_val();
+    // Copy the info as the map may grow while propagating.
+    LayoutInfo info = layouts[currentValue];
+    SmallVector<Value> changed = propagateToUsers(currentValue, info);
+    queue.append(changed.begin(), changed.end());
+  }
+}
+
+// Estimate the number of conversions needed around `value` if it is assigned
+// `encoding`: one for each operand of its defining op that would have to be
+// converted and one for each user that expects another encoding.
+int64_t LayoutPropagation::getConflictCost(Value value, Attribute encoding) {
+  auto hasEncoding = [&](Value v, Attribute enc) {
+    auto it = layouts.find(v);
+    if (it == layouts.end())
+      return v.getType().cast<RankedTensorType>().getEncoding() == enc;
+    return it->second.encodings.contains(enc);
+  };
+  int64_t cost = 0;
+  Operation *def = value.getDefiningOp();
+  if (def && canPropagateThrough(def)) {
+    Attribute srcEncoding;
+    if (failed(invertEncoding(encoding, def, srcEncoding)))
+      return INT_MAX;
+    for (Value operand : def->getOperands())
+      if (isDistributedTensor(operand) && !hasEncoding(operand, srcEncoding))
+        cost += 1;
+  }
+  for (OpOperand &use : value.getUses()) {
+    Operation *user = use.getOwner();
+    Attribute dstEncoding;
+    if (isa<scf::ForOp, scf::YieldOp>(user) || isLayoutAnchor(user) ||
+        !canPropagateThrough(user) ||
+        failed(inferDstEncoding(encoding, user, dstEncoding))) {
+      // The user keeps the encoding it was created with.
+      if (value.getType().cast<RankedTensorType>().getEncoding() != encoding)
+        cost += 1;
+      continue;
+    }
+    for (Value result : user->getResults())
+      if (isDistributedTensor(result) && !hasEncoding(result, dstEncoding))
+        cost += 1;
+  }
+  // Values are weighted by the number of elements each thread holds.
+  auto tensorType = value.getType().cast<RankedTensorType>();
+  return cost * triton::gpu::getTotalElemsPerThread(
+                    encoding, tensorType.getShape(),
+                    tensorType.getElementType());
+}
+
+void LayoutPropagation::resolveConflicts() {
+  for (auto &it : layouts) {
+    Value value = it.first;
+    LayoutInfo &info = it.second;
+    if (info.encodings.size() <= 1)
+      continue;
+    Operation *op = value.getDefiningOp();
+    bool isLoadOrStore =
+        op && isa<triton::LoadOp, triton::StoreOp, triton::AtomicRMWOp,
+                  triton::AtomicCASOp>(op);
+    // Ties are broken in favor of blocked layouts for memory operations (to
+    // preserve coalescing) and mma layouts otherwise, then in the order the
+    // encodings were discovered.
+    auto preferred = [&](Attribute e) {
+      return isLoadOrStore ? e.isa<triton::gpu::BlockedEncodingAttr>()
+                           : e.isa<triton::gpu::MmaEncodingAttr>();
+    };
+    Attribute encoding;
+    int64_t bestCost = INT64_MAX;
+    for (Attribute e : info.encodings) {
+      int64_t cost = getConflictCost(value, e);
+      if (cost < bestCost ||
+          (cost == bestCost && preferred(e) && !preferred(encoding))) {
+        bestCost = cost;
+        encoding = e;
+      }
+    }
+    info.encodings.clear();
+    info.encodings.insert(encoding);
+  }
+}
+
+void LayoutPropagation::map(Value oldV, Value newV) {
+  rewriteMapping[{oldV,
+                  newV.getType().cast<RankedTensorType>().getEncoding()}] =
+      newV;
+}
+
+Value LayoutPropagation::getValueAs(Value value, Attribute encoding) {
+  auto tensorType = value.getType().dyn_cast<RankedTensorType>();
+  if (!tensorType)
+    return value;
+  Value rewrittenValue = value;
+  auto layoutIt = layouts.find(value);
+  if (layoutIt != layouts.end()) {
+    Attribute encodingPicked = layoutIt->second.encodings.front();
+    if (encodingPicked != tensorType.getEncoding())
+      rewrittenValue = rewriteMapping.lookup({value, encodingPicked});
+  }
+  assert(rewrittenValue && "value used before being rewritten");
+  if (rewrittenValue.getType().cast<RankedTensorType>().getEncoding() ==
+      encoding)
+    return rewrittenValue;
+  Value &converted = convertMapping[{rewrittenValue, encoding}];
+  if (converted)
+    return converted;
+  OpBuilder rewriter(value.getContext());
+  rewriter.setInsertionPointAfterValue(rewrittenValue);
+  auto tmpType = RankedTensorType::get(tensorType.getShape(),
+                                       tensorType.getElementType(), encoding);
+  converted = rewriter.create<triton::gpu::ConvertLayoutOp>(
+      value.getLoc(), tmpType, rewrittenValue);
+  return converted;
+}
+
+Operation *LayoutPropagation::cloneElementwise(OpBuilder &rewriter,
+                                               Operation *op,
+                                               Attribute encoding) {
+  Attribute srcEncoding;
+  LogicalResult inverted = invertEncoding(encoding, op, srcEncoding);
+  assert(succeeded(inverted) && "propagated an encoding that can't be inverted");
+  (void)inverted;
+  Operation *newOp = rewriter.clone(*op);
+  for (OpOperand &operand : op->getOpOperands())
+    newOp->setOperand(operand.getOperandNumber(),
+                      getValueAs(operand.get(), srcEncoding));
+  for (unsigned i = 0, e = op->getNumResults(); i < e; ++i) {
+    auto origType = op->getResult(i).getType().dyn_cast<RankedTensorType>();
+    if (!origType)
+      continue;
+    auto newType = RankedTensorType::get(origType.getShape(),
+                                         origType.getElementType(), encoding);
+    newOp->getResult(i).setType(newType);
+  }
+  return newOp;
+}
+
+Operation *LayoutPropagation::rewriteForOp(scf::ForOp forOp) {
+  SmallVector<Value> operands;
+  OpBuilder rewriter(forOp);
+  for (auto [operand, result] :
+       llvm::zip(forOp.getInitArgs(), forOp.getResults())) {
+    Value convertedOperand = operand;
+    auto it = layouts.find(result);
+    if (it != layouts.end())
+      convertedOperand = getValueAs(operand, it->second.encodings.front());
+    operands.push_back(convertedOperand);
+  }
+  auto newForOp = rewriter.create<scf::ForOp>(
+      forOp.getLoc(), forOp.getLowerBound(), forOp.getUpperBound(),
+      forOp.getStep(), operands);
+  newForOp.getBody()->getOperations().splice(
+      newForOp.getBody()->getOperations().begin(),
+      forOp.getBody()->getOperations());
+
+  for (auto [oldResult, newResult] :
+       llvm::zip(forOp.getResults(), newForOp.getResults())) {
+    if (oldResult.getType() == newResult.getType()) {
+      oldResult.replaceAllUsesWith(newResult);
+      continue;
+    }
+    map(oldResult, newResult);
+  }
+  for (auto [oldArg, newArg] : llvm::zip(forOp.getBody()->getArguments(),
+                                         newForOp.getBody()->getArguments())) {
+    if (oldArg.getType() == newArg.getType()) {
+      oldArg.replaceAllUsesWith(newArg);
+      continue;
+    }
+    map(oldArg, newArg);
+  }
+  return newForOp.getOperation();
+}
+
+Operation *LayoutPropagation::rewriteIfOp(scf::IfOp ifOp) {
+  OpBuilder rewriter(ifOp);
+  SmallVector<Type> newResultTypes(ifOp->getResultTypes());
+  for (unsigned i = 0, e = ifOp->getNumResults(); i < e; ++i) {
+    auto it = layouts.find(ifOp->getResult(i));
+    if (it == layouts.end())
+      continue;
+    auto origType = ifOp->getResult(i).getType().cast<RankedTensorType>();
+    newResultTypes[i] =
+        RankedTensorType::get(origType.getShape(), origType.getElementType(),
+                              it->second.encodings.front());
+  }
+  bool hasElse = !ifOp.getElseRegion().empty();
+  auto newIfOp = rewriter.create<scf::IfOp>(ifOp.getLoc(), newResultTypes,
+                                            ifOp.getCondition(), hasElse);
+  newIfOp.getThenRegion().takeBody(ifOp.getThenRegion());
+  if (hasElse)
+    newIfOp.getElseRegion().takeBody(ifOp.getElseRegion());
+  for (auto [oldResult, newResult] :
+       llvm::zip(ifOp.getResults(), newIfOp.getResults())) {
+    if (oldResult.getType() == newResult.getType()) {
+      oldResult.replaceAllUsesWith(newResult);
+      continue;
+    }
+    map(oldResult, newResult);
+  }
+  return newIfOp.getOperation();
+}
+
+void LayoutPropagation::rewriteYieldOp(scf::YieldOp yieldOp) {
+  Operation *parentOp = yieldOp->getParentOp();
+  for (OpOperand &operand : yieldOp->getOpOperands()) {
+    Type yieldType = operand.get().getType();
+    if (isa<scf::ForOp, scf::IfOp>(parentOp))
+      yieldType = parentOp->getResult(operand.getOperandNumber()).getType();
+    auto tensorType = yieldType.dyn_cast<RankedTensorType>();
+    if (!tensorType)
+      continue;
+    Value newOperand = getValueAs(operand.get(), tensorType.getEncoding());
+    yieldOp->setOperand(operand.getOperandNumber(), newOperand);
+  }
+}
+
+void LayoutPropagation::rewriteReduceToScalar(Operation *reduceOp) {
+  // All the operands need to have the same encoding: pick the one assigned to
+  // the first operand that has been rewritten.
+  Attribute srcEncoding;
+  for (Value operand : reduceOp->getOperands()) {
+    auto it = layouts.find(operand);
+    if (it != layouts.end()) {
+      srcEncoding = it->second.encodings.front();
+      break;
+    }
+  }
+  if (!srcEncoding)
+    return;
+  for (OpOperand &operand : reduceOp->getOpOperands())
+    reduceOp->setOperand(operand.getOperandNumber(),
+                         getValueAs(operand.get(), srcEncoding));
+}
+
+Operation *LayoutPropagation::rewriteOp(Operation *op) {
+  opToDelete.push_back(op);
+  if (auto forOp = dyn_cast<scf::ForOp>(op))
+    return rewriteForOp(forOp);
+  if (auto ifOp = dyn_cast<scf::IfOp>(op))
+    return rewriteIfOp(ifOp);
+  OpBuilder rewriter(op);
+  Attribute encoding = layouts[op->getResult(0)].encodings.front();
+  if (auto convertOp = dyn_cast<triton::gpu::ConvertLayoutOp>(op)) {
+    Attribute srcEncoding =
+        convertOp.getOperand().getType().cast<RankedTensorType>().getEncoding();
+    auto it = layouts.find(convertOp.getOperand());
+    if (it != layouts.end())
+      srcEncoding = it->second.encodings.front();
+    Value src = getValueAs(convertOp.getOperand(), srcEncoding);
+    // The conversion became a no-op.
+    if (srcEncoding == encoding) {
+      map(op->getResult(0), src);
+      return op;
+    }
+    auto tensorType = op->getResult(0).getType().cast<RankedTensorType>();
+    auto newType = RankedTensorType::get(tensorType.getShape(),
+                                         tensorType.getElementType(), encoding);
+    auto cvt = rewriter.create<triton::gpu::ConvertLayoutOp>(op->getLoc(),
+                                                             newType, src);
+    map(op->getResult(0), cvt.getResult());
+    return cvt.getOperation();
+  }
+  assert(canPropagateThrough(op) && "unexpected op in layout rewrite");
+  Operation *newOp = cloneElementwise(rewriter, op, encoding);
+  for (auto [oldResult, newResult] :
+       llvm::zip(op->getResults(), newOp->getResults()))
+    map(oldResult, newResult);
+  return newOp;
+}
+
+void LayoutPropagation::rewriteRegion(Region &region) {
+  SmallVector<Region *> queue = {&region};
+  while (!queue.empty()) {
+    Region *currentRegion = queue.pop_back_val();
+    for (Operation &op : currentRegion->getOps()) {
+      bool needRewrite = false;
+      for (Value result : op.getResults()) {
+        auto it = layouts.find(result);
+        if (it == layouts.end())
+          continue;
+        assert(it->second.encodings.size() == 1 &&
+               "conflicts should have been resolved");
+        auto encoding = result.getType().cast<RankedTensorType>().getEncoding();
+        if (encoding != it->second.encodings.front())
+          needRewrite = true;
+      }
+      if (needRewrite) {
+        Operation *newOp = rewriteOp(&op);
+        for (Region &R : newOp->getRegions())
+          queue.push_back(&R);
+      } else if (auto yieldOp = dyn_cast<scf::YieldOp>(&op)) {
+        rewriteYieldOp(yieldOp);
+      } else if (reduceToScalar(&op)) {
+        rewriteReduceToScalar(&op);
+      } else {
+        // The op keeps its layout but its operands may have been rewritten.
+        for (OpOperand &operand : op.getOpOperands()) {
+          if (!layouts.count(operand.get()))
+            continue;
+          Attribute encoding =
+              operand.get().getType().cast<RankedTensorType>().getEncoding();
+          op.setOperand(operand.getOperandNumber(),
+                        getValueAs(operand.get(), encoding));
+        }
+        for (Region &R : op.getRegions())
+          queue.push_back(&R);
+      }
+    }
+  }
+  for (Operation *op : llvm::reverse(opToDelete))
+    op->erase();
+  opToDelete.clear();
+}
+
+void LayoutPropagation::rewrite() { rewriteRegion(funcOp->getRegion(0)); }
+
 } // namespace
 
 #define GEN_PASS_CLASSES
@@ -595,24 +1105,66 @@ public:
     MLIRContext *context = &getContext();
     ModuleOp m = getOperation();
 
+    numConvertsBefore = countConversions(m);
+
+    if (globalLayoutAssignment) {
+      m.walk([](triton::FuncOp funcOp) {
+        LayoutPropagation layoutPropagation(funcOp);
+        layoutPropagation.initAnchorLayout();
+        layoutPropagation.propagateLayout();
+        layoutPropagation.resolveConflicts();
+        layoutPropagation.rewrite();
+      });
+    }
+
+    // Shared by the rematerialization patterns. It is invalidated by the
+    // rewriter whenever the IR changes, and by the patterns themselves after
+    // the in-place moves the rewriter does not see.
+    RematerializationCache cache;
     mlir::RewritePatternSet patterns(context);
 
     patterns.add<SimplifyConversion>(context);
     patterns.add<SimplifyReduceCvt>(context);
-    patterns.add<RematerializeBackward>(context);
-    patterns.add<RematerializeForward>(context);
-    patterns.add<MoveConvertOutOfLoop>(context);
-    patterns.add<MoveConvertOutOfIf>(context);
+    patterns.add<RematerializeBackward>(context, &cache);
+    // Forward propagation subsumes these patterns; with it the remaining ones
+    // only clean up what is left.
+    if (!globalLayoutAssignment) {
+      patterns.add<RematerializeForward>(context, &cache);
+      patterns.add<MoveConvertOutOfLoop>(context, &cache);
+      patterns.add<MoveConvertOutOfIf>(context);
+    }
     patterns.add<DecomposeDotOperand>(context);
     patterns.add<ConvertDotConvert>(context);
 
-    if (mlir::applyPatternsAndFoldGreedily(m, std::move(patterns)).failed()) {
+    GreedyRewriteConfig config;
+    config.listener = &cache;
+    if (mlir::applyPatternsAndFoldGreedily(m, std::move(patterns), config)
+            .failed()) {
       signalPassFailure();
     }
+    numRematCacheHits = cache.getNumHits();
+    numRematCacheMisses = cache.getNumMisses();
 
     if (fixupLoops(m).failed()) {
       signalPassFailure();
     }
+
+    numConvertsAfter = countConversions(m);
+  }
+
+private:
+  // Number of conversions between distributed layouts, i.e. the ones going
+  // through shared memory scratch that this pass tries to remove.
+  static unsigned countConversions(ModuleOp m) {
+    unsigned count = 0;
+    m.walk([&](triton::gpu::ConvertLayoutOp cvt) {
+      auto srcType = cvt.getOperand().getType().cast<RankedTensorType>();
+      auto dstType = cvt.getType().cast<RankedTensorType>();
+      if (triton::gpu::isaDistributedLayout(srcType.getEncoding()) &&
+          triton::gpu::isaDistributedLayout(dstType.getEncoding()))
+        ++count;
+    });
+    return count;
   }
 };
 
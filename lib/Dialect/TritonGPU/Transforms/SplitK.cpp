@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+// This pass splits the K loop of a matmul kernel across programs.
+//
+// For example, with split-k=2:
+// scf.for %iv = %lb to %ub step %step
+//     iter_args(%acc = %c, %a_ptr = %a, %b_ptr = %b) {
+//   %d = tt.dot %a_tile, %b_tile, %acc
+//   %a_next = tt.addptr %a_ptr, %a_step
+//   ...
+// }
+// tt.store %c_ptr, %loop#0
+//
+// will be translated to
+//
+// %split = tt.get_program_id z
+// %iters = ceildiv(ceildiv(%ub - %lb, %step), 2)
+// %first = %split * %iters
+// %lb_split = %lb + %first * %step
+// %ub_split = min(%ub, %lb_split + %iters * %step)
+// %a_split = tt.addptr %a, %a_step * %first
+// %c_split = %split == 0 ? %c : 0
+// scf.for %iv = %lb_split to %ub_split step %step
+//     iter_args(%acc = %c_split, %a_ptr = %a_split, %b_ptr = %b_split) {
+//   ...
+// }
+// tt.atomic_rmw fadd, %c_ptr, %loop#0
+//
+// The output must be zero-filled before the launch, and the grid launched with
+// `triton_gpu.split-k` programs along z.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+class SplitKPass : public TritonGPUSplitKBase<SplitKPass> {
+public:
+  SplitKPass() = default;
+  SplitKPass(int splitK) { this->splitK = splitK; }
+
+  LogicalResult splitLoop(scf::ForOp forOp);
+
+  void runOnOperation() override {
+    if (splitK <= 1)
+      return;
+    ModuleOp m = getOperation();
+    bool changed = false;
+    m.walk([&](triton::FuncOp funcOp) {
+      // The split index takes the z axis of the grid
+      bool usesAxisZ = false;
+      funcOp.walk([&](triton::GetProgramIdOp op) {
+        if (op.getAxis() == triton::ProgramIDDim::Z)
+          usesAxisZ = true;
+      });
+      if (usesAxisZ)
+        return;
+      for (auto forOp : funcOp.getBody().getOps<scf::ForOp>())
+        if (succeeded(splitLoop(forOp))) {
+          changed = true;
+          break;
+        }
+    });
+    if (changed)
+      m->setAttr("triton_gpu.split-k",
+                 IntegerAttr::get(IntegerType::get(m.getContext(), 32),
+                                  splitK));
+  }
+};
+
+LogicalResult SplitKPass::splitLoop(scf::ForOp forOp) {
+  auto yieldOp = cast<scf::YieldOp>(forOp.getBody()->getTerminator());
+  Type ivTy = forOp.getInductionVar().getType();
+  if (!ivTy.isIndex() && !ivTy.isInteger(32))
+    return failure();
+
+  // The accumulator is only used by the dot it comes back from
+  std::optional<unsigned> accIdx;
+  for (auto arg : llvm::enumerate(forOp.getRegionIterArgs())) {
+    auto dot = yieldOp.getOperand(arg.index()).getDefiningOp<triton::DotOp>();
+    if (!dot || dot.getC() != arg.value() || !arg.value().hasOneUse())
+      continue;
+    if (accIdx)
+      return failure();
+    accIdx = arg.index();
+  }
+  if (!accIdx)
+    return failure();
+
+  // Partial accumulators can only be combined if the result is stored as is
+  Value stored = forOp.getResult(*accIdx);
+  while (stored.hasOneUse()) {
+    auto cvt = dyn_cast<triton::gpu::ConvertLayoutOp>(*stored.user_begin());
+    if (!cvt)
+      break;
+    stored = cvt.getResult();
+  }
+  if (!stored.hasOneUse())
+    return failure();
+  auto storeOp = dyn_cast<triton::StoreOp>(*stored.user_begin());
+  if (!storeOp || storeOp.getValue() != stored ||
+      !storeOp.getPtr().getType().isa<RankedTensorType>())
+    return failure();
+  // tt.atomic_rmw has no cache modifier nor eviction policy to carry over
+  if (storeOp.getCache() != triton::CacheModifier::NONE ||
+      storeOp.getEvict() != triton::EvictionPolicy::NORMAL)
+    return failure();
+  Type elementTy = getElementTypeOrSelf(stored.getType());
+  if (!elementTy.isF32() && !elementTy.isF16())
+    return failure();
+
+  // Every other loop-carried value must advance by a loop-invariant step so
+  // that its value at the first iteration of a split can be computed
+  SmallVector<std::pair<unsigned, Operation *>> advances;
+  for (auto arg : llvm::enumerate(forOp.getRegionIterArgs())) {
+    if (arg.index() == *accIdx)
+      continue;
+    Operation *def = yieldOp.getOperand(arg.index()).getDefiningOp();
+    if (!def || !isa<triton::AddPtrOp, arith::AddIOp>(def) ||
+        def->getOperand(0) != arg.value() ||
+        !forOp.isDefinedOutsideOfLoop(def->getOperand(1)) ||
+        !forOp.getResult(arg.index()).use_empty())
+      return failure();
+    advances.push_back({arg.index(), def});
+  }
+
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  Type i32Ty = builder.getI32Type();
+  auto castTo = [&](Value v, Type ty) -> Value {
+    if (v.getType() == ty)
+      return v;
+    return builder.create<arith::IndexCastOp>(loc, ty, v);
+  };
+
+  Value split = builder.create<triton::GetProgramIdOp>(loc, i32Ty,
+                                                       triton::ProgramIDDim::Z);
+  Value factor = builder.create<arith::ConstantOp>(
+      loc, builder.getIntegerAttr(ivTy, splitK));
+  Value lb = forOp.getLowerBound();
+  Value ub = forOp.getUpperBound();
+  Value step = forOp.getStep();
+  Value numIters = builder.create<arith::CeilDivSIOp>(
+      loc, builder.create<arith::SubIOp>(loc, ub, lb), step);
+  Value itersPerSplit =
+      builder.create<arith::CeilDivSIOp>(loc, numIters, factor);
+  Value firstIter = builder.create<arith::MulIOp>(loc, castTo(split, ivTy),
+                                                  itersPerSplit);
+  Value newLb = builder.create<arith::AddIOp>(
+      loc, lb, builder.create<arith::MulIOp>(loc, firstIter, step));
+  Value newUb = builder.create<arith::MinSIOp>(
+      loc, ub,
+      builder.create<arith::AddIOp>(
+          loc, newLb, builder.create<arith::MulIOp>(loc, itersPerSplit, step)));
+  forOp.setLowerBound(newLb);
+  forOp.setUpperBound(newUb);
+
+  // Start the loop-carried values at the first iteration of the split
+  Value firstIterI32 = castTo(firstIter, i32Ty);
+  for (auto [idx, def] : advances) {
+    OpOperand &init = forOp.getIterOpOperands()[idx];
+    Value delta = def->getOperand(1);
+    Type deltaElementTy = getElementTypeOrSelf(delta.getType());
+    Value k = firstIterI32;
+    if (deltaElementTy != i32Ty)
+      k = builder.create<arith::ExtSIOp>(loc, deltaElementTy, k);
+    if (delta.getType().isa<RankedTensorType>())
+      k = builder.create<triton::SplatOp>(loc, delta.getType(), k);
+    Value offset = builder.create<arith::MulIOp>(loc, delta, k);
+    Value newInit;
+    if (isa<triton::AddPtrOp>(def))
+      newInit = builder.create<triton::AddPtrOp>(loc, init.get().getType(),
+                                                 init.get(), offset);
+    else
+      newInit = builder.create<arith::AddIOp>(loc, init.get(), offset);
+    init.set(newInit);
+  }
+
+  // Only the first split starts from the original accumulator
+  OpOperand &accInit = forOp.getIterOpOperands()[*accIdx];
+  auto accTy = accInit.get().getType().cast<RankedTensorType>();
+  Value zero =
+      builder.create<arith::ConstantOp>(loc, accTy, builder.getZeroAttr(accTy));
+  Value isFirstSplit = builder.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::eq, split,
+      builder.create<arith::ConstantIntOp>(loc, 0, 32));
+  accInit.set(builder.create<arith::SelectOp>(loc, isFirstSplit,
+                                              accInit.get(), zero));
+
+  // Combine the partial accumulators
+  builder.setInsertionPoint(storeOp);
+  builder.create<triton::AtomicRMWOp>(
+      storeOp.getLoc(), stored.getType(), triton::RMWOp::FADD,
+      storeOp.getPtr(), stored, storeOp.getMask(),
+      triton::MemSemantic::RELAXED);
+  storeOp.erase();
+  return success();
+}
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::createTritonGPUSplitKPass(int splitK) {
+  return std::make_unique<SplitKPass>(splitK);
+}
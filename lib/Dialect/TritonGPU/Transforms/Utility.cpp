@@ -88,6 +88,27 @@ LogicalResult invertEncoding(Attribute targetEncoding, Operation *op,
   return success();
 }
 
+LogicalResult inferDstEncoding(Attribute srcEncoding, Operation *op,
+                               Attribute &ret) {
+  ret = srcEncoding;
+  if (auto expand_dims = dyn_cast<triton::ExpandDimsOp>(op)) {
+    auto sliceEncoding = srcEncoding.dyn_cast<triton::gpu::SliceEncodingAttr>();
+    if (!sliceEncoding)
+      return failure();
+    if (sliceEncoding.getDim() != expand_dims.getAxis())
+      return failure();
+    ret = sliceEncoding.getParent();
+  }
+  if (auto reduce = dyn_cast<triton::ReduceOp>(op)) {
+    ret = triton::gpu::SliceEncodingAttr::get(op->getContext(),
+                                              reduce.getAxis(), srcEncoding);
+  }
+  if (isa<triton::ViewOp, triton::CatOp>(op)) {
+    return failure();
+  }
+  return success();
+}
+
 bool isExpensiveLoadOrStore(Operation *op, Attribute &targetEncoding) {
   // Case 1: A size 1 tensor is not expensive since all threads will load the
   // same
@@ -134,10 +155,71 @@ bool canFoldConversion(Operation *op, Attribute &targetEncoding) {
              triton::MakeRangeOp, triton::SplatOp, triton::ViewOp>(op);
 }
 
-int simulateBackwardRematerialization(
+bool RematerializationCache::isExpensiveToRemat(Operation *op,
+                                                Attribute targetEncoding) {
+  auto it = expensiveToRemat.find({op, targetEncoding});
+  if (it != expensiveToRemat.end()) {
+    ++numHits;
+    return it->second;
+  }
+  ++numMisses;
+  bool ret = mlir::isExpensiveToRemat(op, targetEncoding);
+  expensiveToRemat[{op, targetEncoding}] = ret;
+  return ret;
+}
+
+LogicalResult RematerializationCache::invertEncoding(Attribute targetEncoding,
+                                                     Operation *op,
+                                                     Attribute &ret) {
+  auto it = invertedEncodings.find({op, targetEncoding});
+  if (it != invertedEncodings.end()) {
+    ++numHits;
+    ret = it->second;
+    return success(ret != nullptr);
+  }
+  ++numMisses;
+  if (failed(mlir::invertEncoding(targetEncoding, op, ret)))
+    ret = Attribute();
+  invertedEncodings[{op, targetEncoding}] = ret;
+  return success(ret != nullptr);
+}
+
+const RematerializationCache::Simulation *
+RematerializationCache::lookupSimulation(Operation *initOp,
+                                         Attribute targetEncoding) {
+  auto it = simulations.find({initOp, targetEncoding});
+  if (it == simulations.end()) {
+    ++numMisses;
+    return nullptr;
+  }
+  ++numHits;
+  return &it->second;
+}
+
+void RematerializationCache::insertSimulation(Operation *initOp,
+                                              Attribute targetEncoding,
+                                              Simulation simulation) {
+  simulations[{initOp, targetEncoding}] = std::move(simulation);
+}
+
+void RematerializationCache::clear() {
+  expensiveToRemat.clear();
+  invertedEncodings.clear();
+  simulations.clear();
+}
+
+static int simulateBackwardRematerializationImpl(
     Operation *initOp, SetVector<Operation *> &processed,
     SetVector<Attribute> &layout, llvm::MapVector<Value, Attribute> &toConvert,
-    Attribute targetEncoding) {
+    Attribute targetEncoding, RematerializationCache *cache) {
+  auto isExpensive = [&](Operation *op, Attribute encoding) {
+    return cache ? cache->isExpensiveToRemat(op, encoding)
+                 : isExpensiveToRemat(op, encoding);
+  };
+  auto invert = [&](Attribute encoding, Operation *op, Attribute &ret) {
+    return cache ? cache->invertEncoding(encoding, op, ret)
+                 : invertEncoding(encoding, op, ret);
+  };
   // DFS
   std::vector<std::pair<Operation *, Attribute>> queue;
   queue.emplace_back(initOp, targetEncoding);
@@ -151,7 +233,7 @@ int simulateBackwardRematerialization(
     queue.pop_back();
     // If the current operation is expensive to rematerialize,
     // we stop everything
-    if (isExpensiveToRemat(currOp, currLayout))
+    if (isExpensive(currOp, currLayout))
       break;
     // A conversion will be removed here (i.e. transferred to operands)
     numCvts -= 1;
@@ -163,7 +245,7 @@ int simulateBackwardRematerialization(
       Attribute newEncoding;
       // Cannot invert the current encoding for this operand
       // we stop everything
-      if (failed(invertEncoding(currLayout, currOp, newEncoding)))
+      if (failed(invert(currLayout, currOp, newEncoding)))
         return INT_MAX;
       if (toConvert.count(argI) && toConvert[argI] != newEncoding)
         return INT_MAX;
@@ -191,6 +273,29 @@ int simulateBackwardRematerialization(
   return numCvts;
 }
 
+int simulateBackwardRematerialization(
+    Operation *initOp, SetVector<Operation *> &processed,
+    SetVector<Attribute> &layout, llvm::MapVector<Value, Attribute> &toConvert,
+    Attribute targetEncoding, RematerializationCache *cache) {
+  // Only simulations that start from scratch can be memoized as a whole.
+  bool memoize =
+      cache && processed.empty() && layout.empty() && toConvert.empty();
+  if (memoize) {
+    if (auto *simulation = cache->lookupSimulation(initOp, targetEncoding)) {
+      processed = simulation->processed;
+      layout = simulation->layout;
+      toConvert = simulation->toConvert;
+      return simulation->numCvts;
+    }
+  }
+  int numCvts = simulateBackwardRematerializationImpl(
+      initOp, processed, layout, toConvert, targetEncoding, cache);
+  if (memoize)
+    cache->insertSimulation(initOp, targetEncoding,
+                            {numCvts, processed, layout, toConvert});
+  return numCvts;
+}
+
 //
 
 Operation *cloneWithInferType(mlir::OpBuilder &rewriter, Operation *op,
@@ -275,8 +380,24 @@ void rematerializeConversionChain(
   }
 }
 
+int getSharedMemoryCapacity(int computeCapability) {
+  // Opt-in limits of dynamic shared memory per block.
+  if (computeCapability >= 90)
+    return 227 * 1024;
+  if (computeCapability == 86 || computeCapability == 89)
+    return 99 * 1024;
+  if (computeCapability >= 80)
+    return 163 * 1024;
+  if (computeCapability >= 75)
+    return 64 * 1024;
+  if (computeCapability >= 70)
+    return 96 * 1024;
+  return 48 * 1024;
+}
+
 LogicalResult canMoveOutOfLoop(BlockArgument arg,
-                               SmallVector<Operation *> &cvts) {
+                               SmallVector<Operation *> &cvts,
+                               RematerializationCache *cache) {
   auto parentOp = arg.getOwner()->getParentOp();
   // Don't move if arg is defined in a while loop
   if (isa<scf::WhileOp>(parentOp))
@@ -344,7 +465,8 @@ LogicalResult canMoveOutOfLoop(BlockArgument arg,
         auto argOp = operand.getDefiningOp();
         if (argOp && !isa<triton::gpu::ConvertLayoutOp>(argOp) &&
             simulateBackwardRematerialization(argOp, processed, layout,
-                                              toConvert, targetEncoding) > 0)
+                                              toConvert, targetEncoding,
+                                              cache) > 0)
           return failure();
       }
     }
@@ -344,7 +344,9 @@ translateTritonGPUToLLVMIR(llvm::LLVMContext *llvmContext,
 
   pm.addPass(mlir::createConvertSCFToCFPass());
   pm.addPass(mlir::createConvertIndexToLLVMPass());
-  pm.addPass(createConvertTritonGPUToLLVMPass(computeCapability, isROCM));
+  pm.addPass(createConvertTritonGPUToLLVMPass(
+      computeCapability, isROCM,
+      ::triton::tools::getBoolEnv("TRITON_NATIVE_FP8")));
   pm.addPass(mlir::createArithToLLVMConversionPass());
   pm.addPass(mlir::createCanonicalizerPass());
   // Simplify the IR
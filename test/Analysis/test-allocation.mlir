@@ -3,6 +3,8 @@
 #AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
 #sliceAd0 = #triton_gpu.slice<{dim = 0, parent = #AL}>
 #BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#sliceBd0 = #triton_gpu.slice<{dim = 0, parent = #BL}>
+#CL = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [8, 4], warpsPerCTA = [1, 4], order = [1, 0]}>
 #A_SHARED = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
 #A_SHARED_T = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [0, 1]}>
 #B_SHARED = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
@@ -164,15 +166,15 @@ tt.func @multi_color(%A : !tt.ptr<f16>) {
   %cst_0 = arith.constant dense<0.000000e+00> : tensor<4x4xf16, #A_SHARED>
   // CHECK-NEXT: offset = 1248, size = 128
   %cst_1 = arith.constant dense<0.000000e+00> : tensor<16x4xf16, #A_SHARED>
-  %cst_2 = arith.constant dense<0.000000e+00> : tensor<16x32xf16, #AL>
+  %cst_2 = arith.constant dense<0.000000e+00> : tensor<16x32xf16, #CL>
   // CHECK-NEXT: scratch offset = 64, size = 1152
-  %0 = triton_gpu.convert_layout %cst_2 : (tensor<16x32xf16, #AL>) -> tensor<16x32xf16, #AL>
+  %0 = triton_gpu.convert_layout %cst_2 : (tensor<16x32xf16, #CL>) -> tensor<16x32xf16, #AL>
   %1 = triton_gpu.convert_layout %cst : (tensor<4x8xf16, #A_SHARED>) -> tensor<4x8xf16, #AL>
   // CHECK-NEXT: offset = 0, size = 128
   %cst_3 = arith.constant dense<0.000000e+00> : tensor<4x16xf16, #A_SHARED>
   %2 = triton_gpu.convert_layout %cst_0 : (tensor<4x4xf16, #A_SHARED>) -> tensor<4x4xf16, #AL>
   // CHECK-NEXT: scratch offset = 0, size = 1152
-  %3 = triton_gpu.convert_layout %cst_2 : (tensor<16x32xf16, #AL>) -> tensor<16x32xf16, #AL>
+  %3 = triton_gpu.convert_layout %cst_2 : (tensor<16x32xf16, #CL>) -> tensor<16x32xf16, #AL>
   // CHECK-NEXT: offset = 0, size = 256
   %cst_4 = arith.constant dense<0.000000e+00> : tensor<4x32xf16, #A_SHARED>
   // CHECK-NEXT: offset = 256, size = 64
@@ -193,7 +195,7 @@ tt.func @multi_color(%A : !tt.ptr<f16>) {
   %7 = triton_gpu.convert_layout %cst_1 : (tensor<16x4xf16, #A_SHARED>) -> tensor<16x4xf16, #AL>
   %8 = triton_gpu.convert_layout %cst_4 : (tensor<4x32xf16, #A_SHARED>) -> tensor<4x32xf16, #AL>
   // CHECK-NEXT: scratch offset = 0, size = 1152
-  %9 = triton_gpu.convert_layout %cst_2 : (tensor<16x32xf16, #AL>) -> tensor<16x32xf16, #AL>
+  %9 = triton_gpu.convert_layout %cst_2 : (tensor<16x32xf16, #CL>) -> tensor<16x32xf16, #AL>
   %cst_11 = arith.constant dense<0.000000e+00> : tensor<4x4xf16, #AL>
   %10 = triton_gpu.convert_layout %cst_7 : (tensor<2x32xf16, #A_SHARED>) -> tensor<2x32xf16, #AL>
   %cst_12 = arith.constant dense<0.000000e+00> : tensor<4x16xf16, #AL>
@@ -226,6 +228,40 @@ tt.func @scratch() {
   // CHECK-NEXT: size = 512
 }
 
+// One partial result per warp along the axis for each of the 32 columns
+// CHECK-LABEL: scan_scratch
+tt.func @scan_scratch() {
+  %cst0 = arith.constant dense<0.000000e+00> : tensor<16x32xf16, #AL>
+  // CHECK: scratch offset = 0, size = 256
+  %b = "tt.scan" (%cst0) <{axis = 0 : i32, reverse = true}> ({
+  ^bb0(%arg0: f16, %arg1: f16):
+    %add = arith.addf %arg0, %arg1 : f16
+    tt.scan.return %add : f16
+  }) : (tensor<16x32xf16, #AL>) -> tensor<16x32xf16, #AL>
+  tt.return
+  // CHECK-NEXT: size = 256
+}
+
+// Conversions within a warp are done with shuffles and need no scratch buffer
+// CHECK-LABEL: cvt_within_warp
+tt.func @cvt_within_warp() {
+  %cst = arith.constant dense<0.000000e+00> : tensor<32xf16, #sliceAd0>
+  %0 = triton_gpu.convert_layout %cst : (tensor<32xf16, #sliceAd0>) -> tensor<32xf16, #sliceBd0>
+  tt.return
+  // CHECK-NEXT: size = 0
+}
+
+// The scratch buffer is swizzled instead of padded when it causes no more
+// bank conflicts
+// CHECK-LABEL: cvt_swizzled
+tt.func @cvt_swizzled() {
+  %cst = arith.constant dense<0.000000e+00> : tensor<16x32xf16, #BL>
+  // CHECK: scratch offset = 0, size = 1024
+  %0 = triton_gpu.convert_layout %cst : (tensor<16x32xf16, #BL>) -> tensor<16x32xf16, #AL>
+  tt.return
+  // CHECK-NEXT: size = 1024
+}
+
 // CHECK-LABEL: trans
 tt.func @trans(%A : !tt.ptr<f16>) {
   // CHECK: offset = 0, size = 1024
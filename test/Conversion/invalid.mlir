@@ -39,3 +39,16 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
     tt.return
   }
 }
+
+// -----
+
+tt.func @exclusive_scan(%v: tensor<32xf32>) {
+  // expected-error@+1 {{exclusive scan needs a combine region with a neutral element}}
+  %a = "tt.scan"(%v) <{axis = 0 : i32, exclusive = true}>({
+  ^bb0(%arg0: f32, %arg1: f32):
+    %add = arith.addf %arg0, %arg1 : f32
+    %mul = arith.mulf %add, %add : f32
+    tt.scan.return %mul : f32
+  }) : (tensor<32xf32>) -> tensor<32xf32>
+  tt.return
+}
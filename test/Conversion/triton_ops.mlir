@@ -203,3 +203,18 @@ tt.func @scan_op(%ptr: tensor<1x2x4x!tt.ptr<f32>>, %v : tensor<1x2x4xf32>) {
   tt.return
 
 }
+
+// CHECK-LABEL: reverse_exclusive_scan_op
+tt.func @reverse_exclusive_scan_op(%ptr: tensor<1x2x4x!tt.ptr<f32>>, %v : tensor<1x2x4xf32>) {
+  // CHECK: tt.scan
+  // CHECK-SAME: axis = 2
+  // CHECK-SAME: exclusive = true
+  // CHECK-SAME: reverse = true
+  %a = "tt.scan"(%v) <{axis = 2 : i32, reverse = true, exclusive = true}>({
+  ^bb0(%arg0: f32, %arg1: f32):
+    %add = arith.addf %arg0, %arg1 : f32
+    tt.scan.return %add : f32
+  }) : (tensor<1x2x4xf32>) -> tensor<1x2x4xf32>
+  tt.store %ptr, %a : tensor<1x2x4xf32>
+  tt.return
+}
@@ -1,4 +1,8 @@
 // RUN: triton-opt %s -split-input-file --convert-triton-gpu-to-llvm | FileCheck %s
+// RUN: triton-opt %s -split-input-file --convert-triton-gpu-to-llvm -mlir-pass-statistics -o /dev/null 2>&1 | FileCheck %s --check-prefix=STATS
+
+// STATS-DAG: (S) {{[1-9][0-9]*}} num-index-cache-hits
+// STATS-DAG: (S) {{[1-9][0-9]*}} num-index-cache-misses
 
 module attributes {"triton_gpu.num-warps" = 4 : i32} {
   // CHECK: llvm.func @test_empty_kernel(%arg0: i64, %arg1: !llvm.ptr<f16, 1>)
@@ -85,10 +89,14 @@ module attributes {"triton_gpu.num-warps" = 4 : i32} {
 module attributes {"triton_gpu.num-warps" = 4 : i32} {
   // CHECK-LABEL: store_with_cache_attr
   tt.func @store_with_cache_attr(%a_ptr_init : tensor<256x!tt.ptr<f32>, #blocked0>, %cst : tensor<256xi1, #blocked0>, %cst_0 : tensor<256xf32, #blocked0>) {
+    //      CHECK: %[[POLICY:.*]] = llvm.inline_asm
+    // CHECK-SAME: createpolicy.fractional.L2::evict_last.b64 $0, 1.0;
     //      CHECK: llvm.inline_asm
-    // CHECK-SAME: st.global.L1::evict_last.b32
+    // CHECK-SAME: st.global.L1::evict_last.L2::cache_hint.b32
+    // CHECK-SAME: %[[POLICY]]
     //      CHECK: llvm.inline_asm
-    // CHECK-SAME: st.global.L1::evict_last.b32
+    // CHECK-SAME: st.global.L1::evict_last.L2::cache_hint.b32
+    // CHECK-SAME: %[[POLICY]]
     tt.store %a_ptr_init, %cst_0, %cst {cache = 1 : i32, evict = 3 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
     tt.return
   }
@@ -96,6 +104,45 @@ module attributes {"triton_gpu.num-warps" = 4 : i32} {
 
 // -----
 
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: store_with_cache_operator
+  tt.func @store_with_cache_operator(%a_ptr_init : tensor<256x!tt.ptr<f32>, #blocked0>, %cst_0 : tensor<256xf32, #blocked0>) {
+    // CHECK-NOT: createpolicy
+    //     CHECK: st.global.wt.b32
+    tt.store %a_ptr_init, %cst_0 {cache = 6 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
+    // The cache operator takes the place of the L1 eviction priority.
+    //     CHECK: createpolicy.fractional.L2::evict_first.b64
+    //     CHECK: st.global.cs.L2::cache_hint.b32
+    tt.store %a_ptr_init, %cst_0 {cache = 5 : i32, evict = 2 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: load_with_cache_attr
+  tt.func @load_with_cache_attr(%a_ptr_init : tensor<256x!tt.ptr<f32>, #blocked0>) {
+    //      CHECK: %[[POLICY:.*]] = llvm.inline_asm
+    // CHECK-SAME: createpolicy.fractional.L2::evict_last.b64 $0, 1.0;
+    //      CHECK: llvm.inline_asm
+    // CHECK-SAME: ld.global.L1::evict_last.L2::cache_hint.b32
+    // CHECK-SAME: %[[POLICY]]
+    %0 = tt.load %a_ptr_init {cache = 1 : i32, evict = 3 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
+    //      CHECK: createpolicy.fractional.L2::evict_first.b64
+    //      CHECK: ld.global.cs.L2::cache_hint.b32
+    %1 = tt.load %a_ptr_init {cache = 5 : i32, evict = 2 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
+    //  CHECK-NOT: createpolicy
+    //      CHECK: ld.volatile.global.b32
+    %2 = tt.load %a_ptr_init {cache = 3 : i32, evict = 3 : i32, isVolatile = true} : tensor<256xf32, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [2], order = [0]}>
 module attributes {"triton_gpu.num-warps" = 2 : i32} {
   // CHECK-LABEL: global_load_store_no_vec
@@ -115,21 +162,21 @@ module attributes {"triton_gpu.num-warps" = 2 : i32} {
     // CHECK: mov.u32 $0, 0x0
     // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 0 ];
     // CHECK: mov.u32 $0, 0x0
-    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 256 ];
     // CHECK: mov.u32 $0, 0x0
-    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 512 ];
     // CHECK: mov.u32 $0, 0x0
-    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 768 ];
 
     // Load 4 elements from vector1
     // CHECK: mov.u32 $0, 0x0
     // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 0 ];
     // CHECK: mov.u32 $0, 0x0
-    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 256 ];
     // CHECK: mov.u32 $0, 0x0
-    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 512 ];
     // CHECK: mov.u32 $0, 0x0
-    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.b32 { ${{.*}} }, [ ${{.*}} + 768 ];
     %9 = tt.load %6 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
     %10 = tt.load %8 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
     %11 = arith.addf %9, %10 : tensor<256xf32, #blocked0>
@@ -138,9 +185,9 @@ module attributes {"triton_gpu.num-warps" = 2 : i32} {
 
     // Store 4 elements to global
     // CHECK: @${{.*}} st.global.b32 [ ${{.*}} + 0 ], { ${{.*}} };
-    // CHECK: @${{.*}} st.global.b32 [ ${{.*}} + 0 ], { ${{.*}} };
-    // CHECK: @${{.*}} st.global.b32 [ ${{.*}} + 0 ], { ${{.*}} };
-    // CHECK: @${{.*}} st.global.b32 [ ${{.*}} + 0 ], { ${{.*}} };
+    // CHECK: @${{.*}} st.global.b32 [ ${{.*}} + 256 ], { ${{.*}} };
+    // CHECK: @${{.*}} st.global.b32 [ ${{.*}} + 512 ], { ${{.*}} };
+    // CHECK: @${{.*}} st.global.b32 [ ${{.*}} + 768 ], { ${{.*}} };
     tt.store %13, %11 : tensor<256xf32, #blocked0>
     tt.return
   }
@@ -232,15 +279,15 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
 
     // Load 8 elements from A with four vectorized load instruction
     // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
-    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
-    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
-    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 8 ];
+    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 16 ];
+    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 24 ];
 
     // Load 8 elements from B with four vectorized load instruction
     // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
-    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
-    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
-    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 8 ];
+    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 16 ];
+    // CHECK: @${{.*}} ld.global.v2.b32 { ${{.*}}, ${{.*}} }, [ ${{.*}} + 24 ];
 
     %9 = tt.load %6 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
     %10 = tt.load %8 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
@@ -250,9 +297,9 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
 
     // Store 8 elements to global with four vectorized store instruction
     // CHECK: @${{.*}} st.global.v2.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}} };
-    // CHECK: @${{.*}} st.global.v2.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}} };
-    // CHECK: @${{.*}} st.global.v2.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}} };
-    // CHECK: @${{.*}} st.global.v2.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}} };
+    // CHECK: @${{.*}} st.global.v2.b32 [ ${{.*}} + 8 ], { ${{.*}}, ${{.*}} };
+    // CHECK: @${{.*}} st.global.v2.b32 [ ${{.*}} + 16 ], { ${{.*}}, ${{.*}} };
+    // CHECK: @${{.*}} st.global.v2.b32 [ ${{.*}} + 24 ], { ${{.*}}, ${{.*}} };
     tt.store %13, %11 : tensor<256xf32, #blocked0>
     tt.return
   }
@@ -277,11 +324,11 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
 
     // Load 8 elements from A with two vectorized load instruction
     // CHECK: @${{.*}} ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
-    // CHECK: @${{.*}} ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 16 ];
 
     // Load 8 elements from B with two vectorized load instruction
     // CHECK: @${{.*}} ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
-    // CHECK: @${{.*}} ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: @${{.*}} ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 16 ];
 
     %9 = tt.load %6 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
     %10 = tt.load %8 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked0>
@@ -291,14 +338,87 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
 
     // Store 8 elements to global with two vectorized store instruction
     // CHECK: @$5 st.global.v4.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} };
-    // CHECK: @$5 st.global.v4.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} };
+    // CHECK: @$5 st.global.v4.b32 [ ${{.*}} + 16 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} };
     tt.store %13, %11 : tensor<256xf32, #blocked0>
     tt.return
   }
 }
 
-// TODO: Add a testcase to verify the optimization when ptr of the LoadOp
-//       is from an addptr with const idx
+// -----
+
+// Vectors of a row are addressed from the first one, rows are at a runtime
+// stride from each other and keep their own address.
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [1, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: global_load_store_immediate_offset
+  tt.func @global_load_store_immediate_offset(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %stride: i32 {tt.divisibility = 16 : i32}) {
+    %0 = tt.make_range {end = 16 : i32, start = 0 : i32} : tensor<16xi32, #triton_gpu.slice<{dim = 1, parent = #blocked0}>>
+    %1 = tt.expand_dims %0 {axis = 1 : i32} : (tensor<16xi32, #triton_gpu.slice<{dim = 1, parent = #blocked0}>>) -> tensor<16x1xi32, #blocked0>
+    %2 = tt.splat %stride : (i32) -> tensor<16x1xi32, #blocked0>
+    %3 = arith.muli %1, %2 : tensor<16x1xi32, #blocked0>
+    %4 = tt.broadcast %3 : (tensor<16x1xi32, #blocked0>) -> tensor<16x32xi32, #blocked0>
+    %5 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked0}>>
+    %6 = tt.expand_dims %5 {axis = 0 : i32} : (tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked0}>>) -> tensor<1x32xi32, #blocked0>
+    %7 = tt.broadcast %6 : (tensor<1x32xi32, #blocked0>) -> tensor<16x32xi32, #blocked0>
+    %8 = arith.addi %4, %7 : tensor<16x32xi32, #blocked0>
+    %9 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<16x32x!tt.ptr<f32>, #blocked0>
+    %10 = tt.addptr %9, %8 : tensor<16x32x!tt.ptr<f32>, #blocked0>, tensor<16x32xi32, #blocked0>
+    // CHECK: ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 64 ];
+    // CHECK: ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 64 ];
+    %11 = tt.load %10 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x32xf32, #blocked0>
+    %12 = tt.splat %arg1 : (!tt.ptr<f32>) -> tensor<16x32x!tt.ptr<f32>, #blocked0>
+    %13 = tt.addptr %12, %8 : tensor<16x32x!tt.ptr<f32>, #blocked0>, tensor<16x32xi32, #blocked0>
+    // CHECK: st.global.v4.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} };
+    // CHECK: st.global.v4.b32 [ ${{.*}} + 64 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} };
+    // CHECK: st.global.v4.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} };
+    // CHECK: st.global.v4.b32 [ ${{.*}} + 64 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} };
+    tt.store %13, %11 : tensor<16x32xf32, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+
+// A pointer carried by a loop and advanced by a uniform amount keeps the
+// immediate offsets of its initial value.
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [1, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: global_load_immediate_offset_loop
+  tt.func @global_load_immediate_offset_loop(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %stride: i32 {tt.divisibility = 16 : i32}, %n: i32) {
+    %c0 = arith.constant 0 : i32
+    %c1 = arith.constant 1 : i32
+    %step = arith.constant dense<32> : tensor<16x32xi32, #blocked0>
+    %0 = tt.make_range {end = 16 : i32, start = 0 : i32} : tensor<16xi32, #triton_gpu.slice<{dim = 1, parent = #blocked0}>>
+    %1 = tt.expand_dims %0 {axis = 1 : i32} : (tensor<16xi32, #triton_gpu.slice<{dim = 1, parent = #blocked0}>>) -> tensor<16x1xi32, #blocked0>
+    %2 = tt.splat %stride : (i32) -> tensor<16x1xi32, #blocked0>
+    %3 = arith.muli %1, %2 : tensor<16x1xi32, #blocked0>
+    %4 = tt.broadcast %3 : (tensor<16x1xi32, #blocked0>) -> tensor<16x32xi32, #blocked0>
+    %5 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked0}>>
+    %6 = tt.expand_dims %5 {axis = 0 : i32} : (tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked0}>>) -> tensor<1x32xi32, #blocked0>
+    %7 = tt.broadcast %6 : (tensor<1x32xi32, #blocked0>) -> tensor<16x32xi32, #blocked0>
+    %8 = arith.addi %4, %7 : tensor<16x32xi32, #blocked0>
+    %9 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<16x32x!tt.ptr<f32>, #blocked0>
+    %10 = tt.addptr %9, %8 : tensor<16x32x!tt.ptr<f32>, #blocked0>, tensor<16x32xi32, #blocked0>
+    cf.br ^bb1(%c0, %10 : i32, tensor<16x32x!tt.ptr<f32>, #blocked0>)
+  ^bb1(%i: i32, %ptr: tensor<16x32x!tt.ptr<f32>, #blocked0>):  // 2 preds: ^bb0, ^bb2
+    %cond = arith.cmpi slt, %i, %n : i32
+    cf.cond_br %cond, ^bb2, ^bb3
+  ^bb2:  // pred: ^bb1
+    // CHECK: ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 64 ];
+    // CHECK: ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 0 ];
+    // CHECK: ld.global.v4.b32 { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }, [ ${{.*}} + 64 ];
+    %11 = tt.load %ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x32xf32, #blocked0>
+    tt.store %ptr, %11 : tensor<16x32xf32, #blocked0>
+    %12 = tt.addptr %ptr, %step : tensor<16x32x!tt.ptr<f32>, #blocked0>, tensor<16x32xi32, #blocked0>
+    %13 = arith.addi %i, %c1 : i32
+    cf.br ^bb1(%13, %12 : i32, tensor<16x32x!tt.ptr<f32>, #blocked0>)
+  ^bb3:  // pred: ^bb1
+    tt.return
+  }
+}
 
 // -----
 
@@ -536,6 +656,80 @@ module attributes {"triton_gpu.num-warps" = 4 : i32} {
 
 // -----
 
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 4, perPhase = 1, maxPhase = 1, order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: insert_slice_async_zero_other
+  tt.func @insert_slice_async_zero_other(%a_ptr: tensor<16x32x!tt.ptr<f32>, #AL> {tt.divisibility = 16 : i32, tt.contiguity = 4 : i32}, %mask: tensor<16x32xi1, #AL> {tt.constancy = 4 : i32}) {
+    %tensor = triton_gpu.alloc_tensor : tensor<2x16x32xf32, #A>
+    %index = arith.constant 1 : i32
+    %other = arith.constant dense<0.000000e+00> : tensor<16x32xf32, #AL>
+    // Masked-off elements are zero-filled by cp.async itself.
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: cp.async.cg.shared.global [ ${{.*}} + 0 ], [ ${{.*}} + 0 ], 0x10, $
+    // CHECK-NOT: st.shared
+    %a = triton_gpu.insert_slice_async %a_ptr, %tensor, %index, %mask, %other {axis = 0 : i32, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x32x!tt.ptr<f32>, #AL> -> tensor<2x16x32xf32, #A>
+    triton_gpu.async_commit_group
+    tt.return
+  }
+}
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 4, perPhase = 1, maxPhase = 1, order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: insert_slice_async_other
+  tt.func @insert_slice_async_other(%a_ptr: tensor<16x32x!tt.ptr<f32>, #AL> {tt.divisibility = 16 : i32, tt.contiguity = 4 : i32}, %mask: tensor<16x32xi1, #AL> {tt.constancy = 4 : i32}) {
+    %tensor = triton_gpu.alloc_tensor : tensor<2x16x32xf32, #A>
+    %index = arith.constant 1 : i32
+    %other = arith.constant dense<1.000000e+00> : tensor<16x32xf32, #AL>
+    // The copy of masked-off words is skipped and `other` is stored instead.
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: @${{[0-9]+}} cp.async.cg.shared.global [ ${{.*}} + 0 ], [ ${{.*}} + 0 ], 0x10, 0x10
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: @!${{[0-9]+}} st.shared.v4.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: @${{[0-9]+}} cp.async.cg.shared.global
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: @!${{[0-9]+}} st.shared.v4.b32
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: cp.async.commit_group
+    %a = triton_gpu.insert_slice_async %a_ptr, %tensor, %index, %mask, %other {axis = 0 : i32, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x32x!tt.ptr<f32>, #AL> -> tensor<2x16x32xf32, #A>
+    triton_gpu.async_commit_group
+    tt.return
+  }
+}
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 4, perPhase = 1, maxPhase = 1, order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: insert_slice_async_neg_zero_other
+  tt.func @insert_slice_async_neg_zero_other(%a_ptr: tensor<16x32x!tt.ptr<f32>, #AL> {tt.divisibility = 16 : i32, tt.contiguity = 4 : i32}, %mask: tensor<16x32xi1, #AL> {tt.constancy = 4 : i32}) {
+    %tensor = triton_gpu.alloc_tensor : tensor<2x16x32xf32, #A>
+    %index = arith.constant 1 : i32
+    %other = arith.constant dense<-0.000000e+00> : tensor<16x32xf32, #AL>
+    // -0.0 is not the zero cp.async fills in, so it is stored explicitly.
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: @${{[0-9]+}} cp.async.cg.shared.global [ ${{.*}} + 0 ], [ ${{.*}} + 0 ], 0x10, 0x10
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: @!${{[0-9]+}} st.shared.v4.b32 [ ${{.*}} + 0 ], { ${{.*}}, ${{.*}}, ${{.*}}, ${{.*}} }
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: @${{[0-9]+}} cp.async.cg.shared.global
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: @!${{[0-9]+}} st.shared.v4.b32
+    // CHECK: llvm.inline_asm
+    // CHECK-SAME: cp.async.commit_group
+    %a = triton_gpu.insert_slice_async %a_ptr, %tensor, %index, %mask, %other {axis = 0 : i32, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x32x!tt.ptr<f32>, #AL> -> tensor<2x16x32xf32, #A>
+    triton_gpu.async_commit_group
+    tt.return
+  }
+}
+
+// -----
+
 #block0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [4], warpsPerCTA = [4], order = [0]}>
 #block1 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [8], warpsPerCTA = [4], order = [0]}>
 #block2 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [4, 1], warpsPerCTA = [4, 1], order = [1, 0]}>
@@ -721,16 +915,9 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
   // CHECK: llvm.mlir.global external @global_smem() {addr_space = 3 : i32} : !llvm.array<0 x i8>
   // CHECK-LABEL: convert_layout_blocked_blocked_vec
   tt.func @convert_layout_blocked_blocked_vec(%arg0: tensor<16x16xf32, #blocked0>) {
-    // CHECK: llvm.mlir.addressof @global_smem
-    // CHECK: llvm.store
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
-    // CHECK: llvm.store
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
-    // CHECK: nvvm.barrier0
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK-NOT: llvm.mlir.addressof @global_smem
+    // CHECK-COUNT-16: shfl.sync.idx.b32
+    // CHECK-NOT: nvvm.barrier0
     %0 = triton_gpu.convert_layout %arg0 : (tensor<16x16xf32, #blocked0>) -> tensor<16x16xf32, #blocked1>
     tt.return
   }
@@ -744,23 +931,40 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
   // CHECK: llvm.mlir.global external @global_smem() {addr_space = 3 : i32} : !llvm.array<0 x i8>
   // CHECK-LABEL: convert_layout_blocked_blocked_multi_rep
   tt.func @convert_layout_blocked_blocked_multi_rep(%arg0: tensor<16x16xf32, #blocked0>) {
+    // CHECK-NOT: llvm.mlir.addressof @global_smem
+    // CHECK-COUNT-16: shfl.sync.idx.b32
+    // CHECK-NOT: nvvm.barrier0
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x16xf32, #blocked0>) -> tensor<16x16xf32, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: convert_layout_blocked_blocked_swizzled
+  tt.func @convert_layout_blocked_blocked_swizzled(%arg0: tensor<16x32xf16, #blocked0>) {
     // CHECK: llvm.mlir.addressof @global_smem
+    // CHECK: llvm.xor
     // CHECK: llvm.store
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
-    // CHECK: nvvm.barrier0
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
-    // CHECK: nvvm.barrier0
+    // CHECK-SAME: !llvm.ptr<vector<4xf16>, 3>
+    // CHECK: llvm.xor
     // CHECK: llvm.store
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK-SAME: !llvm.ptr<vector<4xf16>, 3>
+    // CHECK: llvm.xor
+    // CHECK: llvm.store
+    // CHECK-SAME: !llvm.ptr<vector<4xf16>, 3>
+    // CHECK: llvm.xor
+    // CHECK: llvm.store
+    // CHECK-SAME: !llvm.ptr<vector<4xf16>, 3>
     // CHECK: nvvm.barrier0
+    // CHECK: llvm.xor
     // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
-    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x16xf32, #blocked0>) -> tensor<16x16xf32, #blocked1>
+    // CHECK-SAME: !llvm.ptr<vector<4xf16>, 3>
+    // CHECK-NOT: llvm.load
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x32xf16, #blocked0>) -> tensor<16x32xf16, #blocked1>
     tt.return
   }
 }
@@ -826,6 +1030,23 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
 
 // -----
 
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [4, 8], warpsPerCTA = [1, 1], order = [1, 0]}>
+#mma = #triton_gpu.mma<{versionMajor = 2, warpsPerCTA = [1, 1]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: convert_layout_mmav2_blocked_shuffle
+  tt.func @convert_layout_mmav2_blocked_shuffle(%arg0: tensor<16x8xf32, #mma>) {
+    // CHECK-NOT: llvm.mlir.addressof @global_smem
+    // CHECK: shfl.sync.idx.b32
+    // CHECK: llvm.select
+    // CHECK-NOT: nvvm.barrier0
+    // CHECK: llvm.insertvalue
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x8xf32, #mma>) -> tensor<16x8xf32, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+
 #blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 16], warpsPerCTA = [1, 4], order = [1, 0]}>
 #mma = #triton_gpu.mma<{versionMajor = 1, versionMinor = 3, warpsPerCTA = [2, 2]}>
 module attributes {"triton_gpu.num-warps" = 1 : i32} {
@@ -871,7 +1092,8 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
 module attributes {"triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: convert_blocked1d_to_slice0
   tt.func @convert_blocked1d_to_slice0(%src:tensor<32xi32, #blocked0>) {
-    // CHECK-COUNT-4: llvm.load {{.*}} : !llvm.ptr<vector<1xi32>, 3>
+    // CHECK-COUNT-4: shfl.sync.idx.b32
+    // CHECK-NOT: llvm.load
     %cvt = triton_gpu.convert_layout %src : (tensor<32xi32, #blocked0>) -> tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked1}>>
     tt.return
   }
@@ -884,7 +1106,8 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
 module attributes {"triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: convert_blocked1d_to_slice1
   tt.func @convert_blocked1d_to_slice1(%src:tensor<32xi32, #blocked0>) {
-    // CHECK-COUNT-8: llvm.load {{.*}} : !llvm.ptr<vector<1xi32>, 3>
+    // CHECK-COUNT-8: shfl.sync.idx.b32
+    // CHECK-NOT: llvm.load
     %cvt = triton_gpu.convert_layout %src : (tensor<32xi32, #blocked0>) -> tensor<32xi32, #triton_gpu.slice<{dim = 1, parent = #blocked1}>>
     tt.return
   }
@@ -898,11 +1121,112 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: convert_blocked_to_blocked_ptr
   tt.func @convert_blocked_to_blocked_ptr(%src:tensor<32x!tt.ptr<f32>, #blocked0>) {
     // CHECK: llvm.ptrtoint
+    // CHECK: shfl.sync.idx.b32
+    // CHECK: llvm.inttoptr
+    // CHECK-NOT: nvvm.barrier0
+    // CHECK-COUNT-4: llvm.insertvalue
+    %cvt = triton_gpu.convert_layout %src : (tensor<32x!tt.ptr<f32>, #blocked0>) -> tensor<32x!tt.ptr<f32>, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+// Conversions whose elements cross warps still go through shared memory.
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [2, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [16, 2], warpsPerCTA = [1, 2], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 2 : i32} {
+  // CHECK-LABEL: convert_layout_blocked_blocked_vec_multi_warp
+  tt.func @convert_layout_blocked_blocked_vec_multi_warp(%arg0: tensor<16x16xf32, #blocked0>) {
+    // CHECK: llvm.mlir.addressof @global_smem
+    // CHECK-NOT: shfl.sync
+    // CHECK: llvm.store
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK: nvvm.barrier0
+    // CHECK: llvm.load
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x16xf32, #blocked0>) -> tensor<16x16xf32, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [2, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [2, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 2 : i32} {
+  // CHECK-LABEL: convert_layout_blocked_blocked_multi_rep_multi_warp
+  tt.func @convert_layout_blocked_blocked_multi_rep_multi_warp(%arg0: tensor<32x32xf32, #blocked0>) {
+    // CHECK: llvm.mlir.addressof @global_smem
+    // CHECK-NOT: shfl.sync
+    // CHECK: llvm.store
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK: llvm.store
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK: nvvm.barrier0
+    // CHECK: llvm.load
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK: llvm.load
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK: nvvm.barrier0
+    // CHECK: llvm.store
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK: llvm.store
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK: nvvm.barrier0
+    // CHECK: llvm.load
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    // CHECK: llvm.load
+    // CHECK-SAME: !llvm.ptr<vector<4xf32>, 3>
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<32x32xf32, #blocked0>) -> tensor<32x32xf32, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [2], order = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [2, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 2 : i32} {
+  // CHECK-LABEL: convert_blocked1d_to_slice0_multi_warp
+  tt.func @convert_blocked1d_to_slice0_multi_warp(%src:tensor<64xi32, #blocked0>) {
+    // CHECK-NOT: shfl.sync
+    // CHECK: nvvm.barrier0
+    // CHECK-COUNT-8: llvm.load {{.*}} : !llvm.ptr<vector<1xi32>, 3>
+    %cvt = triton_gpu.convert_layout %src : (tensor<64xi32, #blocked0>) -> tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked1}>>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [2], order = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [1, 2], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 2 : i32} {
+  // CHECK-LABEL: convert_blocked1d_to_slice1_multi_warp
+  tt.func @convert_blocked1d_to_slice1_multi_warp(%src:tensor<64xi32, #blocked0>) {
+    // CHECK-NOT: shfl.sync
+    // CHECK: nvvm.barrier0
+    // CHECK-COUNT-16: llvm.load {{.*}} : !llvm.ptr<vector<1xi32>, 3>
+    %cvt = triton_gpu.convert_layout %src : (tensor<64xi32, #blocked0>) -> tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked1}>>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [2], order = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [2], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 2 : i32} {
+  // CHECK-LABEL: convert_blocked_to_blocked_ptr_multi_warp
+  tt.func @convert_blocked_to_blocked_ptr_multi_warp(%src:tensor<64x!tt.ptr<f32>, #blocked0>) {
+    // CHECK: llvm.ptrtoint
+    // CHECK-NOT: shfl.sync
     // CHECK: llvm.store
     // CHECK: nvvm.barrier0
     // CHECK: llvm.inttoptr
     // CHECK-COUNT-4: llvm.insertvalue
-    %cvt = triton_gpu.convert_layout %src : (tensor<32x!tt.ptr<f32>, #blocked0>) -> tensor<32x!tt.ptr<f32>, #blocked1>
+    %cvt = triton_gpu.convert_layout %src : (tensor<64x!tt.ptr<f32>, #blocked0>) -> tensor<64x!tt.ptr<f32>, #blocked1>
     tt.return
   }
 }
@@ -1160,6 +1484,29 @@ module attributes {"triton_gpu.num-warps" = 1 : i32} {
   }
 }
 
+// -----
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [8, 4], warpsPerCTA = [8, 1], order = [1, 0]}>
+#shared0 = #triton_gpu.shared<{vec = 8, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // Each function materializes its own indices once.
+  // CHECK-LABEL: test_index_cache_first_func
+  tt.func @test_index_cache_first_func(%arg0: tensor<128x32xf32, #blocked0>) {
+    // CHECK: nvvm.read.ptx.sreg.tid.x
+    // CHECK-NOT: nvvm.read.ptx.sreg.tid.x
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<128x32xf32, #blocked0>) -> tensor<128x32xf32, #shared0>
+    %1 = triton_gpu.convert_layout %arg0 : (tensor<128x32xf32, #blocked0>) -> tensor<128x32xf32, #shared0>
+    tt.return
+  }
+  // CHECK-LABEL: test_index_cache_second_func
+  tt.func @test_index_cache_second_func(%arg0: tensor<128x32xf32, #blocked0>) {
+    // CHECK: nvvm.read.ptx.sreg.tid.x
+    // CHECK-NOT: nvvm.read.ptx.sreg.tid.x
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<128x32xf32, #blocked0>) -> tensor<128x32xf32, #shared0>
+    %1 = triton_gpu.convert_layout %arg0 : (tensor<128x32xf32, #blocked0>) -> tensor<128x32xf32, #shared0>
+    tt.return
+  }
+}
+
 // -----
 
 #mma = #triton_gpu.mma<{versionMajor=2, warpsPerCTA=[2, 2]}>
@@ -1223,3 +1570,182 @@ module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-war
     tt.return
   }
 }
+
+// -----
+
+// Both rows of f16 accumulators of a thread share each shuffle.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [1, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: reduce_packed_shuffles
+  tt.func @reduce_packed_shuffles(%arg0: tensor<2x32xf16, #blocked>) {
+    // CHECK-COUNT-5: shfl.sync.bfly.b32
+    // CHECK-NOT: shfl.sync
+    %0 = "tt.reduce"(%arg0) ({
+    ^bb0(%arg1: f16, %arg2: f16):
+      %1 = arith.addf %arg1, %arg2 : f16
+      tt.reduce.return %1 : f16
+    }) {axis = 1 : i32} : (tensor<2x32xf16, #blocked>) -> tensor<2xf16, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: reduce_redux_sync
+  tt.func @reduce_redux_sync(%arg0: tensor<32xi32, #blocked>) {
+    // CHECK: redux.sync.max.u32
+    // CHECK-NOT: shfl.sync
+    %0 = "tt.reduce"(%arg0) ({
+    ^bb0(%arg1: i32, %arg2: i32):
+      %1 = arith.maxui %arg1, %arg2 : i32
+      tt.reduce.return %1 : i32
+    }) {axis = 0 : i32} : (tensor<32xi32, #blocked>) -> i32
+    tt.return
+  }
+}
+
+// -----
+
+// The last elements of both rows share each shuffle of the warp scan, the
+// propagation to the other elements of the rows takes one more each.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [1, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: scan_packed_shuffles
+  tt.func @scan_packed_shuffles(%arg0: tensor<2x32xf16, #blocked>) {
+    // CHECK-COUNT-7: shfl.sync.up.b32
+    // CHECK-NOT: shfl.sync
+    %0 = "tt.scan"(%arg0) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f16, %arg2: f16):
+      %1 = arith.addf %arg1, %arg2 : f16
+      tt.scan.return %1 : f16
+    }) : (tensor<2x32xf16, #blocked>) -> tensor<2x32xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// The partial sums of the four warps are combined as a tree instead of one
+// after the other.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: scan_inter_warp
+  tt.func @scan_inter_warp(%arg0: tensor<128xf32, #blocked>) {
+    // CHECK: nvvm.barrier0
+    // CHECK: %[[P0:.*]] = llvm.load
+    // CHECK: %[[P1:.*]] = llvm.load
+    // CHECK: %[[P2:.*]] = llvm.load
+    // CHECK: %[[P3:.*]] = llvm.load
+    // CHECK: %[[P01:.*]] = llvm.fadd %[[P0]], %[[P1]]
+    // CHECK: %[[P23:.*]] = llvm.fadd %[[P2]], %[[P3]]
+    // CHECK: llvm.fadd %[[P01]], %[[P23]]
+    // CHECK: llvm.fadd %[[P01]], %[[P2]]
+    %0 = "tt.scan"(%arg0) <{axis = 0 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %1 = arith.addf %arg1, %arg2 : f32
+      tt.scan.return %1 : f32
+    }) : (tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// A reverse scan takes its values from the next lanes.
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: scan_reverse
+  tt.func @scan_reverse(%arg0: tensor<128xi32, #blocked>) {
+    // CHECK-COUNT-6: shfl.sync.down.b32
+    // CHECK-NOT: shfl.sync
+    %0 = "tt.scan"(%arg0) <{axis = 0 : i32, reverse = true}> ({
+    ^bb0(%arg1: i32, %arg2: i32):
+      %1 = arith.addi %arg1, %arg2 : i32
+      tt.scan.return %1 : i32
+    }) : (tensor<128xi32, #blocked>) -> tensor<128xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// The first element of an exclusive scan is the neutral element of the combine
+// region.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: scan_exclusive
+  tt.func @scan_exclusive(%arg0: tensor<32xf32, #blocked>) {
+    // CHECK: %[[ONE:.*]] = llvm.mlir.constant(1.000000e+00 : f32) : f32
+    // CHECK: llvm.select %{{.*}}, %[[ONE]], %{{.*}} : i1, f32
+    %0 = "tt.scan"(%arg0) <{axis = 0 : i32, exclusive = true}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %1 = arith.mulf %arg1, %arg2 : f32
+      tt.scan.return %1 : f32
+    }) : (tensor<32xf32, #blocked>) -> tensor<32xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// Pairs of contiguous f16 values are computed on f16x2 vectors.
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: packed_f16
+  tt.func @packed_f16(%arg0: tensor<64xf16, #blocked>, %arg1: tensor<64xf16, #blocked>) {
+    // CHECK: llvm.fadd %{{.*}}, %{{.*}} : vector<2xf16>
+    // CHECK-NOT: llvm.fadd
+    // CHECK: llvm.intr.maxnum{{.*}}vector<2xf16>
+    %0 = arith.addf %arg0, %arg1 : tensor<64xf16, #blocked>
+    %1 = arith.maxf %0, %arg1 : tensor<64xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: packed_bf16
+  tt.func @packed_bf16(%arg0: tensor<128xbf16, #blocked>, %arg1: tensor<128xbf16, #blocked>) {
+    // CHECK-COUNT-2: fma.rn.bf16x2 $0, $1, $2, c
+    // CHECK-COUNT-2: fma.rn.bf16x2 $0, $1, c, $2
+    // CHECK-NOT: fma.rn.bf16
+    %0 = arith.mulf %arg0, %arg1 : tensor<128xbf16, #blocked>
+    %1 = arith.addf %0, %arg1 : tensor<128xbf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// A single element per thread is computed alone.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: unpacked_f16
+  tt.func @unpacked_f16(%arg0: tensor<32xf16, #blocked>, %arg1: tensor<32xf16, #blocked>) {
+    // CHECK: llvm.fadd %{{.*}}, %{{.*}} : f16
+    // CHECK-NOT: vector<2xf16>
+    %0 = arith.addf %arg0, %arg1 : tensor<32xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+  // Stores and atomics read the thread id of their masks from the cache.
+  // CHECK-LABEL: test_index_cache_store_atomic
+  tt.func @test_index_cache_store_atomic(%arg0 : tensor<256x!tt.ptr<f32>, #blocked0>, %arg1 : tensor<256xi1, #blocked0>, %arg2 : tensor<256xf32, #blocked0>) {
+    // CHECK: nvvm.read.ptx.sreg.tid.x
+    // CHECK-NOT: nvvm.read.ptx.sreg.tid.x
+    // CHECK: llvm.return
+    tt.store %arg0, %arg2 : tensor<256xf32, #blocked0>
+    %0 = "tt.atomic_rmw" (%arg0, %arg2, %arg1) {atomic_rmw_op = 5 : i32, sem = 1 : i32} : (tensor<256x!tt.ptr<f32>, #blocked0>, tensor<256xf32, #blocked0>, tensor<256xi1, #blocked0>) -> tensor<256xf32, #blocked0>
+    tt.store %arg0, %0 : tensor<256xf32, #blocked0>
+    tt.return
+  }
+}
@@ -0,0 +1,117 @@
+// RUN: triton-opt %s -split-input-file --convert-triton-gpu-to-llvm | FileCheck %s
+// RUN: triton-opt %s -split-input-file --convert-triton-gpu-to-llvm="compute-capability=89" | FileCheck %s
+// RUN: triton-opt %s -split-input-file --convert-triton-gpu-to-llvm="compute-capability=89 native-fp8=true" | FileCheck %s --check-prefix=SM89
+
+// Without `native-fp8`, sm_89 lowers exactly like sm_80 (same CHECK prefix), so
+// both give the same bits on the encodings where the native E4M3FN conversions
+// differ: 0x7f/0xff (480 in software, NaN natively) and overflowing down-casts
+// (not saturated in software, clamped by `satfinite` natively).
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // Four FP32 values are converted by a single inline PTX, natively on sm_89+
+  // when requested.
+  // CHECK-LABEL: fp32_to_fp8
+  // CHECK: cvt.rn.f16.f32 f16_0, $1
+  // CHECK: prmt.b32
+  // CHECK-SAME: "=r,r,r,r,r" %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}} : (f32, f32, f32, f32) -> vector<4xi8>
+  // CHECK-NOT: llvm.inline_asm
+  // SM89-LABEL: fp32_to_fp8
+  // SM89: cvt.rn.satfinite.e4m3x2.f32 a0, $2, $1
+  // SM89-SAME: cvt.rn.satfinite.e4m3x2.f32 a1, $4, $3
+  // SM89-NOT: llvm.inline_asm
+  tt.func @fp32_to_fp8(%arg0: tensor<128xf32, #blocked>) {
+    %0 = tt.fp_to_fp %arg0 : tensor<128xf32, #blocked> -> tensor<128xf8E4M3FNUZ, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: fp8e4m3_to_fp32
+  // CHECK: prmt.b32
+  // CHECK-SAME: cvt.f32.f16 $3, f16_3
+  // CHECK-SAME: "=r,=r,=r,=r,r" %{{.*}} : (i32) -> !llvm.struct<(f32, f32, f32, f32)>
+  // CHECK-NOT: llvm.inline_asm
+  // SM89-LABEL: fp8e4m3_to_fp32
+  // SM89: cvt.rn.f16x2.e4m3x2 f16x2_0, a0
+  // SM89-SAME: cvt.f32.f16 $0, f16_0
+  // SM89-NOT: llvm.inline_asm
+  tt.func @fp8e4m3_to_fp32(%arg0: tensor<128xf8E4M3FNUZ, #blocked>) {
+    %0 = tt.fp_to_fp %arg0 : tensor<128xf8E4M3FNUZ, #blocked> -> tensor<128xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: fp8e5m2_fp32
+  // CHECK: prmt.b32 a0, 0, $4, 0x5140
+  // CHECK: and.b32 a0, f16x2_0, 0x7fff7fff
+  // SM89-LABEL: fp8e5m2_fp32
+  // SM89: cvt.rn.f16x2.e5m2x2 f16x2_0, a0
+  // SM89: cvt.rn.satfinite.e5m2x2.f32 a0, $2, $1
+  tt.func @fp8e5m2_fp32(%arg0: tensor<128xf8E5M2, #blocked>) {
+    %0 = tt.fp_to_fp %arg0 : tensor<128xf8E5M2, #blocked> -> tensor<128xf32, #blocked>
+    %1 = tt.fp_to_fp %0 : tensor<128xf32, #blocked> -> tensor<128xf8E5M2, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // FP8E4M3B15 has no native conversion.
+  // CHECK-LABEL: fp8e4m3b15_fp32
+  // CHECK: shl.b32 a0, $4, 1
+  // CHECK: shr.b32  a0, f16x2_0, 1
+  // SM89-LABEL: fp8e4m3b15_fp32
+  // SM89: shl.b32 a0, $4, 1
+  // SM89: shr.b32  a0, f16x2_0, 1
+  tt.func @fp8e4m3b15_fp32(%arg0: tensor<128xf8E4M3B11FNUZ, #blocked>) {
+    %0 = tt.fp_to_fp %arg0 : tensor<128xf8E4M3B11FNUZ, #blocked> -> tensor<128xf32, #blocked>
+    %1 = tt.fp_to_fp %0 : tensor<128xf32, #blocked> -> tensor<128xf8E4M3B11FNUZ, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // 0x7f/0xff go through the software decoding (to 480/-480) and f16 values
+  // above 480 are not clamped, unless `native-fp8` is set.
+  // CHECK-LABEL: fp8e4m3_fp16
+  // CHECK: prmt.b32 a0, 0, $2, 0x5040
+  // CHECK-NOT: cvt.rn.f16x2.e4m3x2
+  // CHECK-NOT: satfinite
+  // SM89-LABEL: fp8e4m3_fp16
+  // SM89: cvt.rn.f16x2.e4m3x2 $0, a0
+  // SM89: cvt.rn.satfinite.e4m3x2.f16x2 a0, $1
+  tt.func @fp8e4m3_fp16(%arg0: tensor<128xf8E4M3FNUZ, #blocked>) {
+    %0 = tt.fp_to_fp %arg0 : tensor<128xf8E4M3FNUZ, #blocked> -> tensor<128xf16, #blocked>
+    %1 = tt.fp_to_fp %0 : tensor<128xf16, #blocked> -> tensor<128xf8E4M3FNUZ, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// Two elements per thread: the group of four is padded and half of its results
+// dropped.
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: fp8_tail
+  // CHECK: %[[PAD:.*]] = llvm.mlir.undef : f32
+  // CHECK: llvm.inline_asm {{.*}} %{{.*}}, %{{.*}}, %[[PAD]], %[[PAD]] : (f32, f32, f32, f32) -> vector<4xi8>
+  // CHECK-NOT: llvm.inline_asm
+  tt.func @fp8_tail(%arg0: tensor<64xf32, #blocked>) {
+    %0 = tt.fp_to_fp %arg0 : tensor<64xf32, #blocked> -> tensor<64xf8E5M2, #blocked>
+    tt.return
+  }
+}
@@ -23,22 +23,22 @@ tt.func @test_combine_dot_add_pattern() -> (tensor<128x128xf32>, tensor<128x128x
 }
 
 
-// COM: CHECK-LABEL: @test_combine_addptr_pattern
+// CHECK-LABEL: @test_combine_addptr_pattern
 tt.func @test_combine_addptr_pattern(%base: !tt.ptr<f32>) -> tensor<8x!tt.ptr<f32>> {
     %off0 = arith.constant 10 : i32
     %off1 = arith.constant 15 : i32
 
     // 10 + 15 = 25
-    // COM: CHECK-NEXT: %[[cst:.*]] = arith.constant dense<25> : tensor<8xi32>
+    // CHECK-DAG: %[[cst:.*]] = arith.constant dense<25> : tensor<8xi32>
+    // CHECK-DAG: %[[tmp0:.*]] = tt.broadcast %{{.*}} : (!tt.ptr<f32>) -> tensor<8x!tt.ptr<f32>>
 
     %base_ = tt.broadcast %base : (!tt.ptr<f32>) -> tensor<8x!tt.ptr<f32>>
 
-    // COM: CHECK-NEXT: %[[tmp0:.*]] = tt.broadcast %{{.*}} : (!tt.ptr<f32>) -> tensor<8x!tt.ptr<f32>>
-
     %idx0 = tt.broadcast %off0 : (i32) -> tensor<8xi32>
     %idx1 = tt.broadcast %off1 : (i32) -> tensor<8xi32>
 
-    // COM: CHECK-NEXT: %1 = tt.addptr %[[tmp0]], %[[cst]] : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
+    // CHECK: %[[res:.*]] = tt.addptr %[[tmp0]], %[[cst]] : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
+    // CHECK-NEXT: tt.return %[[res]]
     %ptr0 = tt.addptr %base_, %idx0 : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
     %ptr1 = tt.addptr %ptr0, %idx1 : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
 
@@ -46,6 +46,30 @@ tt.func @test_combine_addptr_pattern(%base: !tt.ptr<f32>) -> tensor<8x!tt.ptr<f3
 }
 
 
+// CHECK-LABEL: @test_combine_addptr_reassociate_pattern
+tt.func @test_combine_addptr_reassociate_pattern(%base: tensor<8x!tt.ptr<f32>>, %idx: tensor<8xi32>, %idx64: tensor<8xi64>) -> (tensor<8x!tt.ptr<f32>>, tensor<8x!tt.ptr<f32>>) {
+    // CHECK-DAG: %[[cst4:.*]] = arith.constant dense<4> : tensor<8xi32>
+    // CHECK-DAG: %[[cst8:.*]] = arith.constant dense<8> : tensor<8xi32>
+    %cst4 = arith.constant dense<4> : tensor<8xi32>
+    %cst8 = arith.constant dense<8> : tensor<8xi32>
+
+    // The constant offset is moved outermost
+    // CHECK: %[[ptr0:.*]] = tt.addptr %{{.*}}, %{{.*}} : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
+    // CHECK-NEXT: %[[res0:.*]] = tt.addptr %[[ptr0]], %[[cst4]] : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
+    %ptr0 = tt.addptr %base, %cst4 : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
+    %res0 = tt.addptr %ptr0, %idx : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
+
+    // Offsets of different widths are reassociated but not added
+    // CHECK: %[[ptr1:.*]] = tt.addptr %{{.*}}, %{{.*}} : tensor<8x!tt.ptr<f32>>, tensor<8xi64>
+    // CHECK-NEXT: %[[res1:.*]] = tt.addptr %[[ptr1]], %[[cst8]] : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
+    %ptr1 = tt.addptr %base, %cst8 : tensor<8x!tt.ptr<f32>>, tensor<8xi32>
+    %res1 = tt.addptr %ptr1, %idx64 : tensor<8x!tt.ptr<f32>>, tensor<8xi64>
+
+    // CHECK-NEXT: tt.return %[[res0]], %[[res1]]
+    tt.return %res0, %res1 : tensor<8x!tt.ptr<f32>>, tensor<8x!tt.ptr<f32>>
+}
+
+
 // CHECK-LABEL: @test_combine_select_masked_load_pattern
 tt.func @test_combine_select_masked_load_pattern(%ptr: tensor<8x!tt.ptr<f32>>, %cond: i1) -> (tensor<8xf32>, tensor<8xf32>) {
     %mask = tt.broadcast %cond : (i1) -> tensor<8xi1>
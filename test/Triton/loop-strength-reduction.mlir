@@ -0,0 +1,107 @@
+// RUN: triton-opt %s -split-input-file -triton-loop-strength-reduction | FileCheck %s
+
+// a_ptrs = a + offs_m[:, None] * stride_am + (k + offs_k)[None, :]
+// b_ptrs = b + (k + offs_k)[:, None] * stride_bk + offs_n[None, :]
+// become pointers advanced by 32 and 32 * stride_bk.
+// CHECK-LABEL: tt.func @matmul_loop
+// CHECK-SAME: %[[A:[^:]*]]: !tt.ptr<f16>, %[[B:[^:]*]]: !tt.ptr<f16>, %[[UB:[^:]*]]: index, %[[STRIDE_AM:[^:]*]]: i32, %[[STRIDE_BK:[^:]*]]: i32
+// CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+// CHECK-DAG: %[[C32:.*]] = arith.constant 32 : index
+// CHECK: %[[RK:.*]] = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+// CHECK: %[[A_SPLAT:.*]] = tt.splat %[[A]]
+// CHECK: %[[AM:.*]] = tt.broadcast %{{.*}} : (tensor<128x1xi32>) -> tensor<128x32xi32>
+// CHECK: %[[B_SPLAT:.*]] = tt.splat %[[B]]
+// CHECK: %[[BN:.*]] = tt.broadcast %{{.*}} : (tensor<1x128xi32>) -> tensor<32x128xi32>
+// CHECK: %[[STRIDE_BK_SPLAT:.*]] = tt.splat %[[STRIDE_BK]] : (i32) -> tensor<32x1xi32>
+// Initial A pointers
+// CHECK: %[[K0:.*]] = arith.index_cast %[[C0]] : index to i32
+// CHECK: %[[K0_SPLAT:.*]] = tt.splat %[[K0]] : (i32) -> tensor<32xi32>
+// CHECK: %[[OFFS_K0:.*]] = arith.addi %[[K0_SPLAT]], %[[RK]]
+// CHECK: %[[AK0:.*]] = tt.expand_dims %[[OFFS_K0]] {axis = 0 : i32}
+// CHECK: %[[AK0_B:.*]] = tt.broadcast %[[AK0]]
+// CHECK: %[[A_OFF0:.*]] = arith.addi %[[AM]], %[[AK0_B]]
+// CHECK: %[[A_INIT:.*]] = tt.addptr %[[A_SPLAT]], %[[A_OFF0]]
+// A increment
+// CHECK: %[[DK:.*]] = arith.index_cast %[[C32]] : index to i32
+// CHECK: %[[DK_SPLAT:.*]] = tt.splat %[[DK]] : (i32) -> tensor<32xi32>
+// CHECK: %[[DAK:.*]] = tt.expand_dims %[[DK_SPLAT]] {axis = 0 : i32}
+// CHECK: %[[A_INC:.*]] = tt.broadcast %[[DAK]] : (tensor<1x32xi32>) -> tensor<128x32xi32>
+// Initial B pointers
+// CHECK: arith.index_cast %[[C0]] : index to i32
+// CHECK: %[[B_INIT:.*]] = tt.addptr %[[B_SPLAT]]
+// B increment
+// CHECK: %[[DK2:.*]] = arith.index_cast %[[C32]] : index to i32
+// CHECK: %[[DK2_SPLAT:.*]] = tt.splat %[[DK2]] : (i32) -> tensor<32xi32>
+// CHECK: %[[DBK:.*]] = tt.expand_dims %[[DK2_SPLAT]] {axis = 1 : i32}
+// CHECK: %[[DBK_SCALED:.*]] = arith.muli %[[DBK]], %[[STRIDE_BK_SPLAT]] : tensor<32x1xi32>
+// CHECK: %[[B_INC:.*]] = tt.broadcast %[[DBK_SCALED]] : (tensor<32x1xi32>) -> tensor<32x128xi32>
+// CHECK: scf.for %{{.*}} = %[[C0]] to %[[UB]] step %[[C32]] iter_args(%[[ACC:[^ ]+]] = %{{[^,]+}}, %[[A_PTRS:[^ ]+]] = %[[A_INIT]], %[[B_PTRS:[^ ]+]] = %[[B_INIT]])
+// CHECK-NEXT: %[[A_TILE:.*]] = tt.load %[[A_PTRS]]
+// CHECK-NEXT: %[[B_TILE:.*]] = tt.load %[[B_PTRS]]
+// CHECK-NEXT: %[[D:.*]] = tt.dot %[[A_TILE]], %[[B_TILE]], %[[ACC]]
+// CHECK-NEXT: %[[A_NEXT:.*]] = tt.addptr %[[A_PTRS]], %[[A_INC]]
+// CHECK-NEXT: %[[B_NEXT:.*]] = tt.addptr %[[B_PTRS]], %[[B_INC]]
+// CHECK-NEXT: scf.yield %[[D]], %[[A_NEXT]], %[[B_NEXT]]
+tt.func @matmul_loop(%a: !tt.ptr<f16>, %b: !tt.ptr<f16>, %ub: index, %stride_am: i32, %stride_bk: i32) -> tensor<128x128xf32> {
+  %c0 = arith.constant 0 : index
+  %c32 = arith.constant 32 : index
+  %zero = arith.constant dense<0.000000e+00> : tensor<128x128xf32>
+  %rm = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %rn = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %rk = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  %a_splat = tt.splat %a : (!tt.ptr<f16>) -> tensor<128x32x!tt.ptr<f16>>
+  %rm_2d = tt.expand_dims %rm {axis = 1 : i32} : (tensor<128xi32>) -> tensor<128x1xi32>
+  %stride_am_splat = tt.splat %stride_am : (i32) -> tensor<128x1xi32>
+  %am_1 = arith.muli %rm_2d, %stride_am_splat : tensor<128x1xi32>
+  %am = tt.broadcast %am_1 : (tensor<128x1xi32>) -> tensor<128x32xi32>
+  %b_splat = tt.splat %b : (!tt.ptr<f16>) -> tensor<32x128x!tt.ptr<f16>>
+  %rn_2d = tt.expand_dims %rn {axis = 0 : i32} : (tensor<128xi32>) -> tensor<1x128xi32>
+  %bn = tt.broadcast %rn_2d : (tensor<1x128xi32>) -> tensor<32x128xi32>
+  %stride_bk_splat = tt.splat %stride_bk : (i32) -> tensor<32x1xi32>
+  %res = scf.for %iv = %c0 to %ub step %c32 iter_args(%acc = %zero) -> (tensor<128x128xf32>) {
+    %k = arith.index_cast %iv : index to i32
+    %k_splat = tt.splat %k : (i32) -> tensor<32xi32>
+    %offs_k = arith.addi %k_splat, %rk : tensor<32xi32>
+    %ak = tt.expand_dims %offs_k {axis = 0 : i32} : (tensor<32xi32>) -> tensor<1x32xi32>
+    %ak_b = tt.broadcast %ak : (tensor<1x32xi32>) -> tensor<128x32xi32>
+    %a_off = arith.addi %am, %ak_b : tensor<128x32xi32>
+    %a_ptrs = tt.addptr %a_splat, %a_off : tensor<128x32x!tt.ptr<f16>>, tensor<128x32xi32>
+    %a_tile = tt.load %a_ptrs {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16>
+    %bk = tt.expand_dims %offs_k {axis = 1 : i32} : (tensor<32xi32>) -> tensor<32x1xi32>
+    %bk_1 = arith.muli %bk, %stride_bk_splat : tensor<32x1xi32>
+    %bk_b = tt.broadcast %bk_1 : (tensor<32x1xi32>) -> tensor<32x128xi32>
+    %b_off = arith.addi %bk_b, %bn : tensor<32x128xi32>
+    %b_ptrs = tt.addptr %b_splat, %b_off : tensor<32x128x!tt.ptr<f16>>, tensor<32x128xi32>
+    %b_tile = tt.load %b_ptrs {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf16>
+    %d = tt.dot %a_tile, %b_tile, %acc {allowTF32 = true} : tensor<128x32xf16> * tensor<32x128xf16> -> tensor<128x128xf32>
+    scf.yield %d : tensor<128x128xf32>
+  }
+  tt.return %res : tensor<128x128xf32>
+}
+
+// -----
+
+// Pointers that do not depend on the induction variable, or whose offset is
+// not affine in it, are left alone.
+// CHECK-LABEL: tt.func @not_affine
+// CHECK: scf.for %{{.*}} iter_args(%{{[^ ]+}} = %{{[^ ]+}}) -> (tensor<32xf32>)
+// CHECK: arith.muli %{{.*}}, %{{.*}} : tensor<32xi32>
+// CHECK: tt.addptr
+tt.func @not_affine(%a: !tt.ptr<f32>, %ub: index) -> tensor<32xf32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %zero = arith.constant dense<0.000000e+00> : tensor<32xf32>
+  %range = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  %a_splat = tt.splat %a : (!tt.ptr<f32>) -> tensor<32x!tt.ptr<f32>>
+  %res = scf.for %iv = %c0 to %ub step %c1 iter_args(%acc = %zero) -> (tensor<32xf32>) {
+    %k = arith.index_cast %iv : index to i32
+    %k_splat = tt.splat %k : (i32) -> tensor<32xi32>
+    %k2 = arith.muli %k_splat, %k_splat : tensor<32xi32>
+    %offs = arith.addi %k2, %range : tensor<32xi32>
+    %ptrs = tt.addptr %a_splat, %offs : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+    %x = tt.load %ptrs {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32xf32>
+    %sum = arith.addf %acc, %x : tensor<32xf32>
+    scf.yield %sum : tensor<32xf32>
+  }
+  tt.return %res : tensor<32xf32>
+}
@@ -33,6 +33,8 @@ tt.func public @matmul_kernel(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32},
   %20 = arith.extsi %arg6 : i32 to i64
   // CHECK-NOT: tt.make_tensor_ptr
   %21 = tt.make_tensor_ptr %arg0, [%18, %19], [%20, %c1_i64], [%16, %17] {order = array<i32: 1, 0>} : !tt.ptr<tensor<128x32xf16>>
+  // The offsets of the elements within the block are computed outside the loop
+  // CHECK: %[[OFFSETS:.*]] = arith.addi %{{.*}}, %{{.*}} : tensor<128x32xi64>
   %22 = arith.muli %15, %c32_i32 : i32
   %23 = arith.extsi %arg4 : i32 to i64
   %24 = arith.extsi %arg7 : i32 to i64
@@ -41,8 +43,21 @@ tt.func public @matmul_kernel(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32},
   %26 = arith.addi %arg5, %c31_i32 : i32
   %27 = arith.divsi %26, %c32_i32 : i32
   %28 = arith.index_cast %27 : i32 to index
+  // CHECK: scf.for
   %29:3 = scf.for %arg9 = %c0 to %28 step %c1 iter_args(%arg10 = %cst, %arg11 = %21, %arg12 = %25) -> (tensor<128x32xf32>, !tt.ptr<tensor<128x32xf16>>, !tt.ptr<tensor<32x32xf16>>) {
-    // CHECK: tt.load %{{.*}}, %{{.*}}, %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16>
+    // Only the address of the first element is computed in the loop
+    // CHECK-NOT: tt.make_range
+    // CHECK: tt.addptr %arg0, %{{.*}} : !tt.ptr<f16>, i64
+    // CHECK: %[[BASE:.*]] = tt.addptr %{{.*}}, %{{.*}} : !tt.ptr<f16>, i64
+    // CHECK: %[[SPLAT:.*]] = tt.splat %[[BASE]] : (!tt.ptr<f16>) -> tensor<128x32x!tt.ptr<f16>>
+    // CHECK: %[[PTR:.*]] = tt.addptr %[[SPLAT]], %[[OFFSETS]] : tensor<128x32x!tt.ptr<f16>>, tensor<128x32xi64>
+    // Only the checked dimension is masked, against scalar bounds
+    // CHECK-NOT: tt.make_range
+    // CHECK: arith.subi %{{.*}}, %{{.*}} : i64
+    // CHECK: tt.splat %{{.*}} : (i64) -> tensor<1x32xi64>
+    // CHECK: arith.cmpi slt, %{{.*}}, %{{.*}} : tensor<1x32xi64>
+    // CHECK-NOT: tensor<128x1xi1>
+    // CHECK: tt.load %[[PTR]], %{{.*}}, %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16>
     %55 = tt.load %arg11 {boundaryCheck = array<i32: 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 2 : i32} : !tt.ptr<tensor<128x32xf16>> -> tensor<128x32xf16>
     // CHECK: tt.load %{{.*}}, %{{.*}}, %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf16>
     %56 = tt.load %arg12 {boundaryCheck = array<i32: 0>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 2 : i32} : !tt.ptr<tensor<32x32xf16>> -> tensor<32x32xf16>
@@ -81,3 +96,17 @@ tt.func public @matmul_kernel(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32},
   tt.store %45, %30, %54 {cache = 1 : i32, evict = 1 : i32} : tensor<128x32xf16>
   tt.return
 }
+
+// Blocks that are statically in bounds are not masked, nor padded.
+// CHECK-LABEL: tt.func public @in_bounds
+// CHECK-NOT: arith.cmpi
+// CHECK: tt.load %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf16>
+tt.func public @in_bounds(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}) -> tensor<32x32xf16> {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i64 = arith.constant 1 : i64
+  %c64_i64 = arith.constant 64 : i64
+  %c32_i32 = arith.constant 32 : i32
+  %0 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c64_i64, %c1_i64], [%c32_i32, %c0_i32] {order = array<i32: 1, 0>} : !tt.ptr<tensor<32x32xf16>>
+  %1 = tt.load %0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x32xf16>> -> tensor<32x32xf16>
+  tt.return %1 : tensor<32x32xf16>
+}
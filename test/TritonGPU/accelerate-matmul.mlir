@@ -0,0 +1,81 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-accelerate-matmul=compute-capability=80 | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>
+
+// Square tiles read the least operand data from shared memory.
+// CHECK: #[[MMA:.*]] = #triton_gpu.mma<{versionMajor = 2, versionMinor = 0, warpsPerCTA = [2, 2]}>
+// CHECK-LABEL: tt.func @square
+// CHECK: tt.dot {{.*}} -> tensor<128x128xf32, #[[MMA]]>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @square(%a: tensor<128x32xf16, #A>, %b: tensor<32x128xf16, #B>) -> tensor<128x128xf32, #blocked> {
+  %zero = arith.constant dense<0.000000e+00> : tensor<128x128xf32, #blocked>
+  %d = tt.dot %a, %b, %zero {allowTF32 = true} : tensor<128x32xf16, #A> * tensor<32x128xf16, #B> -> tensor<128x128xf32, #blocked>
+  tt.return %d : tensor<128x128xf32, #blocked>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>
+
+// A single instruction tile along M: spreading warps along M would replicate it.
+// CHECK: #[[MMA:.*]] = #triton_gpu.mma<{versionMajor = 2, versionMinor = 0, warpsPerCTA = [1, 4]}>
+// CHECK-LABEL: tt.func @skinny
+// CHECK: tt.dot {{.*}} -> tensor<16x256xf32, #[[MMA]]>
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @skinny(%a: tensor<16x64xf16, #A>, %b: tensor<64x256xf16, #B>) -> tensor<16x256xf32, #blocked> {
+  %zero = arith.constant dense<0.000000e+00> : tensor<16x256xf32, #blocked>
+  %d = tt.dot %a, %b, %zero {allowTF32 = true} : tensor<16x64xf16, #A> * tensor<64x256xf16, #B> -> tensor<16x256xf32, #blocked>
+  tt.return %d : tensor<16x256xf32, #blocked>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 16], warpsPerCTA = [8, 1], order = [1, 0]}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>
+
+// Chained dots with enough rows for every warp: a single warp along N keeps
+// the first accumulator in registers.
+// CHECK: #[[MMA:.*]] = #triton_gpu.mma<{versionMajor = 2, versionMinor = 0, warpsPerCTA = [8, 1]}>
+// CHECK-LABEL: tt.func @chained_tall
+// CHECK: tt.dot {{.*}} -> tensor<128x64xf32, #[[MMA]]>
+// CHECK: tt.dot {{.*}} -> tensor<128x64xf32, #[[MMA]]>
+module attributes {"triton_gpu.num-warps" = 8 : i32} {
+tt.func @chained_tall(%q: tensor<128x64xf16, #A>, %k: tensor<64x64xf16, #B>, %v: tensor<64x64xf16, #B>) -> tensor<128x64xf32, #blocked> {
+  %zero = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+  %qk = tt.dot %q, %k, %zero {allowTF32 = true} : tensor<128x64xf16, #A> * tensor<64x64xf16, #B> -> tensor<128x64xf32, #blocked>
+  %p = arith.truncf %qk : tensor<128x64xf32, #blocked> to tensor<128x64xf16, #blocked>
+  %p_op = triton_gpu.convert_layout %p : (tensor<128x64xf16, #blocked>) -> tensor<128x64xf16, #A>
+  %o = tt.dot %p_op, %v, %zero {allowTF32 = true} : tensor<128x64xf16, #A> * tensor<64x64xf16, #B> -> tensor<128x64xf32, #blocked>
+  tt.return %o : tensor<128x64xf32, #blocked>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 16], warpsPerCTA = [8, 1], order = [1, 0]}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>
+
+// Chained dots with too few rows for 8 warps along M: converting the first
+// accumulator is cheaper than replicating both dots.
+// CHECK: #[[MMA:.*]] = #triton_gpu.mma<{versionMajor = 2, versionMinor = 0, warpsPerCTA = [4, 2]}>
+// CHECK-LABEL: tt.func @chained_short
+// CHECK: tt.dot {{.*}} -> tensor<64x64xf32, #[[MMA]]>
+// CHECK: tt.dot {{.*}} -> tensor<64x64xf32, #[[MMA]]>
+module attributes {"triton_gpu.num-warps" = 8 : i32} {
+tt.func @chained_short(%q: tensor<64x64xf16, #A>, %k: tensor<64x64xf16, #B>, %v: tensor<64x64xf16, #B>) -> tensor<64x64xf32, #blocked> {
+  %zero = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #blocked>
+  %qk = tt.dot %q, %k, %zero {allowTF32 = true} : tensor<64x64xf16, #A> * tensor<64x64xf16, #B> -> tensor<64x64xf32, #blocked>
+  %p = arith.truncf %qk : tensor<64x64xf32, #blocked> to tensor<64x64xf16, #blocked>
+  %p_op = triton_gpu.convert_layout %p : (tensor<64x64xf16, #blocked>) -> tensor<64x64xf16, #A>
+  %o = tt.dot %p_op, %v, %zero {allowTF32 = true} : tensor<64x64xf16, #A> * tensor<64x64xf16, #B> -> tensor<64x64xf32, #blocked>
+  tt.return %o : tensor<64x64xf32, #blocked>
+}
+}
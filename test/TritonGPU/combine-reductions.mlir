@@ -0,0 +1,131 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-combine-reductions | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-combine-reductions --convert-triton-gpu-to-llvm | FileCheck %s --check-prefix=LLVM
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [1, 4], order = [1, 0]}>
+#slice = #triton_gpu.slice<{dim = 1, parent = #blocked}>
+
+// The sum of squares is computed above the sum and both share one reduction.
+// CHECK-LABEL: tt.func @layernorm_moments
+// CHECK: %[[X2:.*]] = arith.mulf %arg0, %arg0
+// CHECK-NEXT: %[[R:.*]]:2 = "tt.reduce"(%arg0, %[[X2]]) <{axis = 1 : i32}> ({
+// CHECK-NEXT: ^bb0(%[[A0:[^:]*]]: f32, %[[A1:[^:]*]]: f32, %[[B0:[^:]*]]: f32, %[[B1:[^:]*]]: f32):
+// CHECK-NEXT: %[[S0:.*]] = arith.addf %[[A0]], %[[B0]] : f32
+// CHECK-NEXT: %[[S1:.*]] = arith.addf %[[A1]], %[[B1]] : f32
+// CHECK-NEXT: tt.reduce.return %[[S0]], %[[S1]] : f32, f32
+// CHECK-NEXT: })
+// CHECK-NOT: tt.reduce
+// CHECK: tt.return %[[R]]#0, %[[R]]#1
+
+// Two barriers for the combined reduction instead of two for each reduction
+// and one between them.
+// LLVM-LABEL: llvm.func @layernorm_moments
+// LLVM-COUNT-2: nvvm.barrier0
+// LLVM-NOT: nvvm.barrier0
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @layernorm_moments(%x: tensor<4x512xf32, #blocked>) -> (tensor<4xf32, #slice>, tensor<4xf32, #slice>) {
+  %sum = "tt.reduce"(%x) ({
+  ^bb0(%a: f32, %b: f32):
+    %s = arith.addf %a, %b : f32
+    tt.reduce.return %s : f32
+  }) {axis = 1 : i32} : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+  %x2 = arith.mulf %x, %x : tensor<4x512xf32, #blocked>
+  %sum2 = "tt.reduce"(%x2) ({
+  ^bb0(%a: f32, %b: f32):
+    %s = arith.addf %a, %b : f32
+    tt.reduce.return %s : f32
+  }) {axis = 1 : i32} : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+  tt.return %sum, %sum2 : tensor<4xf32, #slice>, tensor<4xf32, #slice>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [1, 4], order = [1, 0]}>
+#slice = #triton_gpu.slice<{dim = 1, parent = #blocked}>
+
+// The sum of the softmax depends on the max and is left alone.
+// CHECK-LABEL: tt.func @softmax
+// CHECK: "tt.reduce"(%arg0)
+// CHECK: arith.maxf
+// CHECK: "tt.reduce"(%{{.*}})
+// CHECK: arith.addf
+// LLVM-LABEL: llvm.func @softmax
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @softmax(%x: tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice> {
+  %max = "tt.reduce"(%x) ({
+  ^bb0(%a: f32, %b: f32):
+    %m = arith.maxf %a, %b : f32
+    tt.reduce.return %m : f32
+  }) {axis = 1 : i32} : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+  %max_2d = tt.expand_dims %max {axis = 1 : i32} : (tensor<4xf32, #slice>) -> tensor<4x1xf32, #blocked>
+  %max_b = tt.broadcast %max_2d : (tensor<4x1xf32, #blocked>) -> tensor<4x512xf32, #blocked>
+  %shifted = arith.subf %x, %max_b : tensor<4x512xf32, #blocked>
+  %e = math.exp %shifted : tensor<4x512xf32, #blocked>
+  %sum = "tt.reduce"(%e) ({
+  ^bb0(%a: f32, %b: f32):
+    %s = arith.addf %a, %b : f32
+    tt.reduce.return %s : f32
+  }) {axis = 1 : i32} : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+  tt.return %sum : tensor<4xf32, #slice>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [2, 2], order = [1, 0]}>
+
+// Reductions along different axes are left alone.
+// CHECK-LABEL: tt.func @different_axes
+// CHECK: "tt.reduce"(%arg0) <{axis = 0 : i32}>
+// CHECK: "tt.reduce"(%arg0) <{axis = 1 : i32}>
+// LLVM-LABEL: llvm.func @different_axes
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @different_axes(%x: tensor<32x32xf32, #blocked>) -> (tensor<32xf32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>, tensor<32xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>) {
+  %s0 = "tt.reduce"(%x) ({
+  ^bb0(%a: f32, %b: f32):
+    %s = arith.addf %a, %b : f32
+    tt.reduce.return %s : f32
+  }) {axis = 0 : i32} : (tensor<32x32xf32, #blocked>) -> tensor<32xf32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+  %s1 = "tt.reduce"(%x) ({
+  ^bb0(%a: f32, %b: f32):
+    %s = arith.addf %a, %b : f32
+    tt.reduce.return %s : f32
+  }) {axis = 1 : i32} : (tensor<32x32xf32, #blocked>) -> tensor<32xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+  tt.return %s0, %s1 : tensor<32xf32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>, tensor<32xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [1, 4], order = [1, 0]}>
+#slice = #triton_gpu.slice<{dim = 1, parent = #blocked}>
+
+// The combine region of the second reduction uses a value computed between
+// the two: it is hoisted above the combined reduction along with the operand.
+// CHECK-LABEL: tt.func @captured_value
+// CHECK: %[[CAP:.*]] = arith.mulf %arg1, %arg1 : f32
+// CHECK: %[[X2:.*]] = arith.mulf %arg0, %arg0
+// CHECK-NEXT: %[[R:.*]]:2 = "tt.reduce"(%arg0, %[[X2]]) <{axis = 1 : i32}> ({
+// CHECK: arith.minf %{{.*}}, %[[CAP]] : f32
+// CHECK: })
+// CHECK-NOT: tt.reduce
+// CHECK: tt.return %[[R]]#0, %[[R]]#1
+// LLVM-LABEL: llvm.func @captured_value
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @captured_value(%x: tensor<4x512xf32, #blocked>, %c: f32) -> (tensor<4xf32, #slice>, tensor<4xf32, #slice>) {
+  %sum = "tt.reduce"(%x) ({
+  ^bb0(%a: f32, %b: f32):
+    %s = arith.addf %a, %b : f32
+    tt.reduce.return %s : f32
+  }) {axis = 1 : i32} : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+  %cap = arith.mulf %c, %c : f32
+  %x2 = arith.mulf %x, %x : tensor<4x512xf32, #blocked>
+  %sum2 = "tt.reduce"(%x2) ({
+  ^bb0(%a: f32, %b: f32):
+    %s = arith.addf %a, %b : f32
+    %m = arith.minf %s, %cap : f32
+    tt.reduce.return %m : f32
+  }) {axis = 1 : i32} : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+  tt.return %sum, %sum2 : tensor<4xf32, #slice>, tensor<4xf32, #slice>
+}
+}
@@ -0,0 +1,86 @@
+// RUN: triton-opt %s -tritongpu-remove-layout-conversions=global-layout-assignment=true | FileCheck %s
+// RUN: triton-opt %s -tritongpu-remove-layout-conversions=global-layout-assignment=true -mlir-pass-statistics -o /dev/null 2>&1 | FileCheck %s --check-prefix=STATS
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// CHECK: [[$blocked0:#.*]] = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+// CHECK: [[$blocked1:#.*]] = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// STATS-DAG: (S) 5 num-converts-before
+// STATS-DAG: (S) 1 num-converts-after
+
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+
+// The layout of the load is propagated through the elementwise chain and
+// both conversions disappear.
+// CHECK-LABEL: elementwise_chain
+tt.func @elementwise_chain(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+  %0 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<1024x!tt.ptr<f32>, #blocked1>
+  %1 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked1>
+  %2 = tt.addptr %0, %1 : tensor<1024x!tt.ptr<f32>, #blocked1>, tensor<1024xi32, #blocked1>
+  %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<1024xf32, #blocked1>
+  %4 = triton_gpu.convert_layout %3 : (tensor<1024xf32, #blocked1>) -> tensor<1024xf32, #blocked0>
+  %5 = arith.mulf %4, %4 : tensor<1024xf32, #blocked0>
+  %6 = arith.addf %5, %4 : tensor<1024xf32, #blocked0>
+  %7 = triton_gpu.convert_layout %6 : (tensor<1024xf32, #blocked0>) -> tensor<1024xf32, #blocked1>
+  %8 = tt.splat %arg1 : (!tt.ptr<f32>) -> tensor<1024x!tt.ptr<f32>, #blocked1>
+  %9 = tt.addptr %8, %1 : tensor<1024x!tt.ptr<f32>, #blocked1>, tensor<1024xi32, #blocked1>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: arith.mulf {{.*}} : tensor<1024xf32, [[$blocked1]]>
+  // CHECK: arith.addf {{.*}} : tensor<1024xf32, [[$blocked1]]>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.store
+  tt.store %9, %7 : tensor<1024xf32, #blocked1>
+  tt.return
+}
+
+// The layout of the load is propagated to the loop-carried accumulator.
+// CHECK-LABEL: loop_carried
+tt.func @loop_carried(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c32 = arith.constant 32 : index
+  %cst = arith.constant dense<0.000000e+00> : tensor<1024xf32, #blocked0>
+  %0 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<1024x!tt.ptr<f32>, #blocked1>
+  %1 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked1>
+  %2 = tt.addptr %0, %1 : tensor<1024x!tt.ptr<f32>, #blocked1>, tensor<1024xi32, #blocked1>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: scf.for {{.*}} -> (tensor<1024xf32, [[$blocked1]]>)
+  %3 = scf.for %arg2 = %c0 to %c32 step %c1 iter_args(%arg3 = %cst) -> (tensor<1024xf32, #blocked0>) {
+    %4 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<1024xf32, #blocked1>
+    %5 = triton_gpu.convert_layout %4 : (tensor<1024xf32, #blocked1>) -> tensor<1024xf32, #blocked0>
+    %6 = arith.addf %arg3, %5 : tensor<1024xf32, #blocked0>
+    scf.yield %6 : tensor<1024xf32, #blocked0>
+  }
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.store
+  %7 = triton_gpu.convert_layout %3 : (tensor<1024xf32, #blocked0>) -> tensor<1024xf32, #blocked1>
+  %8 = tt.splat %arg1 : (!tt.ptr<f32>) -> tensor<1024x!tt.ptr<f32>, #blocked1>
+  %9 = tt.addptr %8, %1 : tensor<1024x!tt.ptr<f32>, #blocked1>, tensor<1024xi32, #blocked1>
+  tt.store %9, %7 : tensor<1024xf32, #blocked1>
+  tt.return
+}
+
+// Two anchors reach the same add; the cost model keeps the layout that also
+// matches the store so that a single conversion is left.
+// CHECK-LABEL: conflict
+tt.func @conflict(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+  %0 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<1024x!tt.ptr<f32>, #blocked1>
+  %1 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked1>
+  %2 = tt.addptr %0, %1 : tensor<1024x!tt.ptr<f32>, #blocked1>, tensor<1024xi32, #blocked1>
+  %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<1024xf32, #blocked1>
+  %4 = triton_gpu.convert_layout %3 : (tensor<1024xf32, #blocked1>) -> tensor<1024xf32, #blocked0>
+  %5 = tt.splat %arg1 : (!tt.ptr<f32>) -> tensor<1024x!tt.ptr<f32>, #blocked0>
+  %6 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked0>
+  %7 = tt.addptr %5, %6 : tensor<1024x!tt.ptr<f32>, #blocked0>, tensor<1024xi32, #blocked0>
+  %8 = tt.load %7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<1024xf32, #blocked0>
+  // CHECK: triton_gpu.convert_layout {{.*}} -> tensor<1024xf32, [[$blocked0]]>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: arith.addf {{.*}} : tensor<1024xf32, [[$blocked0]]>
+  %9 = arith.addf %4, %8 : tensor<1024xf32, #blocked0>
+  tt.store %7, %9 : tensor<1024xf32, #blocked0>
+  tt.return
+}
+
+}
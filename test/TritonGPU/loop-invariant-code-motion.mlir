@@ -0,0 +1,88 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-licm | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// Offsets, masks and pointers that do not depend on the loop are computed
+// once, out of both loops. Tensor constants stay where they are.
+// CHECK-LABEL: tt.func @hoist_offsets_and_masks
+// CHECK: %[[RANGE:.*]] = tt.make_range
+// CHECK: %[[BASE:.*]] = tt.splat %arg1
+// CHECK: %[[OFFSETS:.*]] = arith.addi %[[BASE]], %[[RANGE]]
+// CHECK: %[[BOUND:.*]] = tt.splat %arg2
+// CHECK: %[[MASK:.*]] = arith.cmpi slt, %[[OFFSETS]], %[[BOUND]]
+// CHECK: %[[PTRS:.*]] = tt.splat %arg0
+// CHECK: %[[ADDRS:.*]] = tt.addptr %[[PTRS]], %[[OFFSETS]]
+// CHECK: scf.for
+// CHECK-NOT: tt.splat
+// CHECK:   scf.for
+// CHECK-NOT: tt.splat
+// CHECK:     arith.constant dense<0.000000e+00>
+// CHECK:     tt.load %[[ADDRS]], %[[MASK]]
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @hoist_offsets_and_masks(%arg0: !tt.ptr<f32>, %arg1: i32, %arg2: i32, %lb: index, %ub: index, %step: index) -> tensor<128xf32, #blocked> {
+  %init = arith.constant dense<0.000000e+00> : tensor<128xf32, #blocked>
+  %outer = scf.for %i = %lb to %ub step %step iter_args(%acc0 = %init) -> (tensor<128xf32, #blocked>) {
+    %inner = scf.for %j = %lb to %ub step %step iter_args(%acc = %acc0) -> (tensor<128xf32, #blocked>) {
+      %range = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32, #blocked>
+      %base = tt.splat %arg1 : (i32) -> tensor<128xi32, #blocked>
+      %offsets = arith.addi %base, %range : tensor<128xi32, #blocked>
+      %bound = tt.splat %arg2 : (i32) -> tensor<128xi32, #blocked>
+      %mask = arith.cmpi slt, %offsets, %bound : tensor<128xi32, #blocked>
+      %ptrs = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<128x!tt.ptr<f32>, #blocked>
+      %addrs = tt.addptr %ptrs, %offsets : tensor<128x!tt.ptr<f32>, #blocked>, tensor<128xi32, #blocked>
+      %other = arith.constant dense<0.000000e+00> : tensor<128xf32, #blocked>
+      %x = tt.load %addrs, %mask, %other {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32, #blocked>
+      %sum = arith.addf %acc, %x : tensor<128xf32, #blocked>
+      scf.yield %sum : tensor<128xf32, #blocked>
+    }
+    scf.yield %inner : tensor<128xf32, #blocked>
+  }
+  tt.return %outer : tensor<128xf32, #blocked>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+
+// The broadcast would keep 128 registers per thread live across the loop:
+// only the scalar math and the row vector are hoisted.
+// CHECK-LABEL: tt.func @keep_wide_broadcast
+// CHECK: %[[SCALE:.*]] = arith.muli %arg1, %arg1
+// CHECK: %[[ROW:.*]] = tt.splat %[[SCALE]] : (i32) -> tensor<1x128xi32
+// CHECK: scf.for
+// CHECK:   tt.broadcast %[[ROW]]
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @keep_wide_broadcast(%arg0: tensor<128x128xi32, #blocked>, %arg1: i32, %lb: index, %ub: index, %step: index) -> tensor<128x128xi32, #blocked> {
+  %res = scf.for %i = %lb to %ub step %step iter_args(%acc = %arg0) -> (tensor<128x128xi32, #blocked>) {
+    %scale = arith.muli %arg1, %arg1 : i32
+    %row = tt.splat %scale : (i32) -> tensor<1x128xi32, #blocked>
+    %full = tt.broadcast %row : (tensor<1x128xi32, #blocked>) -> tensor<128x128xi32, #blocked>
+    %next = arith.addi %acc, %full : tensor<128x128xi32, #blocked>
+    scf.yield %next : tensor<128x128xi32, #blocked>
+  }
+  tt.return %res : tensor<128x128xi32, #blocked>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// The loop may not run, and %arg1 may be zero: the division stays in the loop
+// while its operand is hoisted.
+// CHECK-LABEL: tt.func @keep_division
+// CHECK: %[[DIVISOR:.*]] = tt.splat %arg1
+// CHECK: scf.for
+// CHECK:   arith.divsi %arg0, %[[DIVISOR]]
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @keep_division(%arg0: tensor<128xi32, #blocked>, %arg1: i32, %lb: index, %ub: index, %step: index) -> tensor<128xi32, #blocked> {
+  %res = scf.for %i = %lb to %ub step %step iter_args(%acc = %arg0) -> (tensor<128xi32, #blocked>) {
+    %divisor = tt.splat %arg1 : (i32) -> tensor<128xi32, #blocked>
+    %quot = arith.divsi %arg0, %divisor : tensor<128xi32, #blocked>
+    %next = arith.addi %acc, %quot : tensor<128xi32, #blocked>
+    scf.yield %next : tensor<128xi32, #blocked>
+  }
+  tt.return %res : tensor<128xi32, #blocked>
+}
+}
@@ -0,0 +1,120 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-pipeline="num-stages=4 auto-num-stages=true compute-capability=80" | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-pipeline="num-stages=4 auto-num-stages=true compute-capability=80" -o %t 2>&1 | FileCheck %s --check-prefix=SM80
+// RUN: triton-opt %s -split-input-file -tritongpu-pipeline="num-stages=4 auto-num-stages=true compute-capability=75" -o %t 2>&1 | FileCheck %s --check-prefix=SM75
+
+// 32KB per stage: the requested 4 stages fit on sm80, only 2 on sm75.
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#C = #triton_gpu.mma<{versionMajor = 2, warpsPerCTA = [4, 1]}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth=2}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth=2}>
+
+// SM80: remark: pipelined 2 load(s) with 4 stages using 131072 bytes of shared memory
+// SM75: remark: pipelined 2 load(s) with 2 stages using 65536 bytes of shared memory
+// CHECK-LABEL: tt.func @matmul_32kb
+// CHECK: triton_gpu.alloc_tensor : tensor<4x128x64xf16
+// CHECK: triton_gpu.alloc_tensor : tensor<4x64x128xf16
+tt.func @matmul_32kb(%lb : index, %ub : index, %step : index,
+                  %A : !tt.ptr<f16> {tt.divisibility = 16 : i32},
+                  %B : !tt.ptr<f16> {tt.divisibility = 16 : i32}) -> tensor<128x128xf32, #C> {
+  %a_ptr_init = tt.splat %A : (!tt.ptr<f16>) -> tensor<128x64x!tt.ptr<f16>, #AL>
+  %b_ptr_init = tt.splat %B : (!tt.ptr<f16>) -> tensor<64x128x!tt.ptr<f16>, #BL>
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_off = arith.constant dense<4> : tensor<128x64xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<64x128xi32, #BL>
+  %loop:3 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %prev_c = %c_init) -> (tensor<128x64x!tt.ptr<f16>, #AL>, tensor<64x128x!tt.ptr<f16>, #BL>, tensor<128x128xf32, #C>) {
+    %a_ = tt.load %a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x64xf16, #AL>
+    %a = triton_gpu.convert_layout %a_ : (tensor<128x64xf16, #AL>) -> tensor<128x64xf16, #A>
+    %b_ = tt.load %b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x128xf16, #BL>
+    %b = triton_gpu.convert_layout %b_ : (tensor<64x128xf16, #BL>) -> tensor<64x128xf16, #B>
+    %c = tt.dot %a, %b, %prev_c {allowTF32 = true} : tensor<128x64xf16, #A> * tensor<64x128xf16, #B> -> tensor<128x128xf32, #C>
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x64x!tt.ptr<f16>, #AL>, tensor<128x64xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<64x128x!tt.ptr<f16>, #BL>, tensor<64x128xi32, #BL>
+    scf.yield %next_a_ptr, %next_b_ptr, %c : tensor<128x64x!tt.ptr<f16>, #AL>, tensor<64x128x!tt.ptr<f16>, #BL>, tensor<128x128xf32, #C>
+  }
+  tt.return %loop#2: tensor<128x128xf32, #C>
+}
+
+// -----
+
+// 128KB per stage: not even a double buffer fits. On sm80, A is left in the
+// loop body and B is double-buffered; on sm75 nothing is pipelined.
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#C = #triton_gpu.mma<{versionMajor = 2, warpsPerCTA = [4, 1]}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth=2}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth=2}>
+
+// SM80: remark: load not pipelined: 131072 bytes of double buffering exceed the shared memory budget
+// SM80: remark: pipelined 1 load(s) with 2 stages using 131072 bytes of shared memory
+// SM75: remark: load not pipelined
+// SM75: remark: load not pipelined
+// SM75-NOT: remark: pipelined
+// CHECK-LABEL: tt.func @matmul_128kb
+// CHECK: triton_gpu.alloc_tensor : tensor<2x256x128xf16
+// CHECK-NOT: triton_gpu.alloc_tensor
+// CHECK: scf.for
+// CHECK:   tt.load {{.*}} : tensor<128x256xf16
+tt.func @matmul_128kb(%lb : index, %ub : index, %step : index,
+                  %A : !tt.ptr<f16> {tt.divisibility = 16 : i32},
+                  %B : !tt.ptr<f16> {tt.divisibility = 16 : i32}) -> tensor<128x128xf32, #C> {
+  %a_ptr_init = tt.splat %A : (!tt.ptr<f16>) -> tensor<128x256x!tt.ptr<f16>, #AL>
+  %b_ptr_init = tt.splat %B : (!tt.ptr<f16>) -> tensor<256x128x!tt.ptr<f16>, #BL>
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_off = arith.constant dense<4> : tensor<128x256xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<256x128xi32, #BL>
+  %loop:3 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %prev_c = %c_init) -> (tensor<128x256x!tt.ptr<f16>, #AL>, tensor<256x128x!tt.ptr<f16>, #BL>, tensor<128x128xf32, #C>) {
+    %a_ = tt.load %a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x256xf16, #AL>
+    %a = triton_gpu.convert_layout %a_ : (tensor<128x256xf16, #AL>) -> tensor<128x256xf16, #A>
+    %b_ = tt.load %b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256x128xf16, #BL>
+    %b = triton_gpu.convert_layout %b_ : (tensor<256x128xf16, #BL>) -> tensor<256x128xf16, #B>
+    %c = tt.dot %a, %b, %prev_c {allowTF32 = true} : tensor<128x256xf16, #A> * tensor<256x128xf16, #B> -> tensor<128x128xf32, #C>
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x256x!tt.ptr<f16>, #AL>, tensor<128x256xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<256x128x!tt.ptr<f16>, #BL>, tensor<256x128xi32, #BL>
+    scf.yield %next_a_ptr, %next_b_ptr, %c : tensor<128x256x!tt.ptr<f16>, #AL>, tensor<256x128x!tt.ptr<f16>, #BL>, tensor<128x128xf32, #C>
+  }
+  tt.return %loop#2: tensor<128x128xf32, #C>
+}
+
+// -----
+
+// Same loop as @matmul_32kb, but the function also converts a tensor whose
+// 64KB scratch buffer has to fit next to the pipeline buffers: only 3 stages
+// fit on sm80, and nothing is pipelined on sm75.
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#X = #triton_gpu.blocked<{sizePerThread = [128], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+#Y = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+#C = #triton_gpu.mma<{versionMajor = 2, warpsPerCTA = [4, 1]}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth=2}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth=2}>
+
+// SM80: remark: pipelined 2 load(s) with 3 stages using 98304 bytes of shared memory next to 65536 bytes of scratch
+// SM75: remark: load not pipelined
+// SM75: remark: load not pipelined
+// SM75-NOT: remark: pipelined
+// CHECK-LABEL: tt.func @matmul_32kb_scratch
+// CHECK: triton_gpu.alloc_tensor : tensor<3x128x64xf16
+// CHECK: triton_gpu.alloc_tensor : tensor<3x64x128xf16
+tt.func @matmul_32kb_scratch(%lb : index, %ub : index, %step : index,
+                  %A : !tt.ptr<f16> {tt.divisibility = 16 : i32},
+                  %B : !tt.ptr<f16> {tt.divisibility = 16 : i32},
+                  %x : tensor<16384xf32, #X>) -> (tensor<128x128xf32, #C>, tensor<16384xf32, #Y>) {
+  %a_ptr_init = tt.splat %A : (!tt.ptr<f16>) -> tensor<128x64x!tt.ptr<f16>, #AL>
+  %b_ptr_init = tt.splat %B : (!tt.ptr<f16>) -> tensor<64x128x!tt.ptr<f16>, #BL>
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_off = arith.constant dense<4> : tensor<128x64xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<64x128xi32, #BL>
+  %loop:3 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %prev_c = %c_init) -> (tensor<128x64x!tt.ptr<f16>, #AL>, tensor<64x128x!tt.ptr<f16>, #BL>, tensor<128x128xf32, #C>) {
+    %a_ = tt.load %a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x64xf16, #AL>
+    %a = triton_gpu.convert_layout %a_ : (tensor<128x64xf16, #AL>) -> tensor<128x64xf16, #A>
+    %b_ = tt.load %b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x128xf16, #BL>
+    %b = triton_gpu.convert_layout %b_ : (tensor<64x128xf16, #BL>) -> tensor<64x128xf16, #B>
+    %c = tt.dot %a, %b, %prev_c {allowTF32 = true} : tensor<128x64xf16, #A> * tensor<64x128xf16, #B> -> tensor<128x128xf32, #C>
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x64x!tt.ptr<f16>, #AL>, tensor<128x64xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<64x128x!tt.ptr<f16>, #BL>, tensor<64x128xi32, #BL>
+    scf.yield %next_a_ptr, %next_b_ptr, %c : tensor<128x64x!tt.ptr<f16>, #AL>, tensor<64x128x!tt.ptr<f16>, #BL>, tensor<128x128xf32, #C>
+  }
+  %y = triton_gpu.convert_layout %x : (tensor<16384xf32, #X>) -> tensor<16384xf32, #Y>
+  tt.return %loop#2, %y : tensor<128x128xf32, #C>, tensor<16384xf32, #Y>
+}
@@ -1,4 +1,5 @@
 // RUN: triton-opt %s -split-input-file -tritongpu-pipeline=num-stages=3 -canonicalize | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-pipeline="num-stages=3 pipeline-other-loads=true" -canonicalize | FileCheck %s --check-prefix=OTHER
 
 // 4 warps
 // matmul: 128x32 @ 32x128 -> 128x128
@@ -497,3 +498,49 @@ tt.func @dep_arg_two_uses(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32},
   }
   tt.return %91#3 : tensor<128x128xf32, #C>
 }
+
+// By default, loads that do not feed a dot stay in the loop body.
+// CHECK: tt.func @reduce_loop_other
+// CHECK-NOT: triton_gpu.insert_slice_async
+// CHECK: scf.for
+// CHECK:   tt.load
+
+// With pipeline-other-loads, they are staged in shared memory and converted
+// back to their own layout. Their `other` value is forwarded to the async copy.
+// OTHER: tt.func @reduce_loop_other
+// OTHER-DAG: %[[OTHER:.*]] = arith.constant dense<0xFF800000> : tensor<32x128xf32, #{{.*}}>
+// OTHER: %[[BUFFER:.*]] = triton_gpu.alloc_tensor : tensor<3x32x128xf32, #[[SHARED:.*]]>
+// OTHER: triton_gpu.insert_slice_async {{.*}}, %[[BUFFER]], {{.*}}, {{.*}}, %[[OTHER]] {
+// OTHER: triton_gpu.insert_slice_async {{.*}}, {{.*}}, {{.*}}, {{.*}}, %[[OTHER]] {
+// OTHER: triton_gpu.async_wait {num = 1 : i32}
+// OTHER: scf.for
+// OTHER:   %[[A:.*]] = triton_gpu.convert_layout %{{.*}} : (tensor<32x128xf32, #[[SHARED]]>) -> tensor<32x128xf32, #{{.*}}>
+// OTHER:   arith.maxf %{{.*}}, %[[A]]
+// OTHER:   triton_gpu.insert_slice_async {{.*}}, {{.*}}, {{.*}}, {{.*}}, %[[OTHER]] {
+// OTHER:   triton_gpu.async_wait {num = 1 : i32}
+tt.func @reduce_loop_other(%lb : index, %ub : index, %step : index,
+                           %A : !tt.ptr<f32> {tt.divisibility = 16 : i32},
+                           %n : i32) -> tensor<32x128xf32, #AL> {
+  %a_ptr_splat = tt.splat %A : (!tt.ptr<f32>) -> tensor<32x128x!tt.ptr<f32>, #AL>
+  %a_tmp0 = tt.make_range {end = 128: i32, start = 0: i32} : tensor<128xi32, #ALs0>
+  %a_tmp1 = tt.expand_dims %a_tmp0 {axis = 0 : i32} : (tensor<128xi32, #ALs0>) -> tensor<1x128xi32, #AL>
+  %a_offs = tt.broadcast %a_tmp1 : (tensor<1x128xi32, #AL>) -> tensor<32x128xi32, #AL>
+  %a_ptr_init = tt.addptr %a_ptr_splat, %a_offs : tensor<32x128x!tt.ptr<f32>, #AL>, tensor<32x128xi32, #AL>
+
+  %rows = tt.make_range {end = 32: i32, start = 0: i32} : tensor<32xi32, #triton_gpu.slice<{dim = 1, parent = #AL}>>
+  %rows_2d = tt.expand_dims %rows {axis = 1 : i32} : (tensor<32xi32, #triton_gpu.slice<{dim = 1, parent = #AL}>>) -> tensor<32x1xi32, #AL>
+  %n_splat = tt.splat %n : (i32) -> tensor<32x1xi32, #AL>
+  %row_mask = arith.cmpi slt, %rows_2d, %n_splat : tensor<32x1xi32, #AL>
+  %a_mask = tt.broadcast %row_mask : (tensor<32x1xi1, #AL>) -> tensor<32x128xi1, #AL>
+  %a_other = arith.constant dense<0xFF800000> : tensor<32x128xf32, #AL>
+  %a_off = arith.constant dense<128> : tensor<32x128xi32, #AL>
+  %max_init = arith.constant dense<0.00e+00> : tensor<32x128xf32, #AL>
+
+  %loop:2 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %prev_max = %max_init) -> (tensor<32x128x!tt.ptr<f32>, #AL>, tensor<32x128xf32, #AL>) {
+    %a = tt.load %a_ptr, %a_mask, %a_other {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf32, #AL>
+    %max = arith.maxf %prev_max, %a : tensor<32x128xf32, #AL>
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<32x128x!tt.ptr<f32>, #AL>, tensor<32x128xi32, #AL>
+    scf.yield %next_a_ptr, %max : tensor<32x128x!tt.ptr<f32>, #AL>, tensor<32x128xf32, #AL>
+  }
+  tt.return %loop#1 : tensor<32x128xf32, #AL>
+}
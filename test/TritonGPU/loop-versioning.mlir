@@ -0,0 +1,156 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-loop-versioning | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-loop-versioning -canonicalize -convert-scf-to-cf --convert-triton-gpu-to-llvm | FileCheck %s --check-prefix=PTX
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// CHECK-LABEL: tt.func @copy
+// CHECK-DAG: %[[C511:.*]] = arith.constant 511 : i32
+// CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+// CHECK-DAG: %[[C512:.*]] = arith.constant 512 : index
+// CHECK: %[[LAST:.*]] = arith.subi %arg2, %[[C511]]
+// CHECK: %[[LAST_IDX:.*]] = arith.index_cast %[[LAST]] : i32 to index
+// CHECK: %[[SPAN:.*]] = arith.subi %[[LAST_IDX]], %[[C0]]
+// CHECK: %[[POS_SPAN:.*]] = arith.maxsi %[[SPAN]], %{{.*}}
+// CHECK: %[[ITERS:.*]] = arith.ceildivsi %[[POS_SPAN]], %[[C512]]
+// CHECK: %[[UB_SPAN:.*]] = arith.subi %[[UB:.*]], %[[C0]]
+// CHECK: %[[POS_UB_SPAN:.*]] = arith.maxsi %[[UB_SPAN]], %{{.*}}
+// CHECK: %[[UB_ITERS:.*]] = arith.ceildivsi %[[POS_UB_SPAN]], %[[C512]]
+// CHECK: %[[MAIN_ITERS:.*]] = arith.minsi %[[ITERS]], %[[UB_ITERS]]
+// CHECK: %[[MAIN_SPAN:.*]] = arith.muli %[[MAIN_ITERS]], %[[C512]]
+// CHECK: %[[SPLIT:.*]] = arith.addi %[[C0]], %[[MAIN_SPAN]]
+// CHECK: scf.for %{{.*}} = %[[C0]] to %[[SPLIT]] step %[[C512]]
+// CHECK:   %[[X:.*]] = tt.load %{{[^,]*}} {cache
+// CHECK:   tt.store %{{.*}}, %[[X]] {cache
+// CHECK: %[[REM_UB:.*]] = arith.subi %[[UB]], %[[SPLIT]]
+// CHECK: %[[C15:.*]] = arith.constant 15 : i32
+// CHECK: %[[N_LOW:.*]] = arith.andi %arg2, %[[C15]]
+// CHECK: %[[N_DIVISIBLE:.*]] = arith.cmpi eq, %[[N_LOW]], %{{.*}} : i32
+// CHECK: scf.if %[[N_DIVISIBLE]] {
+// CHECK:   %[[N_HIGH:.*]] = arith.shrui %arg2, %[[C4:.*]] : i32
+// CHECK:   %[[N16:.*]] = arith.shli %[[N_HIGH]], %[[C4]] : i32
+// CHECK:   %[[BOUND16:.*]] = tt.splat %[[N16]]
+// CHECK:   scf.for %[[I:.*]] = %[[C0]] to %[[REM_UB]] step %[[C512]]
+// CHECK:     arith.addi %[[SPLIT]], %[[I]] : index
+// CHECK:     %[[MASK16:.*]] = arith.cmpi slt, %{{.*}}, %[[BOUND16]]
+// CHECK:     tt.load %{{.*}}, %[[MASK16]]
+// CHECK: } else {
+// CHECK:   scf.for %[[J:.*]] = %[[C0]] to %[[REM_UB]] step %[[C512]]
+// CHECK:     arith.addi %[[SPLIT]], %[[J]] : index
+// CHECK:     %[[MASK:.*]] = arith.cmpi slt
+// CHECK:     %[[Y:.*]] = tt.load %{{.*}}, %[[MASK]]
+// CHECK:     tt.store %{{.*}}, %[[Y]], %[[MASK]]
+// CHECK: }
+
+// The main loop is vectorized, and so is the remainder when %n is divisible.
+// PTX-LABEL: llvm.func @copy
+// PTX: ld.global.v4.b32
+// PTX: st.global.v4.b32
+// PTX: ld.global.v4.b32
+// PTX: st.global.v4.b32
+// PTX: ld.global.b32
+// PTX: st.global.b32
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @copy(%x: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %y: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %n: i32) {
+  %c0 = arith.constant 0 : index
+  %c512 = arith.constant 512 : index
+  %ub = arith.index_cast %n : i32 to index
+  %range = tt.make_range {end = 512 : i32, start = 0 : i32} : tensor<512xi32, #blocked>
+  %bound = tt.splat %n : (i32) -> tensor<512xi32, #blocked>
+  %xs = tt.splat %x : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  %ys = tt.splat %y : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  scf.for %iv = %c0 to %ub step %c512 {
+    %iv_i32 = arith.index_cast %iv : index to i32
+    %start = tt.splat %iv_i32 : (i32) -> tensor<512xi32, #blocked>
+    %offs = arith.addi %start, %range : tensor<512xi32, #blocked>
+    %mask = arith.cmpi slt, %offs, %bound : tensor<512xi32, #blocked>
+    %src = tt.addptr %xs, %offs : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+    %v = tt.load %src, %mask {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<512xf32, #blocked>
+    %dst = tt.addptr %ys, %offs : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+    tt.store %dst, %v, %mask : tensor<512xf32, #blocked>
+  }
+  tt.return
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// `make_range < K - k` masks are recognized too; the reduction is carried
+// from the main loop into the remainder.
+// CHECK-LABEL: tt.func @sum_k
+// CHECK: %[[MAIN:.*]] = scf.for
+// CHECK:   tt.load %{{[^,]*}} {cache
+// CHECK: scf.if
+// CHECK:   scf.for %{{.*}} iter_args(%{{.*}} = %[[MAIN]])
+// CHECK: } else {
+// CHECK:   scf.for %{{.*}} iter_args(%{{.*}} = %[[MAIN]])
+// CHECK:     arith.subi %arg1
+// CHECK:     tt.load %{{.*}}, %{{.*}}, %{{.*}} {cache
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @sum_k(%x: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %k: i32) -> tensor<512xf32, #blocked> {
+  %c0 = arith.constant 0 : index
+  %c512 = arith.constant 512 : index
+  %ub = arith.index_cast %k : i32 to index
+  %zero = arith.constant dense<0.000000e+00> : tensor<512xf32, #blocked>
+  %range = tt.make_range {end = 512 : i32, start = 0 : i32} : tensor<512xi32, #blocked>
+  %xs = tt.splat %x : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  %res = scf.for %iv = %c0 to %ub step %c512 iter_args(%acc = %zero) -> (tensor<512xf32, #blocked>) {
+    %iv_i32 = arith.index_cast %iv : index to i32
+    %left = arith.subi %k, %iv_i32 : i32
+    %left_splat = tt.splat %left : (i32) -> tensor<512xi32, #blocked>
+    %mask = arith.cmpi slt, %range, %left_splat : tensor<512xi32, #blocked>
+    %start = tt.splat %iv_i32 : (i32) -> tensor<512xi32, #blocked>
+    %offs = arith.addi %start, %range : tensor<512xi32, #blocked>
+    %src = tt.addptr %xs, %offs : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+    %v = tt.load %src, %mask, %zero {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<512xf32, #blocked>
+    %sum = arith.addf %acc, %v : tensor<512xf32, #blocked>
+    scf.yield %sum : tensor<512xf32, #blocked>
+  }
+  tt.return %res : tensor<512xf32, #blocked>
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+
+// Matmul-style masks over a counter, `make_range < K - k * 32`, expanded and
+// broadcast. K is known to be divisible, so the remainder is not guarded.
+// CHECK-LABEL: tt.func @tile_k
+// CHECK: %[[SPAN:.*]] = arith.subi %arg1, %{{.*}} : i32
+// CHECK: %[[Q:.*]] = arith.floordivsi %[[SPAN]], %{{.*}} : i32
+// CHECK: %[[LAST:.*]] = arith.addi %[[Q]], %{{.*}} : i32
+// CHECK: arith.index_cast %[[LAST]] : i32 to index
+// CHECK: %[[MAIN:.*]] = scf.for
+// CHECK:   tt.load %{{[^,]*}} {cache
+// CHECK-NOT: scf.if
+// CHECK: scf.for %{{.*}} iter_args(%{{.*}} = %[[MAIN]])
+// CHECK:   tt.load %{{.*}}, %{{.*}}, %{{.*}} {cache
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @tile_k(%x: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %k: i32 {tt.divisibility = 16 : i32}, %num_tiles: index) -> tensor<16x32xf16, #blocked> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c32_i32 = arith.constant 32 : i32
+  %zero = arith.constant dense<0.000000e+00> : tensor<16x32xf16, #blocked>
+  %range = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+  %range_2d = tt.expand_dims %range {axis = 0 : i32} : (tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>) -> tensor<1x32xi32, #blocked>
+  %range_bc = tt.broadcast %range_2d : (tensor<1x32xi32, #blocked>) -> tensor<16x32xi32, #blocked>
+  %xs = tt.splat %x : (!tt.ptr<f16>) -> tensor<16x32x!tt.ptr<f16>, #blocked>
+  %res = scf.for %iv = %c0 to %num_tiles step %c1 iter_args(%acc = %zero) -> (tensor<16x32xf16, #blocked>) {
+    %iv_i32 = arith.index_cast %iv : index to i32
+    %done = arith.muli %iv_i32, %c32_i32 : i32
+    %left = arith.subi %k, %done : i32
+    %left_splat = tt.splat %left : (i32) -> tensor<1x32xi32, #blocked>
+    %mask_2d = arith.cmpi slt, %range_2d, %left_splat : tensor<1x32xi32, #blocked>
+    %mask = tt.broadcast %mask_2d : (tensor<1x32xi1, #blocked>) -> tensor<16x32xi1, #blocked>
+    %start = tt.splat %done : (i32) -> tensor<16x32xi32, #blocked>
+    %offs = arith.addi %start, %range_bc : tensor<16x32xi32, #blocked>
+    %src = tt.addptr %xs, %offs : tensor<16x32x!tt.ptr<f16>, #blocked>, tensor<16x32xi32, #blocked>
+    %v = tt.load %src, %mask, %zero {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16x32xf16, #blocked>
+    %sum = arith.addf %acc, %v : tensor<16x32xf16, #blocked>
+    scf.yield %sum : tensor<16x32xf16, #blocked>
+  }
+  tt.return %res : tensor<16x32xf16, #blocked>
+}
+}
@@ -0,0 +1,124 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-multi-version | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-multi-version -convert-scf-to-cf --convert-triton-gpu-to-llvm | FileCheck %s --check-prefix=PTX
+// RUN: triton-opt %s -split-input-file -tritongpu-multi-version="max-args=1" | FileCheck %s --check-prefix=CAP
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// %y is already known to be aligned and is not tested.
+// CHECK-LABEL: tt.func public @copy
+// CHECK: %[[X_INT:.*]] = tt.ptr_to_int %arg0 : !tt.ptr<f32> -> i64
+// CHECK: %[[C15_I64:.*]] = arith.constant 15 : i64
+// CHECK: %[[X_LOW:.*]] = arith.andi %[[X_INT]], %[[C15_I64]] : i64
+// CHECK: %[[C0_I64:.*]] = arith.constant 0 : i64
+// CHECK: %[[X_ALIGNED:.*]] = arith.cmpi eq, %[[X_LOW]], %[[C0_I64]] : i64
+// CHECK: %[[C15_I32:.*]] = arith.constant 15 : i32
+// CHECK: %[[S_LOW:.*]] = arith.andi %arg2, %[[C15_I32]] : i32
+// CHECK: %[[C0_I32:.*]] = arith.constant 0 : i32
+// CHECK: %[[S_ALIGNED:.*]] = arith.cmpi eq, %[[S_LOW]], %[[C0_I32]] : i32
+// CHECK: %[[ALIGNED:.*]] = arith.andi %[[X_ALIGNED]], %[[S_ALIGNED]] : i1
+// CHECK: scf.if %[[ALIGNED]] {
+// CHECK:   %[[X_BITS:.*]] = tt.ptr_to_int %arg0 : !tt.ptr<f32> -> i64
+// CHECK:   %[[C4_I64:.*]] = arith.constant 4 : i64
+// CHECK:   %[[X_HIGH:.*]] = arith.shrui %[[X_BITS]], %[[C4_I64]] : i64
+// CHECK:   %[[X_MULT:.*]] = arith.shli %[[X_HIGH]], %[[C4_I64]] : i64
+// CHECK:   %[[X16:.*]] = tt.int_to_ptr %[[X_MULT]] : i64 -> !tt.ptr<f32>
+// CHECK:   %[[C4_I32:.*]] = arith.constant 4 : i32
+// CHECK:   %[[S_HIGH:.*]] = arith.shrui %arg2, %[[C4_I32]] : i32
+// CHECK:   %[[S16:.*]] = arith.shli %[[S_HIGH]], %[[C4_I32]] : i32
+// CHECK:   %[[PID:.*]] = tt.get_program_id x
+// CHECK:   arith.muli %[[PID]], %[[S16]] : i32
+// CHECK:   tt.splat %[[X16]]
+// CHECK:   tt.load
+// CHECK:   tt.splat %arg1
+// CHECK:   tt.store
+// CHECK: } else {
+// CHECK:   %[[PID:.*]] = tt.get_program_id x
+// CHECK:   arith.muli %[[PID]], %arg2 : i32
+// CHECK:   tt.splat %arg0
+// CHECK:   tt.load
+// CHECK:   tt.splat %arg1
+// CHECK:   tt.store
+// CHECK: }
+// CHECK-NEXT: tt.return
+
+// The specialized body is vectorized, the generic one is not.
+// PTX-LABEL: llvm.func @copy
+// PTX: ld.global.v4.b32
+// PTX: st.global.v4.b32
+// PTX: ld.global.b32
+// PTX: st.global.b32
+
+// With a single tested argument, the pointer is kept and the stride dropped.
+// CAP-LABEL: tt.func public @copy
+// CAP: %[[X_INT:.*]] = tt.ptr_to_int %arg0 : !tt.ptr<f32> -> i64
+// CAP: %[[X_ALIGNED:.*]] = arith.cmpi eq, %{{.*}}, %{{.*}} : i64
+// CAP-NOT: arith.andi %arg2
+// CAP: scf.if %[[X_ALIGNED]] {
+// CAP-NOT: arith.shrui %arg2
+// CAP: arith.muli %{{.*}}, %arg2 : i32
+// CAP: } else {
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func public @copy(%x: !tt.ptr<f32>, %y: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %stride: i32) {
+  %pid = tt.get_program_id x : i32
+  %start = arith.muli %pid, %stride : i32
+  %start_splat = tt.splat %start : (i32) -> tensor<512xi32, #blocked>
+  %range = tt.make_range {end = 512 : i32, start = 0 : i32} : tensor<512xi32, #blocked>
+  %offs = arith.addi %start_splat, %range : tensor<512xi32, #blocked>
+  %xs = tt.splat %x : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  %src = tt.addptr %xs, %offs : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+  %v = tt.load %src {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<512xf32, #blocked>
+  %ys = tt.splat %y : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  %dst = tt.addptr %ys, %offs : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+  tt.store %dst, %v : tensor<512xf32, #blocked>
+  tt.return
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// Kernels whose arguments are all known to be aligned are left alone.
+// CHECK-LABEL: tt.func public @aligned
+// CHECK-NOT: scf.if
+// CHECK: tt.return
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func public @aligned(%x: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %y: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+  %range = tt.make_range {end = 512 : i32, start = 0 : i32} : tensor<512xi32, #blocked>
+  %xs = tt.splat %x : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  %src = tt.addptr %xs, %range : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+  %v = tt.load %src {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<512xf32, #blocked>
+  %ys = tt.splat %y : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  %dst = tt.addptr %ys, %range : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+  tt.store %dst, %v : tensor<512xf32, #blocked>
+  tt.return
+}
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+
+// %n only bounds the mask and is not tested.
+// CHECK-LABEL: tt.func public @masked_copy
+// CHECK: %[[X_INT:.*]] = tt.ptr_to_int %arg0 : !tt.ptr<f32> -> i64
+// CHECK-NOT: arith.andi %arg2
+// CHECK: %[[X_ALIGNED:.*]] = arith.cmpi eq, %{{.*}}, %{{.*}} : i64
+// CHECK: scf.if %[[X_ALIGNED]] {
+// CHECK-NOT: arith.shrui %arg2
+// CHECK: arith.cmpi slt, %{{.*}}, %{{.*}} : tensor<512xi32, #blocked>
+// CHECK: } else {
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func public @masked_copy(%x: !tt.ptr<f32>, %y: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %n: i32) {
+  %range = tt.make_range {end = 512 : i32, start = 0 : i32} : tensor<512xi32, #blocked>
+  %n_splat = tt.splat %n : (i32) -> tensor<512xi32, #blocked>
+  %mask = arith.cmpi slt, %range, %n_splat : tensor<512xi32, #blocked>
+  %xs = tt.splat %x : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  %src = tt.addptr %xs, %range : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+  %v = tt.load %src, %mask {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<512xf32, #blocked>
+  %ys = tt.splat %y : (!tt.ptr<f32>) -> tensor<512x!tt.ptr<f32>, #blocked>
+  %dst = tt.addptr %ys, %range : tensor<512x!tt.ptr<f32>, #blocked>, tensor<512xi32, #blocked>
+  tt.store %dst, %v, %mask : tensor<512xf32, #blocked>
+  tt.return
+}
+}
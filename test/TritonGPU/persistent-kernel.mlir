@@ -0,0 +1,95 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-persistent-kernel | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-persistent-kernel="atomic-scheduler=true num-programs=132" | FileCheck %s --check-prefix=ATOMIC
+
+// The grid to launch is recorded for the launcher: one program per SM by
+// default, or the number requested.
+// CHECK: module attributes {"triton_gpu.persistent-grid" = 0 : i32}
+// ATOMIC: module attributes {"triton_gpu.persistent-grid" = 132 : i32}
+
+// CHECK-LABEL: tt.func @matmul_kernel
+// CHECK-SAME: %[[NUM_TILES:[^ ]+]]: i32 {tt.num_tiles}
+// CHECK: %[[RANGE:.*]] = tt.make_range {end = 64 : i32, start = 0 : i32}
+// CHECK: %[[A_BASE:.*]] = tt.splat %arg0
+// CHECK: %[[PID:.*]] = tt.get_program_id x
+// CHECK: %[[NUM_PROGRAMS:.*]] = tt.get_num_programs
+// CHECK: scf.while (%[[TILE_ARG:.*]] = %[[PID]]) : (i32) -> i32
+// CHECK:   %[[COND:.*]] = arith.cmpi slt, %[[TILE_ARG]], %[[NUM_TILES]]
+// CHECK:   scf.condition(%[[COND]]) %[[TILE_ARG]]
+// CHECK: } do {
+// CHECK: ^bb0(%[[TILE:.*]]: i32):
+// CHECK-NOT: tt.make_range
+// CHECK:   arith.divsi %[[TILE]]
+// CHECK:   scf.for
+// CHECK:     tt.dot
+// CHECK:   tt.store
+// CHECK:   %[[NEXT:.*]] = arith.addi %[[TILE]], %[[NUM_PROGRAMS]]
+// CHECK:   scf.yield %[[NEXT]]
+// CHECK: tt.return
+
+// ATOMIC-LABEL: tt.func @matmul_kernel
+// ATOMIC-SAME: %{{[^ ]+}}: i32 {tt.num_tiles}, %[[COUNTER:[^ ]+]]: !tt.ptr<i32> {tt.tile_counter}
+// ATOMIC: %[[NUM_PROGRAMS:.*]] = tt.get_num_programs
+// ATOMIC: scf.while
+// ATOMIC: } do {
+// ATOMIC:   tt.store
+// ATOMIC:   %[[CLAIMED:.*]] = "tt.atomic_rmw"(%[[COUNTER]], %{{.*}}) {atomic_rmw_op = 4 : i32, sem = 4 : i32}
+// ATOMIC:   %[[NEXT:.*]] = arith.addi %[[CLAIMED]], %[[NUM_PROGRAMS]]
+// ATOMIC:   scf.yield %[[NEXT]]
+module {
+tt.func @matmul_kernel(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg2: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg3: i32, %arg4: i32 {tt.divisibility = 16 : i32}) {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %c64_i32 = arith.constant 64 : i32
+  %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+  %0 = tt.get_program_id x : i32
+  %1 = arith.divsi %0, %arg3 : i32
+  %2 = arith.remsi %0, %arg3 : i32
+  %3 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+  %4 = arith.muli %1, %c64_i32 : i32
+  %5 = tt.splat %4 : (i32) -> tensor<64xi32>
+  %6 = arith.addi %5, %3 : tensor<64xi32>
+  %7 = tt.expand_dims %6 {axis = 1 : i32} : (tensor<64xi32>) -> tensor<64x1xi32>
+  %8 = tt.broadcast %7 : (tensor<64x1xi32>) -> tensor<64x64xi32>
+  %9 = tt.splat %arg0 : (!tt.ptr<f16>) -> tensor<64x64x!tt.ptr<f16>>
+  %10 = tt.addptr %9, %8 : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+  %11 = arith.muli %2, %c64_i32 : i32
+  %12 = tt.splat %11 : (i32) -> tensor<64xi32>
+  %13 = arith.addi %12, %3 : tensor<64xi32>
+  %14 = tt.expand_dims %13 {axis = 0 : i32} : (tensor<64xi32>) -> tensor<1x64xi32>
+  %15 = tt.broadcast %14 : (tensor<1x64xi32>) -> tensor<64x64xi32>
+  %16 = tt.splat %arg1 : (!tt.ptr<f16>) -> tensor<64x64x!tt.ptr<f16>>
+  %17 = tt.addptr %16, %15 : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+  %18 = arith.index_cast %arg4 : i32 to index
+  %19 = tt.splat %c64_i32 : (i32) -> tensor<64x64xi32>
+  %20:3 = scf.for %arg5 = %c0 to %18 step %c64 iter_args(%arg6 = %cst, %arg7 = %10, %arg8 = %17) -> (tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>) {
+    %a = tt.load %arg7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %b = tt.load %arg8 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %c = tt.dot %a, %b, %arg6 {allowTF32 = true} : tensor<64x64xf16> * tensor<64x64xf16> -> tensor<64x64xf32>
+    %next_a = tt.addptr %arg7, %19 : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %next_b = tt.addptr %arg8, %19 : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    scf.yield %c, %next_a, %next_b : tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>
+  }
+  %21 = arith.addi %8, %15 : tensor<64x64xi32>
+  %22 = tt.splat %arg2 : (!tt.ptr<f32>) -> tensor<64x64x!tt.ptr<f32>>
+  %23 = tt.addptr %22, %21 : tensor<64x64x!tt.ptr<f32>>, tensor<64x64xi32>
+  tt.store %23, %20#0 : tensor<64x64xf32>
+  tt.return
+}
+}
+
+// -----
+
+// Kernels over a 2D grid are left alone.
+// CHECK-NOT: triton_gpu.persistent-grid
+// CHECK-LABEL: tt.func @grid_2d
+// CHECK-NOT: scf.while
+module {
+tt.func @grid_2d(%arg0: !tt.ptr<f32>) {
+  %0 = tt.get_program_id x : i32
+  %1 = tt.get_program_id y : i32
+  %2 = arith.addi %0, %1 : i32
+  %3 = arith.sitofp %2 : i32 to f32
+  tt.store %arg0, %3 : f32
+  tt.return
+}
+}
@@ -0,0 +1,73 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-prefetch -canonicalize | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-prefetch -convert-scf-to-cf --convert-triton-gpu-to-llvm | FileCheck %s --check-prefix=LLVM
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 8, perPhase = 1, maxPhase = 4, order = [1, 0]}>
+#B = #triton_gpu.shared<{vec = 8, perPhase = 1, maxPhase = 4, order = [1, 0]}>
+#C = #triton_gpu.mma<{version = 2, warpsPerCTA = [4, 1]}>
+#A_OP = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth = 2}>
+#B_OP = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth = 2}>
+
+// Loops with several dots are not prefetched yet (see the TODO in
+// Prefetcher::initialize): both dots keep their full K and the loop still
+// lowers to LLVM.
+// CHECK-LABEL: tt.func @matmul_two_dots
+// CHECK-NOT:   triton_gpu.extract_slice
+// CHECK:       scf.for
+// CHECK:         tt.dot {{.*}} : tensor<128x32xf16, #{{.*}}> * tensor<32x128xf16, #{{.*}}>
+// CHECK:         tt.dot {{.*}} : tensor<128x32xf16, #{{.*}}> * tensor<32x128xf16, #{{.*}}>
+// CHECK-NOT:   triton_gpu.extract_slice
+// CHECK:         scf.yield
+
+// LLVM-LABEL: llvm.func @matmul_two_dots
+// LLVM:         mma.sync.aligned.m16n8k16.row.col.f32.f16.f16.f32
+// LLVM:         llvm.return
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+tt.func @matmul_two_dots(%lb : index, %ub : index, %step : index, %A : !tt.ptr<f16>, %B : !tt.ptr<f16>, %X : !tt.ptr<f16>, %Y : !tt.ptr<f16>, %C : !tt.ptr<f32>) {
+  %a_ptr_init = tt.splat %A : (!tt.ptr<f16>) -> tensor<128x32x!tt.ptr<f16>, #AL>
+  %b_ptr_init = tt.splat %B : (!tt.ptr<f16>) -> tensor<32x128x!tt.ptr<f16>, #BL>
+  %x_ptr_init = tt.splat %X : (!tt.ptr<f16>) -> tensor<128x32x!tt.ptr<f16>, #AL>
+  %y_ptr_init = tt.splat %Y : (!tt.ptr<f16>) -> tensor<32x128x!tt.ptr<f16>, #BL>
+  %c_ptr = tt.splat %C : (!tt.ptr<f32>) -> tensor<128x128x!tt.ptr<f32>, #C>
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_off = arith.constant dense<4> : tensor<128x32xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<32x128xi32, #BL>
+
+  %a_ = tt.load %a_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #AL>
+  %a_init = triton_gpu.convert_layout %a_ : (tensor<128x32xf16, #AL>) -> tensor<128x32xf16, #A>
+  %b_ = tt.load %b_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf16, #BL>
+  %b_init = triton_gpu.convert_layout %b_ : (tensor<32x128xf16, #BL>) -> tensor<32x128xf16, #B>
+  %x_ = tt.load %x_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #AL>
+  %x_init = triton_gpu.convert_layout %x_ : (tensor<128x32xf16, #AL>) -> tensor<128x32xf16, #A>
+  %y_ = tt.load %y_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf16, #BL>
+  %y_init = triton_gpu.convert_layout %y_ : (tensor<32x128xf16, #BL>) -> tensor<32x128xf16, #B>
+
+  %loop:10 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %x_ptr = %x_ptr_init, %y_ptr = %y_ptr_init, %a = %a_init, %b = %b_init, %x = %x_init, %y = %y_init, %prev_c = %c_init, %prev_d = %c_init) -> (tensor<128x32x!tt.ptr<f16>, #AL>, tensor<32x128x!tt.ptr<f16>, #BL>, tensor<128x32x!tt.ptr<f16>, #AL>, tensor<32x128x!tt.ptr<f16>, #BL>, tensor<128x32xf16, #A>, tensor<32x128xf16, #B>, tensor<128x32xf16, #A>, tensor<32x128xf16, #B>, tensor<128x128xf32, #C>, tensor<128x128xf32, #C>) {
+    %a_op = triton_gpu.convert_layout %a : (tensor<128x32xf16, #A>) -> tensor<128x32xf16, #A_OP>
+    %b_op = triton_gpu.convert_layout %b : (tensor<32x128xf16, #B>) -> tensor<32x128xf16, #B_OP>
+    %c = tt.dot %a_op, %b_op, %prev_c {allowTF32 = true, transA = false, transB = false} : tensor<128x32xf16, #A_OP> * tensor<32x128xf16, #B_OP> -> tensor<128x128xf32, #C>
+    %x_op = triton_gpu.convert_layout %x : (tensor<128x32xf16, #A>) -> tensor<128x32xf16, #A_OP>
+    %y_op = triton_gpu.convert_layout %y : (tensor<32x128xf16, #B>) -> tensor<32x128xf16, #B_OP>
+    %d = tt.dot %x_op, %y_op, %prev_d {allowTF32 = true, transA = false, transB = false} : tensor<128x32xf16, #A_OP> * tensor<32x128xf16, #B_OP> -> tensor<128x128xf32, #C>
+
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x32x!tt.ptr<f16>, #AL>, tensor<128x32xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<32x128x!tt.ptr<f16>, #BL>, tensor<32x128xi32, #BL>
+    %next_x_ptr = tt.addptr %x_ptr, %a_off : tensor<128x32x!tt.ptr<f16>, #AL>, tensor<128x32xi32, #AL>
+    %next_y_ptr = tt.addptr %y_ptr, %b_off : tensor<32x128x!tt.ptr<f16>, #BL>, tensor<32x128xi32, #BL>
+    %next_a_ = tt.load %next_a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #AL>
+    %next_a = triton_gpu.convert_layout %next_a_ : (tensor<128x32xf16, #AL>) -> tensor<128x32xf16, #A>
+    %next_b_ = tt.load %next_b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf16, #BL>
+    %next_b = triton_gpu.convert_layout %next_b_ : (tensor<32x128xf16, #BL>) -> tensor<32x128xf16, #B>
+    %next_x_ = tt.load %next_x_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #AL>
+    %next_x = triton_gpu.convert_layout %next_x_ : (tensor<128x32xf16, #AL>) -> tensor<128x32xf16, #A>
+    %next_y_ = tt.load %next_y_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf16, #BL>
+    %next_y = triton_gpu.convert_layout %next_y_ : (tensor<32x128xf16, #BL>) -> tensor<32x128xf16, #B>
+
+    scf.yield %next_a_ptr, %next_b_ptr, %next_x_ptr, %next_y_ptr, %next_a, %next_b, %next_x, %next_y, %c, %d : tensor<128x32x!tt.ptr<f16>, #AL>, tensor<32x128x!tt.ptr<f16>, #BL>, tensor<128x32x!tt.ptr<f16>, #AL>, tensor<32x128x!tt.ptr<f16>, #BL>, tensor<128x32xf16, #A>, tensor<32x128xf16, #B>, tensor<128x32xf16, #A>, tensor<32x128xf16, #B>, tensor<128x128xf32, #C>, tensor<128x128xf32, #C>
+  }
+  %sum = arith.addf %loop#8, %loop#9 : tensor<128x128xf32, #C>
+  tt.store %c_ptr, %sum : tensor<128x128xf32, #C>
+  tt.return
+}
+}
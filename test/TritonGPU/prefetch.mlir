@@ -66,3 +66,259 @@ tt.func @matmul_loop_mixed(%lb : index, %ub : index, %step : index, %A : !tt.ptr
   }
   tt.return %loop#4 : tensor<128x128xf32, #C>
 }
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#B = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#C = #triton_gpu.mma<{version = 2, warpsPerCTA = [4, 1]}>
+#A_OP = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth = 2}>
+#B_OP = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth = 2}>
+
+// f16 with K = 32: one k16 slice in flight
+// CHECK-LABEL: tt.func @matmul_f16_k32
+// CHECK:     scf.for {{.*}} iter_args({{[^,]+}}, {{[^,]+}}, %[[ARG_A:[^ ]+]] = %{{[^,)]+}}, %[[ARG_B:[^ ]+]] = %{{[^,)]+}}, {{[^,]+}}, %[[A0:[^ ]+]] = %{{[^,)]+}}, %[[B0:[^ ]+]] = %{{[^,)]+}})
+// CHECK-DAG:   triton_gpu.extract_slice %[[ARG_A]][0, 16] [128, 16]
+// CHECK-DAG:   triton_gpu.extract_slice %[[ARG_B]][16, 0] [16, 128]
+// CHECK:       %[[D0:.*]] = tt.dot %[[A0]], %[[B0]]
+// CHECK:       tt.dot {{.*}}, {{.*}}, %[[D0]]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 0] [128, 16]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 0] [16, 128]
+// CHECK:     scf.yield
+tt.func @matmul_f16_k32(%lb : index, %ub : index, %step : index, %A : !tt.ptr<f16>, %B : !tt.ptr<f16>) -> tensor<128x128xf32, #C>{
+  %a_ptr_init = tt.broadcast %A : (!tt.ptr<f16>) -> tensor<128x32x!tt.ptr<f16>, #AL>
+  %b_ptr_init = tt.broadcast %B : (!tt.ptr<f16>) -> tensor<32x128x!tt.ptr<f16>, #BL>
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_off = arith.constant dense<4> : tensor<128x32xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<32x128xi32, #BL>
+
+  %a_ = tt.load %a_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #AL>
+  %a_init = triton_gpu.convert_layout %a_ : (tensor<128x32xf16, #AL>) -> tensor<128x32xf16, #A>
+  %b_ = tt.load %b_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf16, #BL>
+  %b_init = triton_gpu.convert_layout %b_ : (tensor<32x128xf16, #BL>) -> tensor<32x128xf16, #B>
+
+  %loop:5 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %a = %a_init, %b = %b_init, %prev_c = %c_init) -> (tensor<128x32x!tt.ptr<f16>, #AL>, tensor<32x128x!tt.ptr<f16>, #BL>, tensor<128x32xf16, #A>, tensor<32x128xf16, #B>, tensor<128x128xf32, #C>) {
+    %a_op = triton_gpu.convert_layout %a : (tensor<128x32xf16, #A>) -> tensor<128x32xf16, #A_OP>
+    %b_op = triton_gpu.convert_layout %b : (tensor<32x128xf16, #B>) -> tensor<32x128xf16, #B_OP>
+    %c = tt.dot %a_op, %b_op, %prev_c {allowTF32 = true, transA = false, transB = false} : tensor<128x32xf16, #A_OP> * tensor<32x128xf16, #B_OP> -> tensor<128x128xf32, #C>
+
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x32x!tt.ptr<f16>, #AL>, tensor<128x32xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<32x128x!tt.ptr<f16>, #BL>, tensor<32x128xi32, #BL>
+    %next_a_ = tt.load %next_a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #AL>
+    %next_a = triton_gpu.convert_layout %next_a_ : (tensor<128x32xf16, #AL>) -> tensor<128x32xf16, #A>
+    %next_b_ = tt.load %next_b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf16, #BL>
+    %next_b = triton_gpu.convert_layout %next_b_ : (tensor<32x128xf16, #BL>) -> tensor<32x128xf16, #B>
+
+    scf.yield %next_a_ptr, %next_b_ptr, %next_a, %next_b, %c : tensor<128x32x!tt.ptr<f16>, #AL>, tensor<32x128x!tt.ptr<f16>, #BL>, tensor<128x32xf16, #A>, tensor<32x128xf16, #B>, tensor<128x128xf32, #C>
+  }
+  tt.return %loop#4 : tensor<128x128xf32, #C>
+}
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#B = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#C = #triton_gpu.mma<{version = 2, warpsPerCTA = [4, 1]}>
+#A_OP = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth = 2}>
+#B_OP = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth = 2}>
+
+// bf16 with K = 64: two k16 slices in flight, slice 2 is converted before
+// the first dot
+// CHECK-LABEL: tt.func @matmul_bf16_k64
+// CHECK:     scf.for {{.*}} iter_args({{[^,]+}}, {{[^,]+}}, %[[ARG_A:[^ ]+]] = %{{[^,)]+}}, %[[ARG_B:[^ ]+]] = %{{[^,)]+}}, {{[^,]+}}, %[[A0:[^ ]+]] = %{{[^,)]+}}, %[[B0:[^ ]+]] = %{{[^,)]+}}, %[[A1:[^ ]+]] = %{{[^,)]+}}, %[[B1:[^ ]+]] = %{{[^,)]+}})
+// CHECK-DAG:   %[[A2_SMEM:.*]] = triton_gpu.extract_slice %[[ARG_A]][0, 32] [128, 16]
+// CHECK-DAG:   %[[A2:.*]] = triton_gpu.convert_layout %[[A2_SMEM]]
+// CHECK-DAG:   %[[B2_SMEM:.*]] = triton_gpu.extract_slice %[[ARG_B]][32, 0] [16, 128]
+// CHECK-DAG:   %[[B2:.*]] = triton_gpu.convert_layout %[[B2_SMEM]]
+// CHECK:       %[[D0:.*]] = tt.dot %[[A0]], %[[B0]]
+// CHECK:       %[[D1:.*]] = tt.dot %[[A1]], %[[B1]], %[[D0]]
+// CHECK:       tt.dot %[[A2]], %[[B2]], %[[D1]]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 0] [128, 16]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 16] [128, 16]
+// CHECK:     scf.yield
+tt.func @matmul_bf16_k64(%lb : index, %ub : index, %step : index, %A : !tt.ptr<bf16>, %B : !tt.ptr<bf16>) -> tensor<128x128xf32, #C>{
+  %a_ptr_init = tt.broadcast %A : (!tt.ptr<bf16>) -> tensor<128x64x!tt.ptr<bf16>, #AL>
+  %b_ptr_init = tt.broadcast %B : (!tt.ptr<bf16>) -> tensor<64x128x!tt.ptr<bf16>, #BL>
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_off = arith.constant dense<4> : tensor<128x64xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<64x128xi32, #BL>
+
+  %a_ = tt.load %a_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x64xbf16, #AL>
+  %a_init = triton_gpu.convert_layout %a_ : (tensor<128x64xbf16, #AL>) -> tensor<128x64xbf16, #A>
+  %b_ = tt.load %b_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x128xbf16, #BL>
+  %b_init = triton_gpu.convert_layout %b_ : (tensor<64x128xbf16, #BL>) -> tensor<64x128xbf16, #B>
+
+  %loop:5 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %a = %a_init, %b = %b_init, %prev_c = %c_init) -> (tensor<128x64x!tt.ptr<bf16>, #AL>, tensor<64x128x!tt.ptr<bf16>, #BL>, tensor<128x64xbf16, #A>, tensor<64x128xbf16, #B>, tensor<128x128xf32, #C>) {
+    %a_op = triton_gpu.convert_layout %a : (tensor<128x64xbf16, #A>) -> tensor<128x64xbf16, #A_OP>
+    %b_op = triton_gpu.convert_layout %b : (tensor<64x128xbf16, #B>) -> tensor<64x128xbf16, #B_OP>
+    %c = tt.dot %a_op, %b_op, %prev_c {allowTF32 = true, transA = false, transB = false} : tensor<128x64xbf16, #A_OP> * tensor<64x128xbf16, #B_OP> -> tensor<128x128xf32, #C>
+
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x64x!tt.ptr<bf16>, #AL>, tensor<128x64xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<64x128x!tt.ptr<bf16>, #BL>, tensor<64x128xi32, #BL>
+    %next_a_ = tt.load %next_a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x64xbf16, #AL>
+    %next_a = triton_gpu.convert_layout %next_a_ : (tensor<128x64xbf16, #AL>) -> tensor<128x64xbf16, #A>
+    %next_b_ = tt.load %next_b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x128xbf16, #BL>
+    %next_b = triton_gpu.convert_layout %next_b_ : (tensor<64x128xbf16, #BL>) -> tensor<64x128xbf16, #B>
+
+    scf.yield %next_a_ptr, %next_b_ptr, %next_a, %next_b, %c : tensor<128x64x!tt.ptr<bf16>, #AL>, tensor<64x128x!tt.ptr<bf16>, #BL>, tensor<128x64xbf16, #A>, tensor<64x128xbf16, #B>, tensor<128x128xf32, #C>
+  }
+  tt.return %loop#4 : tensor<128x128xf32, #C>
+}
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#B = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#C = #triton_gpu.mma<{version = 2, warpsPerCTA = [4, 1]}>
+#A_OP = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth = 1}>
+#B_OP = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth = 1}>
+
+// tf32 with K = 32: two k8 slices in flight
+// CHECK-LABEL: tt.func @matmul_tf32_k32
+// CHECK:     scf.for {{.*}} iter_args({{[^,]+}}, {{[^,]+}}, %[[ARG_A:[^ ]+]] = %{{[^,)]+}}, %[[ARG_B:[^ ]+]] = %{{[^,)]+}}, {{[^,]+}}, %[[A0:[^ ]+]] = %{{[^,)]+}}, %[[B0:[^ ]+]] = %{{[^,)]+}}, %[[A1:[^ ]+]] = %{{[^,)]+}}, %[[B1:[^ ]+]] = %{{[^,)]+}})
+// CHECK-DAG:   %[[A2_SMEM:.*]] = triton_gpu.extract_slice %[[ARG_A]][0, 16] [128, 8]
+// CHECK-DAG:   %[[A2:.*]] = triton_gpu.convert_layout %[[A2_SMEM]]
+// CHECK-DAG:   %[[B2_SMEM:.*]] = triton_gpu.extract_slice %[[ARG_B]][16, 0] [8, 128]
+// CHECK-DAG:   %[[B2:.*]] = triton_gpu.convert_layout %[[B2_SMEM]]
+// CHECK:       %[[D0:.*]] = tt.dot %[[A0]], %[[B0]]
+// CHECK:       %[[D1:.*]] = tt.dot %[[A1]], %[[B1]], %[[D0]]
+// CHECK:       tt.dot %[[A2]], %[[B2]], %[[D1]]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 0] [128, 8]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 8] [128, 8]
+// CHECK:     scf.yield
+tt.func @matmul_tf32_k32(%lb : index, %ub : index, %step : index, %A : !tt.ptr<f32>, %B : !tt.ptr<f32>) -> tensor<128x128xf32, #C>{
+  %a_ptr_init = tt.broadcast %A : (!tt.ptr<f32>) -> tensor<128x32x!tt.ptr<f32>, #AL>
+  %b_ptr_init = tt.broadcast %B : (!tt.ptr<f32>) -> tensor<32x128x!tt.ptr<f32>, #BL>
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_off = arith.constant dense<4> : tensor<128x32xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<32x128xi32, #BL>
+
+  %a_ = tt.load %a_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf32, #AL>
+  %a_init = triton_gpu.convert_layout %a_ : (tensor<128x32xf32, #AL>) -> tensor<128x32xf32, #A>
+  %b_ = tt.load %b_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf32, #BL>
+  %b_init = triton_gpu.convert_layout %b_ : (tensor<32x128xf32, #BL>) -> tensor<32x128xf32, #B>
+
+  %loop:5 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %a = %a_init, %b = %b_init, %prev_c = %c_init) -> (tensor<128x32x!tt.ptr<f32>, #AL>, tensor<32x128x!tt.ptr<f32>, #BL>, tensor<128x32xf32, #A>, tensor<32x128xf32, #B>, tensor<128x128xf32, #C>) {
+    %a_op = triton_gpu.convert_layout %a : (tensor<128x32xf32, #A>) -> tensor<128x32xf32, #A_OP>
+    %b_op = triton_gpu.convert_layout %b : (tensor<32x128xf32, #B>) -> tensor<32x128xf32, #B_OP>
+    %c = tt.dot %a_op, %b_op, %prev_c {allowTF32 = true, transA = false, transB = false} : tensor<128x32xf32, #A_OP> * tensor<32x128xf32, #B_OP> -> tensor<128x128xf32, #C>
+
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x32x!tt.ptr<f32>, #AL>, tensor<128x32xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<32x128x!tt.ptr<f32>, #BL>, tensor<32x128xi32, #BL>
+    %next_a_ = tt.load %next_a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf32, #AL>
+    %next_a = triton_gpu.convert_layout %next_a_ : (tensor<128x32xf32, #AL>) -> tensor<128x32xf32, #A>
+    %next_b_ = tt.load %next_b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x128xf32, #BL>
+    %next_b = triton_gpu.convert_layout %next_b_ : (tensor<32x128xf32, #BL>) -> tensor<32x128xf32, #B>
+
+    scf.yield %next_a_ptr, %next_b_ptr, %next_a, %next_b, %c : tensor<128x32x!tt.ptr<f32>, #AL>, tensor<32x128x!tt.ptr<f32>, #BL>, tensor<128x32xf32, #A>, tensor<32x128xf32, #B>, tensor<128x128xf32, #C>
+  }
+  tt.return %loop#4 : tensor<128x128xf32, #C>
+}
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#B = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#C = #triton_gpu.mma<{version = 2, warpsPerCTA = [4, 1]}>
+#A_OP = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth = 4}>
+#B_OP = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth = 4}>
+
+// int8 with K = 64: one k32 slice in flight
+// CHECK-LABEL: tt.func @matmul_i8_k64
+// CHECK:     scf.for {{.*}} iter_args({{[^,]+}}, {{[^,]+}}, %[[ARG_A:[^ ]+]] = %{{[^,)]+}}, %[[ARG_B:[^ ]+]] = %{{[^,)]+}}, {{[^,]+}}, %[[A0:[^ ]+]] = %{{[^,)]+}}, %[[B0:[^ ]+]] = %{{[^,)]+}})
+// CHECK-DAG:   triton_gpu.extract_slice %[[ARG_A]][0, 32] [128, 32]
+// CHECK-DAG:   triton_gpu.extract_slice %[[ARG_B]][32, 0] [32, 128]
+// CHECK:       %[[D0:.*]] = tt.dot %[[A0]], %[[B0]]
+// CHECK:       tt.dot {{.*}}, {{.*}}, %[[D0]]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 0] [128, 32]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 0] [32, 128]
+// CHECK:     scf.yield
+tt.func @matmul_i8_k64(%lb : index, %ub : index, %step : index, %A : !tt.ptr<i8>, %B : !tt.ptr<i8>) -> tensor<128x128xi32, #C>{
+  %a_ptr_init = tt.broadcast %A : (!tt.ptr<i8>) -> tensor<128x64x!tt.ptr<i8>, #AL>
+  %b_ptr_init = tt.broadcast %B : (!tt.ptr<i8>) -> tensor<64x128x!tt.ptr<i8>, #BL>
+  %c_init = arith.constant dense<0> : tensor<128x128xi32, #C>
+  %a_off = arith.constant dense<4> : tensor<128x64xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<64x128xi32, #BL>
+
+  %a_ = tt.load %a_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x64xi8, #AL>
+  %a_init = triton_gpu.convert_layout %a_ : (tensor<128x64xi8, #AL>) -> tensor<128x64xi8, #A>
+  %b_ = tt.load %b_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x128xi8, #BL>
+  %b_init = triton_gpu.convert_layout %b_ : (tensor<64x128xi8, #BL>) -> tensor<64x128xi8, #B>
+
+  %loop:5 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %a = %a_init, %b = %b_init, %prev_c = %c_init) -> (tensor<128x64x!tt.ptr<i8>, #AL>, tensor<64x128x!tt.ptr<i8>, #BL>, tensor<128x64xi8, #A>, tensor<64x128xi8, #B>, tensor<128x128xi32, #C>) {
+    %a_op = triton_gpu.convert_layout %a : (tensor<128x64xi8, #A>) -> tensor<128x64xi8, #A_OP>
+    %b_op = triton_gpu.convert_layout %b : (tensor<64x128xi8, #B>) -> tensor<64x128xi8, #B_OP>
+    %c = tt.dot %a_op, %b_op, %prev_c {allowTF32 = true, transA = false, transB = false} : tensor<128x64xi8, #A_OP> * tensor<64x128xi8, #B_OP> -> tensor<128x128xi32, #C>
+
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x64x!tt.ptr<i8>, #AL>, tensor<128x64xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<64x128x!tt.ptr<i8>, #BL>, tensor<64x128xi32, #BL>
+    %next_a_ = tt.load %next_a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x64xi8, #AL>
+    %next_a = triton_gpu.convert_layout %next_a_ : (tensor<128x64xi8, #AL>) -> tensor<128x64xi8, #A>
+    %next_b_ = tt.load %next_b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x128xi8, #BL>
+    %next_b = triton_gpu.convert_layout %next_b_ : (tensor<64x128xi8, #BL>) -> tensor<64x128xi8, #B>
+
+    scf.yield %next_a_ptr, %next_b_ptr, %next_a, %next_b, %c : tensor<128x64x!tt.ptr<i8>, #AL>, tensor<64x128x!tt.ptr<i8>, #BL>, tensor<128x64xi8, #A>, tensor<64x128xi8, #B>, tensor<128x128xi32, #C>
+  }
+  tt.return %loop#4 : tensor<128x128xi32, #C>
+}
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#B = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+#C = #triton_gpu.mma<{version = 2, warpsPerCTA = [4, 1]}>
+#A_OP = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth = 2}>
+#B_OP = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth = 2}>
+
+// f16 with a 64x64 tile and K = 128: the slices are widened to k32 while
+// two of them still fit in the register budget
+// CHECK-LABEL: tt.func @matmul_f16_k128_small_tile
+// CHECK:     scf.for {{.*}} iter_args({{[^,]+}}, {{[^,]+}}, %[[ARG_A:[^ ]+]] = %{{[^,)]+}}, %[[ARG_B:[^ ]+]] = %{{[^,)]+}}, {{[^,]+}}, %[[A0:[^ ]+]] = %{{[^,)]+}}, %[[B0:[^ ]+]] = %{{[^,)]+}}, %[[A1:[^ ]+]] = %{{[^,)]+}}, %[[B1:[^ ]+]] = %{{[^,)]+}})
+// CHECK-DAG:   %[[A2_SMEM:.*]] = triton_gpu.extract_slice %[[ARG_A]][0, 64] [64, 32]
+// CHECK-DAG:   %[[A2:.*]] = triton_gpu.convert_layout %[[A2_SMEM]]
+// CHECK-DAG:   %[[B2_SMEM:.*]] = triton_gpu.extract_slice %[[ARG_B]][64, 0] [32, 64]
+// CHECK-DAG:   %[[B2:.*]] = triton_gpu.convert_layout %[[B2_SMEM]]
+// CHECK:       %[[D0:.*]] = tt.dot %[[A0]], %[[B0]]
+// CHECK:       %[[D1:.*]] = tt.dot %[[A1]], %[[B1]], %[[D0]]
+// CHECK:       tt.dot %[[A2]], %[[B2]], %[[D1]]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 0] [64, 32]
+// CHECK-DAG:   triton_gpu.extract_slice {{.*}}[0, 32] [64, 32]
+// CHECK:     scf.yield
+tt.func @matmul_f16_k128_small_tile(%lb : index, %ub : index, %step : index, %A : !tt.ptr<f16>, %B : !tt.ptr<f16>) -> tensor<64x64xf32, #C>{
+  %a_ptr_init = tt.broadcast %A : (!tt.ptr<f16>) -> tensor<64x128x!tt.ptr<f16>, #AL>
+  %b_ptr_init = tt.broadcast %B : (!tt.ptr<f16>) -> tensor<128x64x!tt.ptr<f16>, #BL>
+  %c_init = arith.constant dense<0.00e+00> : tensor<64x64xf32, #C>
+  %a_off = arith.constant dense<4> : tensor<64x128xi32, #AL>
+  %b_off = arith.constant dense<4> : tensor<128x64xi32, #BL>
+
+  %a_ = tt.load %a_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x128xf16, #AL>
+  %a_init = triton_gpu.convert_layout %a_ : (tensor<64x128xf16, #AL>) -> tensor<64x128xf16, #A>
+  %b_ = tt.load %b_ptr_init {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x64xf16, #BL>
+  %b_init = triton_gpu.convert_layout %b_ : (tensor<128x64xf16, #BL>) -> tensor<128x64xf16, #B>
+
+  %loop:5 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %a = %a_init, %b = %b_init, %prev_c = %c_init) -> (tensor<64x128x!tt.ptr<f16>, #AL>, tensor<128x64x!tt.ptr<f16>, #BL>, tensor<64x128xf16, #A>, tensor<128x64xf16, #B>, tensor<64x64xf32, #C>) {
+    %a_op = triton_gpu.convert_layout %a : (tensor<64x128xf16, #A>) -> tensor<64x128xf16, #A_OP>
+    %b_op = triton_gpu.convert_layout %b : (tensor<128x64xf16, #B>) -> tensor<128x64xf16, #B_OP>
+    %c = tt.dot %a_op, %b_op, %prev_c {allowTF32 = true, transA = false, transB = false} : tensor<64x128xf16, #A_OP> * tensor<128x64xf16, #B_OP> -> tensor<64x64xf32, #C>
+
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<64x128x!tt.ptr<f16>, #AL>, tensor<64x128xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<128x64x!tt.ptr<f16>, #BL>, tensor<128x64xi32, #BL>
+    %next_a_ = tt.load %next_a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x128xf16, #AL>
+    %next_a = triton_gpu.convert_layout %next_a_ : (tensor<64x128xf16, #AL>) -> tensor<64x128xf16, #A>
+    %next_b_ = tt.load %next_b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x64xf16, #BL>
+    %next_b = triton_gpu.convert_layout %next_b_ : (tensor<128x64xf16, #BL>) -> tensor<128x64xf16, #B>
+
+    scf.yield %next_a_ptr, %next_b_ptr, %next_a, %next_b, %c : tensor<64x128x!tt.ptr<f16>, #AL>, tensor<128x64x!tt.ptr<f16>, #BL>, tensor<64x128xf16, #A>, tensor<128x64xf16, #B>, tensor<64x64xf32, #C>
+  }
+  tt.return %loop#4 : tensor<64x64xf32, #C>
+}
@@ -0,0 +1,156 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-rasterize | FileCheck %s
+
+// CHECK-LABEL: tt.func @grouped_row
+// CHECK-DAG: %[[X:.*]] = tt.get_program_id x
+// CHECK-DAG: %[[Y:.*]] = tt.get_program_id y
+// CHECK-DAG: %[[GRID_M:.*]] = tt.get_num_programs {axis = 0 : i32}
+// CHECK-DAG: %[[GRID_N:.*]] = tt.get_num_programs {axis = 1 : i32}
+// CHECK-DAG: %[[GROUP:.*]] = arith.constant 4 : i32
+// CHECK: %[[Y_OFF:.*]] = arith.muli %[[Y]], %[[GRID_M]]
+// CHECK: %[[LINEAR:.*]] = arith.addi %[[X]], %[[Y_OFF]]
+// CHECK: %[[BAND_TILES:.*]] = arith.muli %[[GROUP]], %[[GRID_N]]
+// CHECK: %[[BAND:.*]] = arith.divui %[[LINEAR]], %[[BAND_TILES]]
+// CHECK: %[[FIRST_ROW:.*]] = arith.muli %[[BAND]], %[[GROUP]]
+// CHECK: %[[LEFT:.*]] = arith.subi %[[GRID_M]], %[[FIRST_ROW]]
+// CHECK: %[[ROWS:.*]] = arith.minui %[[LEFT]], %[[GROUP]]
+// CHECK: %[[LOCAL:.*]] = arith.remui %[[LINEAR]], %[[BAND_TILES]]
+// CHECK: %[[DROW:.*]] = arith.remui %[[LOCAL]], %[[ROWS]]
+// CHECK: %[[ROW:.*]] = arith.addi %[[FIRST_ROW]], %[[DROW]]
+// CHECK: %[[COL:.*]] = arith.divui %[[LOCAL]], %[[ROWS]]
+// CHECK: arith.muli %[[ROW]]
+// CHECK: arith.muli %[[COL]]
+module attributes {"triton_gpu.rasterization" = "grouped-row", "triton_gpu.rasterization-group" = 4 : i32} {
+tt.func @grouped_row(%arg0: !tt.ptr<i32>) {
+  %c64_i32 = arith.constant 64 : i32
+  %0 = tt.get_program_id x : i32
+  %1 = tt.get_program_id y : i32
+  %2 = arith.muli %0, %c64_i32 : i32
+  %3 = arith.muli %1, %c64_i32 : i32
+  %4 = arith.addi %2, %3 : i32
+  tt.store %arg0, %4 : i32
+  tt.return
+}
+}
+
+// -----
+
+// Z-order within 2x2 squares: the row takes the even bits of the index in
+// the square and the column the odd bits.
+// CHECK-LABEL: tt.func @morton
+// CHECK: %[[LOCAL:.*]] = arith.remui %[[LINEAR:.*]], %[[BAND_TILES:.*]]
+// CHECK: %[[ROW:.*]] = arith.addi
+// CHECK: %[[COL:.*]] = arith.divui %[[LOCAL]]
+// CHECK: %[[FULL:.*]] = arith.cmpi eq
+// CHECK: %[[BEFORE_TAIL:.*]] = arith.cmpi ult, %[[LOCAL]]
+// CHECK: %[[IN_SQUARE:.*]] = arith.andi %[[FULL]], %[[BEFORE_TAIL]]
+// CHECK: %[[WITHIN:.*]] = arith.remui %[[LOCAL]]
+// CHECK: arith.shrui %[[WITHIN]]
+// CHECK: arith.shrui %[[WITHIN]]
+// CHECK: %[[NEW_ROW:.*]] = arith.select %[[IN_SQUARE]], %{{.*}}, %[[ROW]]
+// CHECK: %[[NEW_COL:.*]] = arith.select %[[IN_SQUARE]], %{{.*}}, %[[COL]]
+// CHECK: arith.addi %[[NEW_ROW]], %[[NEW_COL]]
+module attributes {"triton_gpu.rasterization" = "morton", "triton_gpu.rasterization-group" = 2 : i32} {
+tt.func @morton(%arg0: !tt.ptr<i32>) {
+  %0 = tt.get_program_id x : i32
+  %1 = tt.get_program_id y : i32
+  %2 = arith.addi %0, %1 : i32
+  tt.store %arg0, %2 : i32
+  tt.return
+}
+}
+
+// -----
+
+// Hilbert order within 2x2 squares: one rotation step.
+// CHECK-LABEL: tt.func @hilbert
+// CHECK: %[[IN_SQUARE:.*]] = arith.andi
+// CHECK: %[[WITHIN:.*]] = arith.remui
+// CHECK: arith.xori %[[WITHIN]]
+// CHECK: arith.andi
+// CHECK: %[[FLIP:.*]] = arith.andi
+// CHECK: arith.select %[[FLIP]]
+// CHECK: arith.select %[[FLIP]]
+// CHECK: %[[NEW_ROW:.*]] = arith.select %[[IN_SQUARE]]
+// CHECK: %[[NEW_COL:.*]] = arith.select %[[IN_SQUARE]]
+// CHECK: arith.addi %[[NEW_ROW]], %[[NEW_COL]]
+module attributes {"triton_gpu.rasterization" = "hilbert", "triton_gpu.rasterization-group" = 2 : i32} {
+tt.func @hilbert(%arg0: !tt.ptr<i32>) {
+  %0 = tt.get_program_id x : i32
+  %1 = tt.get_program_id y : i32
+  %2 = arith.addi %0, %1 : i32
+  tt.store %arg0, %2 : i32
+  tt.return
+}
+}
+
+// -----
+
+// Without the module attribute, program ids are left alone.
+// CHECK-LABEL: tt.func @disabled
+// CHECK-NOT: tt.get_num_programs
+// CHECK: %[[X:.*]] = tt.get_program_id x
+// CHECK: %[[Y:.*]] = tt.get_program_id y
+// CHECK: arith.addi %[[X]], %[[Y]]
+module {
+tt.func @disabled(%arg0: !tt.ptr<i32>) {
+  %0 = tt.get_program_id x : i32
+  %1 = tt.get_program_id y : i32
+  %2 = arith.addi %0, %1 : i32
+  tt.store %arg0, %2 : i32
+  tt.return
+}
+}
+
+// -----
+
+// On a 1D grid the program id is the linear id, the columns come from the
+// attribute and the remapped tile is folded back into a row-major id.
+// CHECK-LABEL: tt.func @grouped_row_1d
+// CHECK-DAG: %[[X:.*]] = tt.get_program_id x
+// CHECK-DAG: %[[PROGRAMS:.*]] = tt.get_num_programs {axis = 0 : i32}
+// CHECK-DAG: %[[BLOCK:.*]] = arith.constant 64 : i32
+// CHECK-DAG: %[[BLOCK_M1:.*]] = arith.constant 63 : i32
+// CHECK: %[[PADDED:.*]] = arith.addi %arg1, %[[BLOCK_M1]]
+// CHECK: %[[GRID_N:.*]] = arith.divui %[[PADDED]], %[[BLOCK]]
+// CHECK: %[[GRID_M:.*]] = arith.divui %[[PROGRAMS]], %[[GRID_N]]
+// CHECK: %[[BAND_TILES:.*]] = arith.muli %{{.*}}, %[[GRID_N]]
+// CHECK: %[[BAND:.*]] = arith.divui %[[X]], %[[BAND_TILES]]
+// CHECK: %[[FIRST_ROW:.*]] = arith.muli %[[BAND]]
+// CHECK: arith.subi %[[GRID_M]], %[[FIRST_ROW]]
+// CHECK: %[[LOCAL:.*]] = arith.remui %[[X]], %[[BAND_TILES]]
+// CHECK: %[[ROW:.*]] = arith.addi %[[FIRST_ROW]]
+// CHECK: %[[COL:.*]] = arith.divui %[[LOCAL]]
+// CHECK: %[[ROW_OFF:.*]] = arith.muli %[[ROW]], %[[GRID_N]]
+// CHECK: %[[PID:.*]] = arith.addi %[[ROW_OFF]], %[[COL]]
+// CHECK: arith.divsi %[[PID]]
+// CHECK: arith.remsi %[[PID]]
+module attributes {"triton_gpu.rasterization" = "grouped-row", "triton_gpu.rasterization-group" = 4 : i32} {
+tt.func @grouped_row_1d(%arg0: !tt.ptr<i32>, %arg1: i32) attributes {"triton_gpu.rasterization-columns" = array<i32: 1, 64>} {
+  %c63_i32 = arith.constant 63 : i32
+  %c64_i32 = arith.constant 64 : i32
+  %0 = tt.get_program_id x : i32
+  %1 = arith.addi %arg1, %c63_i32 : i32
+  %2 = arith.divsi %1, %c64_i32 : i32
+  %3 = arith.divsi %0, %2 : i32
+  %4 = arith.remsi %0, %2 : i32
+  %5 = arith.addi %3, %4 : i32
+  tt.store %arg0, %5 : i32
+  tt.return
+}
+}
+
+// -----
+
+// Without the columns attribute, a 1D program id is left alone.
+// CHECK-LABEL: tt.func @linear_without_columns
+// CHECK-NOT: tt.get_num_programs
+// CHECK: %[[X:.*]] = tt.get_program_id x
+// CHECK: arith.divsi %[[X]]
+module attributes {"triton_gpu.rasterization" = "grouped-row"} {
+tt.func @linear_without_columns(%arg0: !tt.ptr<i32>, %arg1: i32) {
+  %0 = tt.get_program_id x : i32
+  %1 = arith.divsi %0, %arg1 : i32
+  tt.store %arg0, %1 : i32
+  tt.return
+}
+}
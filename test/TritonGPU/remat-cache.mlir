@@ -0,0 +1,95 @@
+// RUN: triton-opt %s -tritongpu-remove-layout-conversions | FileCheck %s
+// RUN: triton-opt %s -tritongpu-remove-layout-conversions -mlir-pass-statistics -o /dev/null 2>&1 | FileCheck %s --check-prefix=STATS
+
+// Deep elementwise chain between two conversions: every rematerialization
+// query walks the whole chain, so most of them are answered by the cache.
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+#blocked2 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked3 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [32, 1], warpsPerCTA = [4, 1], order = [0, 1]}>
+#slice2 = #triton_gpu.slice<{dim = 1, parent = #blocked2}>
+#slice3 = #triton_gpu.slice<{dim = 1, parent = #blocked3}>
+
+// STATS-DAG: (S) {{[1-9][0-9]*}} num-remat-cache-hits
+
+module attributes {"triton_gpu.num-warps" = 4 : i32} {
+
+// CHECK-LABEL: deep_chain
+tt.func @deep_chain(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+  %0 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<1024x!tt.ptr<f32>, #blocked1>
+  %1 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked1>
+  %2 = tt.addptr %0, %1 : tensor<1024x!tt.ptr<f32>, #blocked1>, tensor<1024xi32, #blocked1>
+  %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<1024xf32, #blocked1>
+  %4 = triton_gpu.convert_layout %3 : (tensor<1024xf32, #blocked1>) -> tensor<1024xf32, #blocked0>
+  %5 = arith.mulf %4, %4 : tensor<1024xf32, #blocked0>
+  %6 = arith.addf %5, %5 : tensor<1024xf32, #blocked0>
+  %7 = arith.mulf %6, %6 : tensor<1024xf32, #blocked0>
+  %8 = arith.addf %7, %7 : tensor<1024xf32, #blocked0>
+  %9 = arith.mulf %8, %8 : tensor<1024xf32, #blocked0>
+  %10 = arith.addf %9, %9 : tensor<1024xf32, #blocked0>
+  %11 = arith.mulf %10, %10 : tensor<1024xf32, #blocked0>
+  %12 = arith.addf %11, %11 : tensor<1024xf32, #blocked0>
+  %13 = arith.mulf %12, %12 : tensor<1024xf32, #blocked0>
+  %14 = arith.addf %13, %13 : tensor<1024xf32, #blocked0>
+  %15 = arith.mulf %14, %14 : tensor<1024xf32, #blocked0>
+  %16 = arith.addf %15, %15 : tensor<1024xf32, #blocked0>
+  %17 = arith.mulf %16, %16 : tensor<1024xf32, #blocked0>
+  %18 = arith.addf %17, %17 : tensor<1024xf32, #blocked0>
+  %19 = arith.mulf %18, %18 : tensor<1024xf32, #blocked0>
+  %20 = arith.addf %19, %19 : tensor<1024xf32, #blocked0>
+  %21 = arith.mulf %20, %20 : tensor<1024xf32, #blocked0>
+  %22 = arith.addf %21, %21 : tensor<1024xf32, #blocked0>
+  %23 = arith.mulf %22, %22 : tensor<1024xf32, #blocked0>
+  %24 = arith.addf %23, %23 : tensor<1024xf32, #blocked0>
+  %25 = arith.mulf %24, %24 : tensor<1024xf32, #blocked0>
+  %26 = arith.addf %25, %25 : tensor<1024xf32, #blocked0>
+  %27 = arith.mulf %26, %26 : tensor<1024xf32, #blocked0>
+  %28 = arith.addf %27, %27 : tensor<1024xf32, #blocked0>
+  %29 = arith.mulf %28, %28 : tensor<1024xf32, #blocked0>
+  %30 = arith.addf %29, %29 : tensor<1024xf32, #blocked0>
+  %31 = arith.mulf %30, %30 : tensor<1024xf32, #blocked0>
+  %32 = arith.addf %31, %31 : tensor<1024xf32, #blocked0>
+  %33 = arith.mulf %32, %32 : tensor<1024xf32, #blocked0>
+  %34 = arith.addf %33, %33 : tensor<1024xf32, #blocked0>
+  %35 = arith.mulf %34, %34 : tensor<1024xf32, #blocked0>
+  %36 = arith.addf %35, %35 : tensor<1024xf32, #blocked0>
+  %37 = triton_gpu.convert_layout %36 : (tensor<1024xf32, #blocked0>) -> tensor<1024xf32, #blocked1>
+  %38 = tt.splat %arg1 : (!tt.ptr<f32>) -> tensor<1024x!tt.ptr<f32>, #blocked1>
+  %39 = tt.addptr %38, %1 : tensor<1024x!tt.ptr<f32>, #blocked1>, tensor<1024xi32, #blocked1>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.store
+  tt.store %39, %37 : tensor<1024xf32, #blocked1>
+  tt.return
+}
+
+
+// Moving the conversion after the reduction updates the users of the reduction
+// in place. The simulations made before must not be reused, or the conversions
+// around the multiplication would be left in place.
+// CHECK-LABEL: reduce_then_remat
+tt.func @reduce_then_remat(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+  %0 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<32x32x!tt.ptr<f32>, #blocked2>
+  // CHECK: %[[LOAD:.*]] = tt.load
+  %1 = tt.load %0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x32xf32, #blocked2>
+  %2 = triton_gpu.convert_layout %1 : (tensor<32x32xf32, #blocked2>) -> tensor<32x32xf32, #blocked3>
+  // CHECK: "tt.reduce"(%[[LOAD]])
+  %3 = "tt.reduce"(%2) ({
+  ^bb0(%a: f32, %b: f32):
+    %s = arith.addf %a, %b : f32
+    tt.reduce.return %s : f32
+  }) {axis = 1 : i32} : (tensor<32x32xf32, #blocked3>) -> tensor<32xf32, #slice3>
+  %4 = arith.mulf %3, %3 : tensor<32xf32, #slice3>
+  %5 = triton_gpu.convert_layout %4 : (tensor<32xf32, #slice3>) -> tensor<32xf32, #slice2>
+  %6 = tt.splat %arg1 : (!tt.ptr<f32>) -> tensor<32x!tt.ptr<f32>, #slice2>
+  %7 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #slice2>
+  %8 = tt.addptr %6, %7 : tensor<32x!tt.ptr<f32>, #slice2>, tensor<32xi32, #slice2>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: arith.mulf
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.store
+  tt.store %8, %5 : tensor<32xf32, #slice2>
+  tt.return
+}
+
+}
@@ -0,0 +1,159 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-split-k=split-k=4 | FileCheck %s
+
+// CHECK: module attributes {"triton_gpu.split-k" = 4 : i32}
+// CHECK-LABEL: tt.func @matmul_kernel
+// CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+// CHECK-DAG: %[[C64:.*]] = arith.constant 64 : index
+// CHECK: %[[UB:.*]] = arith.index_cast %arg4
+// CHECK: %[[SPLIT:.*]] = tt.get_program_id z
+// CHECK: %[[C4:.*]] = arith.constant 4 : index
+// CHECK: %[[SPAN:.*]] = arith.subi %[[UB]], %[[C0]]
+// CHECK: %[[ITERS:.*]] = arith.ceildivsi %[[SPAN]], %[[C64]]
+// CHECK: %[[ITERS_PER_SPLIT:.*]] = arith.ceildivsi %[[ITERS]], %[[C4]]
+// CHECK: %[[SPLIT_IDX:.*]] = arith.index_cast %[[SPLIT]] : i32 to index
+// CHECK: %[[FIRST:.*]] = arith.muli %[[SPLIT_IDX]], %[[ITERS_PER_SPLIT]]
+// CHECK: %[[LB_OFF:.*]] = arith.muli %[[FIRST]], %[[C64]]
+// CHECK: %[[LB:.*]] = arith.addi %[[C0]], %[[LB_OFF]]
+// CHECK: %[[SPLIT_SPAN:.*]] = arith.muli %[[ITERS_PER_SPLIT]], %[[C64]]
+// CHECK: %[[END:.*]] = arith.addi %[[LB]], %[[SPLIT_SPAN]]
+// CHECK: %[[NEW_UB:.*]] = arith.minsi %[[UB]], %[[END]]
+// CHECK: %[[FIRST_I32:.*]] = arith.index_cast %[[FIRST]] : index to i32
+// CHECK: %[[K_A:.*]] = tt.splat %[[FIRST_I32]]
+// CHECK: %[[OFF_A:.*]] = arith.muli %[[A_STEP:.*]], %[[K_A]]
+// CHECK: %[[A_INIT:.*]] = tt.addptr %{{.*}}, %[[OFF_A]]
+// CHECK: %[[K_B:.*]] = tt.splat %[[FIRST_I32]]
+// CHECK: %[[OFF_B:.*]] = arith.muli %[[B_STEP:.*]], %[[K_B]]
+// CHECK: %[[B_INIT:.*]] = tt.addptr %{{.*}}, %[[OFF_B]]
+// CHECK: %[[IS_FIRST:.*]] = arith.cmpi eq, %[[SPLIT]]
+// CHECK: %[[ACC_INIT:.*]] = arith.select %[[IS_FIRST]]
+// CHECK: scf.for %{{.*}} = %[[LB]] to %[[NEW_UB]] step %[[C64]] iter_args(%{{.*}} = %[[ACC_INIT]], %{{.*}} = %[[A_INIT]], %{{.*}} = %[[B_INIT]])
+// CHECK: tt.dot
+// CHECK-NOT: tt.store
+// CHECK: "tt.atomic_rmw"(%{{.*}}, %{{.*}}) {atomic_rmw_op = 5 : i32, sem = 1 : i32}
+module {
+tt.func @matmul_kernel(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg2: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg3: tensor<64x64xi32>, %arg4: i32 {tt.divisibility = 16 : i32}) {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+  %a_step = arith.constant dense<64> : tensor<64x64xi32>
+  %b_step = arith.constant dense<4096> : tensor<64x64xi32>
+  %0 = tt.splat %arg0 : (!tt.ptr<f16>) -> tensor<64x64x!tt.ptr<f16>>
+  %1 = tt.addptr %0, %arg3 : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+  %2 = tt.splat %arg1 : (!tt.ptr<f16>) -> tensor<64x64x!tt.ptr<f16>>
+  %3 = tt.addptr %2, %arg3 : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+  %4 = arith.index_cast %arg4 : i32 to index
+  %5:3 = scf.for %arg5 = %c0 to %4 step %c64 iter_args(%arg6 = %cst, %arg7 = %1, %arg8 = %3) -> (tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>) {
+    %a = tt.load %arg7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %b = tt.load %arg8 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %c = tt.dot %a, %b, %arg6 {allowTF32 = true} : tensor<64x64xf16> * tensor<64x64xf16> -> tensor<64x64xf32>
+    %next_a = tt.addptr %arg7, %a_step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %next_b = tt.addptr %arg8, %b_step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    scf.yield %c, %next_a, %next_b : tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>
+  }
+  %6 = tt.splat %arg2 : (!tt.ptr<f32>) -> tensor<64x64x!tt.ptr<f32>>
+  %7 = tt.addptr %6, %arg3 : tensor<64x64x!tt.ptr<f32>>, tensor<64x64xi32>
+  tt.store %7, %5#0 : tensor<64x64xf32>
+  tt.return
+}
+}
+
+// -----
+
+// The epilogue is not linear in the accumulator: the loop is left alone.
+// CHECK-NOT: triton_gpu.split-k
+// CHECK-LABEL: tt.func @nonlinear_epilogue
+// CHECK-NOT: tt.get_program_id z
+// CHECK: tt.store
+module {
+tt.func @nonlinear_epilogue(%arg0: tensor<64x64x!tt.ptr<f16>>, %arg1: tensor<64x64x!tt.ptr<f16>>, %arg2: tensor<64x64x!tt.ptr<f16>>, %arg3: i32) {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+  %step = arith.constant dense<64> : tensor<64x64xi32>
+  %0 = arith.index_cast %arg3 : i32 to index
+  %1:3 = scf.for %arg4 = %c0 to %0 step %c64 iter_args(%arg5 = %cst, %arg6 = %arg0, %arg7 = %arg1) -> (tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>) {
+    %a = tt.load %arg6 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %b = tt.load %arg7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %c = tt.dot %a, %b, %arg5 {allowTF32 = true} : tensor<64x64xf16> * tensor<64x64xf16> -> tensor<64x64xf32>
+    %next_a = tt.addptr %arg6, %step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %next_b = tt.addptr %arg7, %step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    scf.yield %c, %next_a, %next_b : tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>
+  }
+  %2 = arith.truncf %1#0 : tensor<64x64xf32> to tensor<64x64xf16>
+  tt.store %arg2, %2 : tensor<64x64xf16>
+  tt.return
+}
+}
+
+// -----
+
+// i32 induction variable with a non-zero lower bound, and a scalar offset
+// carried by the loop: the range of iterations and the initial offset of each
+// program are derived from its z program id.
+// CHECK-LABEL: tt.func @index_k
+// CHECK: %[[SPLIT:.*]] = tt.get_program_id z
+// CHECK: %[[C4:.*]] = arith.constant 4 : i32
+// CHECK: %[[SPAN:.*]] = arith.subi %arg3, %[[C16:.*]] : i32
+// CHECK: %[[ITERS:.*]] = arith.ceildivsi %[[SPAN]], %[[C32:.*]] : i32
+// CHECK: %[[PER_SPLIT:.*]] = arith.ceildivsi %[[ITERS]], %[[C4]] : i32
+// CHECK: %[[FIRST:.*]] = arith.muli %[[SPLIT]], %[[PER_SPLIT]] : i32
+// CHECK: %[[LB_OFF:.*]] = arith.muli %[[FIRST]], %[[C32]] : i32
+// CHECK: %[[LB:.*]] = arith.addi %[[C16]], %[[LB_OFF]] : i32
+// CHECK: %[[SPLIT_SPAN:.*]] = arith.muli %[[PER_SPLIT]], %[[C32]] : i32
+// CHECK: %[[END:.*]] = arith.addi %[[LB]], %[[SPLIT_SPAN]] : i32
+// CHECK: %[[UB:.*]] = arith.minsi %arg3, %[[END]] : i32
+// CHECK: %[[K_B:.*]] = tt.splat %[[FIRST]] : (i32) -> tensor<64x64xi32>
+// CHECK: %[[OFF_B:.*]] = arith.muli %{{.*}}, %[[K_B]] : tensor<64x64xi32>
+// CHECK: %[[B_INIT:.*]] = tt.addptr %arg1, %[[OFF_B]]
+// CHECK: %[[OFF_K:.*]] = arith.muli %[[C32]], %[[FIRST]] : i32
+// CHECK: %[[K_INIT:.*]] = arith.addi %[[C0:.*]], %[[OFF_K]] : i32
+// CHECK: scf.for %{{.*}} = %[[LB]] to %[[UB]] step %[[C32]] iter_args(%{{.*}} = %{{.*}}, %{{.*}} = %[[B_INIT]], %{{.*}} = %[[K_INIT]])
+// CHECK: "tt.atomic_rmw"
+module {
+tt.func @index_k(%a: tensor<64x64x!tt.ptr<f16>>, %b: tensor<64x64x!tt.ptr<f16>>, %c: tensor<64x64x!tt.ptr<f32>>, %k: i32) {
+  %c0_i32 = arith.constant 0 : i32
+  %c16_i32 = arith.constant 16 : i32
+  %c32_i32 = arith.constant 32 : i32
+  %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+  %b_step = arith.constant dense<2048> : tensor<64x64xi32>
+  %r:3 = scf.for %iv = %c16_i32 to %k step %c32_i32 iter_args(%acc = %cst, %b_ptr = %b, %off = %c0_i32) -> (tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, i32) : i32 {
+    %off_splat = tt.splat %off : (i32) -> tensor<64x64xi32>
+    %a_ptr = tt.addptr %a, %off_splat : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %x = tt.load %a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %y = tt.load %b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %d = tt.dot %x, %y, %acc {allowTF32 = true} : tensor<64x64xf16> * tensor<64x64xf16> -> tensor<64x64xf32>
+    %next_b = tt.addptr %b_ptr, %b_step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %next_off = arith.addi %off, %c32_i32 : i32
+    scf.yield %d, %next_b, %next_off : tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, i32
+  }
+  tt.store %c, %r#0 : tensor<64x64xf32>
+  tt.return
+}
+}
+
+// -----
+
+// Atomics cannot carry the cache modifier of the store: the loop is left alone.
+// CHECK-NOT: triton_gpu.split-k
+// CHECK-LABEL: tt.func @cached_store
+// CHECK-NOT: tt.get_program_id z
+// CHECK: tt.store %arg2, %{{.*}} {cache = 5 : i32, evict = 2 : i32}
+module {
+tt.func @cached_store(%arg0: tensor<64x64x!tt.ptr<f16>>, %arg1: tensor<64x64x!tt.ptr<f16>>, %arg2: tensor<64x64x!tt.ptr<f32>>, %arg3: i32) {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+  %step = arith.constant dense<64> : tensor<64x64xi32>
+  %0 = arith.index_cast %arg3 : i32 to index
+  %1:3 = scf.for %arg4 = %c0 to %0 step %c64 iter_args(%arg5 = %cst, %arg6 = %arg0, %arg7 = %arg1) -> (tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>) {
+    %a = tt.load %arg6 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %b = tt.load %arg7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16>
+    %c = tt.dot %a, %b, %arg5 {allowTF32 = true} : tensor<64x64xf16> * tensor<64x64xf16> -> tensor<64x64xf32>
+    %next_a = tt.addptr %arg6, %step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %next_b = tt.addptr %arg7, %step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    scf.yield %c, %next_a, %next_b : tensor<64x64xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>
+  }
+  tt.store %arg2, %1#0 {cache = 5 : i32, evict = 2 : i32} : tensor<64x64xf32>
+  tt.return
+}
+}